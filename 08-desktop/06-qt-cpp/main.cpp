@@ -14,6 +14,7 @@
 #include <QScreen>
 #include <QDebug>
 #include "src/MainWindow.h"
+#include "src/StartupLog.h"
 
 /**
  * @brief Application entry point
@@ -27,6 +28,9 @@
  */
 int main(int argc, char *argv[])
 {
+    // Startup timings are measured from here
+    StartupLog::start();
+
     // Enable High DPI support for modern displays
     // Note: Qt 6 enables high DPI by default, these attributes are deprecated
     // For Qt 5 compatibility, you can use:
@@ -71,6 +75,7 @@ int main(int argc, char *argv[])
     mainWindow.move(x, y);
 
     mainWindow.show();
+    StartupLog::mark("main window shown");
 
     // Start the event loop
     return app.exec();
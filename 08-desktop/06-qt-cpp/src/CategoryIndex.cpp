@@ -0,0 +1,124 @@
+/**
+ * @file CategoryIndex.cpp
+ * @brief Implementation of CategoryIndex class
+ */
+
+#include "CategoryIndex.h"
+#include <algorithm>
+
+/**
+ * @brief Index every live slot of a store
+ */
+void CategoryIndex::rebuild(const TodoStore& store)
+{
+    m_entries.clear();
+    for (int i = 0; i < store.size(); ++i) {
+        if (store.isLive(i))
+            insert(i, store);
+    }
+}
+
+/**
+ * @brief Add a live slot under its category
+ */
+void CategoryIndex::insert(int slot, const TodoStore& store)
+{
+    const int category = store.categoryIndex(slot);
+    if (category >= m_entries.size())
+        m_entries.resize(category + 1);
+
+    Entry& entry = m_entries[category];
+    if (entry.members.isEmpty() || entry.members.last() < slot) {
+        entry.members.append(slot);
+    } else {
+        // Edited items go back to their place in the list
+        auto it = std::lower_bound(entry.members.begin(), entry.members.end(), slot);
+        if (*it == slot)
+            return;
+        entry.members.insert(it, slot);
+    }
+
+    if (store.isCompleted(slot))
+        ++entry.counts.completed;
+    else
+        ++entry.counts.active;
+}
+
+/**
+ * @brief Remove a slot from its category
+ */
+void CategoryIndex::remove(int slot, const TodoStore& store)
+{
+    const int category = store.categoryIndex(slot);
+    if (category >= m_entries.size())
+        return;
+
+    Entry& entry = m_entries[category];
+    auto it = std::lower_bound(entry.members.begin(), entry.members.end(), slot);
+    if (it == entry.members.end() || *it != slot)
+        return;
+    entry.members.erase(it);
+
+    if (store.isCompleted(slot))
+        --entry.counts.completed;
+    else
+        --entry.counts.active;
+}
+
+/**
+ * @brief Move a slot between its category's active and completed counts
+ */
+void CategoryIndex::completionChanged(int slot, const TodoStore& store)
+{
+    const int category = store.categoryIndex(slot);
+    if (category >= m_entries.size())
+        return;
+
+    Counts& counts = m_entries[category].counts;
+    const int delta = store.isCompleted(slot) ? 1 : -1;
+    counts.completed += delta;
+    counts.active -= delta;
+}
+
+/**
+ * @brief Get the live slots of a category
+ */
+const QVector<int>& CategoryIndex::members(const QString& category, const TodoStore& store) const
+{
+    static const QVector<int> none;
+    const Entry* entry = find(category, store);
+    return entry ? entry->members : none;
+}
+
+/**
+ * @brief Get the item counts of a category
+ */
+CategoryIndex::Counts CategoryIndex::counts(const QString& category, const TodoStore& store) const
+{
+    const Entry* entry = find(category, store);
+    return entry ? entry->counts : Counts();
+}
+
+/**
+ * @brief Get the categories holding at least one live item
+ */
+QStringList CategoryIndex::categories(const TodoStore& store) const
+{
+    QStringList names;
+    for (int i = 0; i < m_entries.size(); ++i) {
+        if (!m_entries[i].members.isEmpty())
+            names.append(store.categoryName(i));
+    }
+    return names;
+}
+
+/**
+ * @brief Get the entry of a category by name
+ */
+const CategoryIndex::Entry* CategoryIndex::find(const QString& category, const TodoStore& store) const
+{
+    const int index = store.findCategory(category);
+    if (index < 0 || index >= m_entries.size())
+        return nullptr;
+    return &m_entries[index];
+}
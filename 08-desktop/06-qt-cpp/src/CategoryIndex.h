@@ -0,0 +1,115 @@
+/**
+ * @file CategoryIndex.h
+ * @brief Inverted index from categories to their items
+ *
+ * This file defines the CategoryIndex class which the model uses to list
+ * the items of a category and count them without scanning the store.
+ */
+
+#ifndef CATEGORYINDEX_H
+#define CATEGORYINDEX_H
+
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include "TodoStore.h"
+
+/**
+ * @class CategoryIndex
+ * @brief Per-category slot lists and completion counts over a TodoStore
+ *
+ * Entries are addressed by the store's category pool index, so the names
+ * are interned once by the store and a lookup by name is one hash probe.
+ * Each entry keeps its live slots in increasing order together with the
+ * number of active and completed items among them, so listing a category
+ * costs O(matches) and reading its counts O(1).
+ *
+ * The index follows one store: callers insert a slot after it gets its
+ * category, remove it before the category changes or the slot is
+ * removed, and report completion changes. rebuild() starts over after
+ * the store was replaced or compacted.
+ */
+class CategoryIndex
+{
+public:
+    /**
+     * @struct Counts
+     * @brief Live items of one category
+     */
+    struct Counts {
+        int active = 0;         ///< Items not completed
+        int completed = 0;      ///< Completed items
+
+        int total() const { return active + completed; }
+    };
+
+    /**
+     * @brief Index every live slot of a store
+     * @param store Store to index
+     */
+    void rebuild(const TodoStore& store);
+
+    /**
+     * @brief Add a live slot under its category
+     * @param slot Slot in the store
+     * @param store Store holding the slot
+     */
+    void insert(int slot, const TodoStore& store);
+
+    /**
+     * @brief Remove a slot from its category
+     * @param slot Slot in the store, still holding its indexed category
+     * @param store Store holding the slot
+     */
+    void remove(int slot, const TodoStore& store);
+
+    /**
+     * @brief Move a slot between its category's active and completed counts
+     * @param slot Slot whose completion status just changed in the store
+     * @param store Store holding the slot
+     */
+    void completionChanged(int slot, const TodoStore& store);
+
+    /**
+     * @brief Get the live slots of a category
+     * @param category Category name
+     * @param store Store the index follows
+     * @return Ascending slots, empty for an unknown category
+     */
+    const QVector<int>& members(const QString& category, const TodoStore& store) const;
+
+    /**
+     * @brief Get the item counts of a category
+     * @param category Category name
+     * @param store Store the index follows
+     * @return Active and completed counts, zero for an unknown category
+     */
+    Counts counts(const QString& category, const TodoStore& store) const;
+
+    /**
+     * @brief Get the categories holding at least one live item
+     * @param store Store the index follows
+     * @return Category names in pool order
+     */
+    QStringList categories(const TodoStore& store) const;
+
+private:
+    /**
+     * @struct Entry
+     * @brief Items of one category
+     */
+    struct Entry {
+        QVector<int> members;   ///< Live slots, ascending
+        Counts counts;          ///< Active and completed counts
+    };
+
+    QVector<Entry> m_entries;   ///< Category pool index -> entry
+
+    /**
+     * @brief Get the entry of a category by name
+     * @return Entry, or nullptr if the category has none
+     */
+    const Entry* find(const QString& category, const TodoStore& store) const;
+};
+
+#endif // CATEGORYINDEX_H
@@ -0,0 +1,190 @@
+/**
+ * @file FenwickTree.cpp
+ * @brief Implementation of FenwickTree class
+ */
+
+#include "FenwickTree.h"
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief Lowest set bit, the span of a tree node
+ */
+int lowBit(int i)
+{
+    return i & -i;
+}
+
+} // namespace
+
+/**
+ * @brief Replace the whole bitmap
+ */
+void FenwickTree::assign(const QVector<bool>& bits)
+{
+    const int n = bits.size();
+    m_bits = bits;
+    m_tree.fill(0, n + 1);
+    m_count = 0;
+
+    // Push each node's sum into its parent once instead of n updates
+    for (int i = 1; i <= n; ++i) {
+        if (bits[i - 1]) {
+            ++m_tree[i];
+            ++m_count;
+        }
+        const int parent = i + lowBit(i);
+        if (parent <= n)
+            m_tree[parent] += m_tree[i];
+    }
+}
+
+/**
+ * @brief Remove every position
+ */
+void FenwickTree::clear()
+{
+    m_tree.clear();
+    m_bits.clear();
+    m_count = 0;
+}
+
+/**
+ * @brief Append a position at the end
+ */
+void FenwickTree::append(bool bit)
+{
+    if (m_tree.isEmpty())
+        m_tree.append(0);
+
+    // The new node covers (i - lowBit(i), i], so it starts from the sum of
+    // the positions it spans that already exist
+    const int i = m_bits.size() + 1;
+    m_tree.append((bit ? 1 : 0) + rank(i - 1) - rank(i - lowBit(i)));
+    m_bits.append(bit);
+    if (bit)
+        ++m_count;
+}
+
+/**
+ * @brief Insert a position, moving the later ones up by one
+ */
+void FenwickTree::insert(int pos, bool bit)
+{
+    if (pos < 0 || pos > m_bits.size())
+        return;
+
+    if (m_tree.isEmpty())
+        m_tree.append(0);
+    m_bits.insert(pos, bit);
+    m_tree.append(0);
+    if (bit)
+        ++m_count;
+    rebuildFrom(pos);
+}
+
+/**
+ * @brief Move the bit at one position to another
+ */
+void FenwickTree::move(int from, int to)
+{
+    const int n = m_bits.size();
+    if (from == to || from < 0 || to < 0 || from >= n || to >= n)
+        return;
+
+    const int lo = qMin(from, to);
+    const int hi = qMax(from, to);
+    QVector<bool> span(m_bits.cbegin() + lo, m_bits.cbegin() + hi + 1);
+    if (from < to)
+        std::rotate(span.begin(), span.begin() + 1, span.end());
+    else
+        std::rotate(span.begin(), span.end() - 1, span.end());
+
+    // Each set() costs O(log n); rebuilding the tail costs O(n - lo)
+    int depth = 1;
+    while ((1 << depth) < n)
+        ++depth;
+    if (static_cast<qint64>(span.size()) * depth < n - lo) {
+        for (int i = 0; i < span.size(); ++i)
+            set(lo + i, span[i]);
+        return;
+    }
+
+    std::copy(span.cbegin(), span.cend(), m_bits.begin() + lo);
+    rebuildFrom(lo);
+}
+
+/**
+ * @brief Change the bit at a position
+ */
+void FenwickTree::set(int pos, bool bit)
+{
+    if (pos < 0 || pos >= m_bits.size() || m_bits[pos] == bit)
+        return;
+
+    m_bits[pos] = bit;
+    const int delta = bit ? 1 : -1;
+    m_count += delta;
+    for (int i = pos + 1; i < m_tree.size(); i += lowBit(i))
+        m_tree[i] += delta;
+}
+
+/**
+ * @brief Count the set bits before a position
+ */
+int FenwickTree::rank(int pos) const
+{
+    int sum = 0;
+    for (int i = qMin(pos, static_cast<int>(m_bits.size())); i > 0; i -= lowBit(i))
+        sum += m_tree[i];
+    return sum;
+}
+
+/**
+ * @brief Find the position of a set bit by its rank
+ */
+int FenwickTree::select(int n) const
+{
+    if (n < 0 || n >= m_count)
+        return -1;
+
+    const int size = m_bits.size();
+    int step = 1;
+    while (step * 2 <= size)
+        step *= 2;
+
+    // Descend from the largest node, skipping every node whose sum still
+    // fits below the wanted bit
+    int pos = 0;
+    int remaining = n + 1;
+    for (; step > 0; step /= 2) {
+        if (pos + step <= size && m_tree[pos + step] < remaining) {
+            pos += step;
+            remaining -= m_tree[pos];
+        }
+    }
+    return pos;
+}
+
+/**
+ * @brief Recompute the tree nodes covering positions from pos on
+ */
+void FenwickTree::rebuildFrom(int pos)
+{
+    const int n = m_bits.size();
+
+    // prefix[k] holds the number of set bits before position pos + k
+    QVector<int> prefix(n - pos + 1);
+    prefix[0] = rank(pos);
+    for (int k = pos; k < n; ++k)
+        prefix[k - pos + 1] = prefix[k - pos] + (m_bits[k] ? 1 : 0);
+
+    // Node i spans (i - lowBit(i), i]; the few that start before pos take
+    // their lower sum from the nodes that are still valid
+    for (int i = pos + 1; i <= n; ++i) {
+        const int start = i - lowBit(i);
+        const int before = start >= pos ? prefix[start - pos] : rank(start);
+        m_tree[i] = prefix[i - pos] - before;
+    }
+}
@@ -0,0 +1,116 @@
+/**
+ * @file FenwickTree.h
+ * @brief Bitmap with logarithmic rank and select queries
+ *
+ * This file defines the FenwickTree class which the model uses to map
+ * between view rows and item slots without rewriting an index list.
+ */
+
+#ifndef FENWICKTREE_H
+#define FENWICKTREE_H
+
+#include <QVector>
+
+/**
+ * @class FenwickTree
+ * @brief Binary indexed tree over a bitmap
+ *
+ * Each position holds one bit. Flipping a bit, appending one, counting
+ * the set bits before a position (rank) and finding the position of the
+ * n-th set bit (select) all take O(log n).
+ */
+class FenwickTree
+{
+public:
+    /**
+     * @brief Replace the whole bitmap, built in O(n)
+     * @param bits New bit values
+     */
+    void assign(const QVector<bool>& bits);
+
+    /**
+     * @brief Remove every position
+     */
+    void clear();
+
+    /**
+     * @brief Append a position at the end
+     * @param bit Value of the new position
+     */
+    void append(bool bit);
+
+    /**
+     * @brief Insert a position, moving the later ones up by one
+     *
+     * Only the tree nodes from @p pos on are rebuilt, in O(size - pos).
+     *
+     * @param pos Position of the new bit, 0-based, at most size()
+     * @param bit Value of the new position
+     */
+    void insert(int pos, bool bit);
+
+    /**
+     * @brief Move the bit at one position to another
+     *
+     * The positions in between shift by one towards @p from. A short move
+     * updates the tree bit by bit; a long one rebuilds the nodes behind
+     * the lower end.
+     *
+     * @param from Current position, 0-based
+     * @param to New position, 0-based
+     */
+    void move(int from, int to);
+
+    /**
+     * @brief Change the bit at a position
+     * @param pos Position, 0-based
+     * @param bit New value
+     */
+    void set(int pos, bool bit);
+
+    /**
+     * @brief Get the bit at a position
+     * @param pos Position, 0-based
+     * @return Bit value, false when out of range
+     */
+    bool test(int pos) const { return pos >= 0 && pos < m_bits.size() && m_bits[pos]; }
+
+    /**
+     * @brief Get the number of positions
+     * @return Size of the bitmap
+     */
+    int size() const { return m_bits.size(); }
+
+    /**
+     * @brief Get the number of set bits
+     * @return Population count
+     */
+    int count() const { return m_count; }
+
+    /**
+     * @brief Count the set bits before a position
+     * @param pos Position, 0-based
+     * @return Number of set bits in [0, pos)
+     */
+    int rank(int pos) const;
+
+    /**
+     * @brief Find the position of a set bit by its rank
+     * @param n Rank of the bit, 0-based
+     * @return Position of the n-th set bit, or -1 if there are fewer bits
+     */
+    int select(int n) const;
+
+private:
+    /**
+     * @brief Recompute the tree nodes covering positions from @p pos on
+     * @param pos First position whose bit changed; nodes before it must be valid
+     */
+    void rebuildFrom(int pos);
+
+    QVector<int> m_tree;    ///< 1-based partial sums
+    QVector<bool> m_bits;   ///< Bit values
+    int m_count = 0;        ///< Number of set bits
+};
+
+#endif // FENWICKTREE_H
@@ -5,17 +5,53 @@
 
 #include "MainWindow.h"
 #include "StorageManager.h"
+#include "TodoImporter.h"
+#include "TodoExporter.h"
+#include "StartupLog.h"
+#include "TodoItemDelegate.h"
+#include "StatisticsWidget.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGroupBox>
 #include <QMessageBox>
 #include <QInputDialog>
 #include <QFileDialog>
+#include <QFileInfo>
+#include <QProgressDialog>
 #include <QCloseEvent>
 #include <QSettings>
 #include <QScreen>
+#include <QSignalBlocker>
 #include <QApplication>
 #include <QDebug>
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief Sort keys behind each entry of the sort combo box
+ */
+QVector<TodoSorter::Column> sortPreset(int preset)
+{
+    using Key = TodoSorter::Key;
+    switch (preset) {
+        case 1:
+            return {{Key::Priority, Qt::DescendingOrder}, {Key::CreatedAt, Qt::AscendingOrder}};
+        case 2:
+            return {{Key::CreatedAt, Qt::DescendingOrder}};
+        case 3:
+            return {{Key::ModifiedAt, Qt::DescendingOrder}};
+        case 4:
+            return {{Key::Title, Qt::AscendingOrder}};
+        case 5:
+            return {{Key::Completed, Qt::AscendingOrder}, {Key::Priority, Qt::DescendingOrder},
+                    {Key::Title, Qt::AscendingOrder}};
+        default:
+            return {};
+    }
+}
+
+} // namespace
 
 /**
  * @brief Constructor implementation
@@ -30,9 +66,15 @@ MainWindow::MainWindow(QWidget *parent)
     , m_filterAllRadio(nullptr)
     , m_filterActiveRadio(nullptr)
     , m_filterCompletedRadio(nullptr)
+    , m_searchEdit(nullptr)
+    , m_categoryList(nullptr)
+    , m_categoryDock(nullptr)
+    , m_statisticsWidget(nullptr)
+    , m_statisticsDock(nullptr)
+    , m_sortCombo(nullptr)
     , m_priorityCombo(nullptr)
     , m_statsLabel(nullptr)
-    , m_model(std::make_unique<TodoModel>(this))
+    , m_model(std::make_unique<TodoModel>(StorageManager::StorageBackend::Sharded, this))
     , m_isDarkTheme(false)
 {
     setWindowTitle(tr("Qt Todo List - MVVM Architecture"));
@@ -52,6 +94,18 @@ MainWindow::MainWindow(QWidget *parent)
 
     // Initial statistics update
     updateStatistics();
+
+    // Read the saved list in the background; rows arrive in chunks after
+    // the window is up. A restored category filter limits the read to
+    // that category's shard.
+    m_model->setCategoryFilter(QSettings().value("MainWindow/categoryFilter").toString());
+    refreshCategories();
+    statusBar()->showMessage(tr("Loading todos..."));
+    m_model->loadFromStorageAsync();
+
+    // Other windows on the same storage merge their saves into this one
+    m_model->setLiveSync(true);
+    StartupLog::mark("main window constructed");
 }
 
 /**
@@ -109,6 +163,22 @@ void MainWindow::setupUI()
     filterLayout->addWidget(m_filterCompletedRadio);
     filterLayout->addStretch();
 
+    m_searchEdit = new QLineEdit(this);
+    m_searchEdit->setPlaceholderText(tr("Search todos..."));
+    m_searchEdit->setClearButtonEnabled(true);
+    m_searchEdit->setMinimumWidth(200);
+    filterLayout->addWidget(m_searchEdit);
+
+    m_sortCombo = new QComboBox(this);
+    m_sortCombo->addItem(tr("Order added"));
+    m_sortCombo->addItem(tr("Priority"));
+    m_sortCombo->addItem(tr("Newest first"));
+    m_sortCombo->addItem(tr("Recently modified"));
+    m_sortCombo->addItem(tr("Title"));
+    m_sortCombo->addItem(tr("Active first"));
+    m_sortCombo->setToolTip(tr("Sort order"));
+    filterLayout->addWidget(m_sortCombo);
+
     mainLayout->addWidget(filterGroup);
 
     // === Todo List View ===
@@ -118,6 +188,11 @@ void MainWindow::setupUI()
     m_listView->setEditTriggers(QAbstractItemView::NoEditTriggers);
     m_listView->setAlternatingRowColors(true);
     m_listView->setContextMenuPolicy(Qt::CustomContextMenu);
+    // Rows all have the delegate's height, so the view can lay out a
+    // million of them without asking for each size
+    m_listView->setItemDelegate(new TodoItemDelegate(m_model.get(), m_listView));
+    m_listView->setUniformItemSizes(true);
+    m_listView->setLayoutMode(QListView::Batched);
     mainLayout->addWidget(m_listView, 1); // Give it stretch factor of 1
 
     // === Action Buttons ===
@@ -134,6 +209,28 @@ void MainWindow::setupUI()
     mainLayout->addLayout(actionLayout);
 
     setCentralWidget(centralWidget);
+
+    // === Category Sidebar ===
+    m_categoryList = new QListWidget(this);
+    m_categoryList->setToolTip(tr("Show one category"));
+
+    m_categoryDock = new QDockWidget(tr("Categories"), this);
+    m_categoryDock->setObjectName("categoryDock");
+    m_categoryDock->setFeatures(QDockWidget::DockWidgetMovable | QDockWidget::DockWidgetClosable);
+    m_categoryDock->setWidget(m_categoryList);
+    addDockWidget(Qt::LeftDockWidgetArea, m_categoryDock);
+
+    // === Statistics Dashboard ===
+    // Hidden until opened from the View menu; a restored state may show it
+    m_statisticsWidget = new StatisticsWidget(m_model.get(), this);
+
+    m_statisticsDock = new QDockWidget(tr("Dashboard"), this);
+    m_statisticsDock->setObjectName("dashboardDock");
+    m_statisticsDock->setFeatures(QDockWidget::DockWidgetMovable | QDockWidget::DockWidgetClosable
+                                  | QDockWidget::DockWidgetFloatable);
+    m_statisticsDock->setWidget(m_statisticsWidget);
+    addDockWidget(Qt::RightDockWidgetArea, m_statisticsDock);
+    m_statisticsDock->hide();
 }
 
 /**
@@ -164,7 +261,7 @@ void MainWindow::createActions()
 
     m_exportAction = new QAction(tr("E&xport..."), this);
     m_exportAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_E));
-    m_exportAction->setStatusTip(tr("Export todos to JSON file"));
+    m_exportAction->setStatusTip(tr("Export todos to a JSON, NDJSON or CSV file"));
 
     m_importAction = new QAction(tr("&Import..."), this);
     m_importAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_I));
@@ -174,6 +271,17 @@ void MainWindow::createActions()
     m_quitAction->setShortcut(QKeySequence::Quit);
     m_quitAction->setStatusTip(tr("Quit the application"));
 
+    // Edit menu actions
+    m_undoAction = new QAction(tr("&Undo"), this);
+    m_undoAction->setShortcut(QKeySequence::Undo);
+    m_undoAction->setStatusTip(tr("Undo the last change"));
+    m_undoAction->setEnabled(false);
+
+    m_redoAction = new QAction(tr("&Redo"), this);
+    m_redoAction->setShortcut(QKeySequence::Redo);
+    m_redoAction->setStatusTip(tr("Redo the last undone change"));
+    m_redoAction->setEnabled(false);
+
     // View menu actions
     m_filterAllAction = new QAction(tr("Show &All"), this);
     m_filterAllAction->setShortcut(Qt::Key_F1);
@@ -188,6 +296,10 @@ void MainWindow::createActions()
     m_filterCompletedAction->setShortcut(Qt::Key_F3);
     m_filterCompletedAction->setCheckable(true);
 
+    m_findAction = new QAction(tr("&Find..."), this);
+    m_findAction->setShortcut(QKeySequence::Find);
+    m_findAction->setStatusTip(tr("Search todo titles and categories"));
+
     m_toggleThemeAction = new QAction(tr("Toggle &Theme"), this);
     m_toggleThemeAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_T));
     m_toggleThemeAction->setStatusTip(tr("Toggle between light and dark theme"));
@@ -220,12 +332,21 @@ void MainWindow::createMenuBar()
     fileMenu->addSeparator();
     fileMenu->addAction(m_quitAction);
 
+    // Edit menu
+    QMenu *editMenu = menuBar->addMenu(tr("&Edit"));
+    editMenu->addAction(m_undoAction);
+    editMenu->addAction(m_redoAction);
+
     // View menu
     QMenu *viewMenu = menuBar->addMenu(tr("&View"));
     viewMenu->addAction(m_filterAllAction);
     viewMenu->addAction(m_filterActiveAction);
     viewMenu->addAction(m_filterCompletedAction);
     viewMenu->addSeparator();
+    viewMenu->addAction(m_findAction);
+    viewMenu->addAction(m_categoryDock->toggleViewAction());
+    viewMenu->addAction(m_statisticsDock->toggleViewAction());
+    viewMenu->addSeparator();
     viewMenu->addAction(m_toggleThemeAction);
 
     // Help menu
@@ -240,12 +361,16 @@ void MainWindow::createMenuBar()
 void MainWindow::createToolBar()
 {
     QToolBar *toolBar = addToolBar(tr("Main Toolbar"));
+    toolBar->setObjectName("mainToolBar");
     toolBar->setMovable(false);
 
     toolBar->addAction(m_newTodoAction);
     toolBar->addAction(m_editTodoAction);
     toolBar->addAction(m_removeTodoAction);
     toolBar->addSeparator();
+    toolBar->addAction(m_undoAction);
+    toolBar->addAction(m_redoAction);
+    toolBar->addSeparator();
     toolBar->addAction(m_toggleTodoAction);
     toolBar->addSeparator();
     toolBar->addAction(m_clearCompletedAction);
@@ -280,6 +405,9 @@ void MainWindow::connectSignals()
     connect(m_filterAllRadio, &QRadioButton::clicked, this, &MainWindow::onFilterAll);
     connect(m_filterActiveRadio, &QRadioButton::clicked, this, &MainWindow::onFilterActive);
     connect(m_filterCompletedRadio, &QRadioButton::clicked, this, &MainWindow::onFilterCompleted);
+    connect(m_categoryList, &QListWidget::currentRowChanged, this, &MainWindow::onCategoryChanged);
+    connect(m_searchEdit, &QLineEdit::textChanged, this, &MainWindow::onSearchTextChanged);
+    connect(m_sortCombo, &QComboBox::currentIndexChanged, this, &MainWindow::onSortChanged);
 
     // Actions
     connect(m_newTodoAction, &QAction::triggered, this, &MainWindow::onAddTodo);
@@ -290,10 +418,16 @@ void MainWindow::connectSignals()
     connect(m_exportAction, &QAction::triggered, this, &MainWindow::onExport);
     connect(m_importAction, &QAction::triggered, this, &MainWindow::onImport);
     connect(m_quitAction, &QAction::triggered, this, &QMainWindow::close);
+    connect(m_undoAction, &QAction::triggered, m_model.get(), &TodoModel::undo);
+    connect(m_redoAction, &QAction::triggered, m_model.get(), &TodoModel::redo);
 
     connect(m_filterAllAction, &QAction::triggered, this, &MainWindow::onFilterAll);
     connect(m_filterActiveAction, &QAction::triggered, this, &MainWindow::onFilterActive);
     connect(m_filterCompletedAction, &QAction::triggered, this, &MainWindow::onFilterCompleted);
+    connect(m_findAction, &QAction::triggered, this, [this]() {
+        m_searchEdit->setFocus();
+        m_searchEdit->selectAll();
+    });
 
     connect(m_toggleThemeAction, &QAction::triggered, this, &MainWindow::onToggleTheme);
     connect(m_aboutAction, &QAction::triggered, this, &MainWindow::onAbout);
@@ -305,8 +439,13 @@ void MainWindow::connectSignals()
 
     // Model signals
     connect(m_model.get(), &TodoModel::countsChanged, this, &MainWindow::onCountsChanged);
+    connect(m_model.get(), &TodoModel::undoStackChanged, this, &MainWindow::onUndoStackChanged);
     connect(m_model.get(), &TodoModel::todoAdded, this, &MainWindow::onTodoAdded);
     connect(m_model.get(), &TodoModel::todoRemoved, this, &MainWindow::onTodoRemoved);
+    connect(m_model.get(), &TodoModel::saveFinished, this, &MainWindow::onSaveFinished);
+    connect(m_model.get(), &TodoModel::loadProgress, this, &MainWindow::onLoadProgress);
+    connect(m_model.get(), &TodoModel::loadFinished, this, &MainWindow::onLoadFinished);
+    connect(m_model.get(), &TodoModel::externalChangesMerged, this, &MainWindow::onExternalChangesMerged);
 }
 
 /**
@@ -324,7 +463,12 @@ void MainWindow::onAddTodo()
     int priorityIndex = m_priorityCombo->currentData().toInt();
     auto priority = static_cast<TodoItem::Priority>(priorityIndex);
 
-    if (m_model->addTodo(title, priority)) {
+    // New todos join the category being shown so they stay visible
+    TodoItem item(title, false, priority);
+    if (!m_model->categoryFilter().isNull())
+        item.setCategory(m_model->categoryFilter());
+
+    if (m_model->addTodo(item)) {
         m_inputEdit->clear();
         m_inputEdit->setFocus();
         statusBar()->showMessage(tr("Todo added successfully"), 2000);
@@ -344,9 +488,10 @@ void MainWindow::onRemoveTodo()
         return;
     }
 
+    // Hold on to the id: rows may shift while the dialog is open
     TodoItem item = m_model->getTodoItem(index);
     if (askConfirmation(tr("Are you sure you want to remove '%1'?").arg(item.getTitle()))) {
-        if (m_model->removeTodo(index)) {
+        if (m_model->removeTodoById(item.getUuid())) {
             statusBar()->showMessage(tr("Todo removed successfully"), 2000);
         } else {
             showError(tr("Failed to remove todo"));
@@ -395,8 +540,8 @@ void MainWindow::onEditTodo()
         &ok
     );
 
-    if (ok && !newTitle.trimmed().isEmpty()) {
-        if (m_model->updateTodoTitle(index, newTitle.trimmed())) {
+    if (ok && !newTitle.trimmed().isEmpty() && newTitle.trimmed() != item.getTitle()) {
+        if (m_model->updateTodoTitleById(item.getUuid(), newTitle.trimmed())) {
             statusBar()->showMessage(tr("Todo updated successfully"), 2000);
         } else {
             showError(tr("Failed to update todo"));
@@ -482,31 +627,37 @@ void MainWindow::onExport()
         this,
         tr("Export Todos"),
         QDir::homePath() + "/todos_export.json",
-        tr("JSON Files (*.json)")
+        tr("JSON Files (*.json);;NDJSON Files (*.ndjson *.jsonl);;CSV Files (*.csv)")
     );
 
     if (filePath.isEmpty())
         return;
 
-    // Save current filter mode and switch to All to get all todos
-    auto oldFilter = m_model->getFilterMode();
-    m_model->setFilterMode(TodoModel::FilterMode::All);
-
-    QVector<TodoItem> allTodos;
-    for (int i = 0; i < m_model->rowCount(); ++i) {
-        allTodos.append(m_model->getTodoItem(i));
-    }
-
-    // Restore original filter mode
-    m_model->setFilterMode(oldFilter);
+    // The snapshot shares the model's columns, so neither the filter nor
+    // the view is touched; encoding and writing run in the background
+    auto *exporter = new TodoExporter(this);
+    m_exportAction->setEnabled(false);
+
+    connect(exporter, &TodoExporter::progressChanged, this, [this](int done, int total) {
+        if (total > 0)
+            statusBar()->showMessage(tr("Exporting... %1%").arg(100LL * done / total));
+    });
+    connect(exporter, &TodoExporter::finished, this,
+            [this, exporter, filePath](TodoExporter::Status status, int count) {
+        exporter->deleteLater();
+        m_exportAction->setEnabled(true);
+        statusBar()->clearMessage();
+
+        if (status == TodoExporter::Status::Finished) {
+            showInfo(tr("Successfully exported %1 todo(s) to:\n%2")
+                     .arg(count)
+                     .arg(filePath));
+        } else {
+            showError(tr("Failed to export todos:\n%1").arg(exporter->errorString()));
+        }
+    });
 
-    if (StorageManager::exportToJson(filePath, allTodos)) {
-        showInfo(tr("Successfully exported %1 todo(s) to:\n%2")
-                 .arg(allTodos.size())
-                 .arg(filePath));
-    } else {
-        showError(tr("Failed to export todos"));
-    }
+    exporter->start(filePath, m_model->snapshot(), TodoExporter::formatForPath(filePath));
 }
 
 /**
@@ -524,23 +675,56 @@ void MainWindow::onImport()
     if (filePath.isEmpty())
         return;
 
-    QVector<TodoItem> importedTodos = StorageManager::importFromJson(filePath);
-
-    if (importedTodos.isEmpty()) {
-        showError(tr("No todos found in the file or import failed"));
+    if (!askConfirmation(tr("Import todos from %1? They will be added to your existing todos.")
+                         .arg(QFileInfo(filePath).fileName()))) {
         return;
     }
 
-    if (askConfirmation(tr("Import %1 todo(s)? This will add them to your existing todos.")
-                        .arg(importedTodos.size()))) {
-        int added = 0;
-        for (const auto& todo : importedTodos) {
-            if (m_model->addTodo(todo)) {
-                added++;
-            }
+    // The file is decoded on a worker thread and arrives in batches, so
+    // the window stays responsive and memory does not grow with the file
+    auto *importer = new TodoImporter(this);
+    auto *progress = new QProgressDialog(tr("Importing todos..."), tr("Cancel"), 0, 1000, this);
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setMinimumDuration(500);
+    progress->setAutoClose(false);
+    progress->setAutoReset(false);
+    m_importAction->setEnabled(false);
+
+    // Every batch lands in one undo step
+    m_model->beginUndoGroup(tr("Import"));
+
+    connect(importer, &TodoImporter::batchReady, this, [this](const QVector<TodoItem>& batch) {
+        m_model->addTodos(QVector<TodoItem>(batch));
+    });
+    connect(importer, &TodoImporter::progressChanged, progress, [progress](qint64 bytesRead, qint64 bytesTotal) {
+        if (bytesTotal > 0)
+            progress->setValue(static_cast<int>(bytesRead * progress->maximum() / bytesTotal));
+    });
+    connect(progress, &QProgressDialog::canceled, importer, &TodoImporter::cancel);
+    connect(importer, &TodoImporter::finished, this,
+            [this, importer, progress](TodoImporter::Status status, int count) {
+        progress->deleteLater();
+        importer->deleteLater();
+        m_importAction->setEnabled(true);
+        m_model->endUndoGroup();
+
+        switch (status) {
+            case TodoImporter::Status::Finished:
+                if (count == 0)
+                    showError(tr("No todos found in the file"));
+                else
+                    showInfo(tr("Successfully imported %1 todo(s)").arg(count));
+                break;
+            case TodoImporter::Status::Cancelled:
+                statusBar()->showMessage(tr("Import cancelled after %1 todo(s)").arg(count), 3000);
+                break;
+            case TodoImporter::Status::Failed:
+                showError(tr("Import failed after %1 todo(s):\n%2").arg(count).arg(importer->errorString()));
+                break;
         }
-        showInfo(tr("Successfully imported %1 todo(s)").arg(added));
-    }
+    });
+
+    importer->start(filePath);
 }
 
 /**
@@ -581,6 +765,21 @@ void MainWindow::onAboutQt()
 void MainWindow::onCountsChanged()
 {
     updateStatistics();
+    refreshCategories();
+    m_statisticsWidget->refresh();
+}
+
+/**
+ * @brief Show what undo and redo would do in their actions
+ */
+void MainWindow::onUndoStackChanged()
+{
+    const QString undoText = m_model->undoText();
+    const QString redoText = m_model->redoText();
+    m_undoAction->setEnabled(m_model->canUndo());
+    m_redoAction->setEnabled(m_model->canRedo());
+    m_undoAction->setText(undoText.isEmpty() ? tr("&Undo") : tr("&Undo %1").arg(undoText));
+    m_redoAction->setText(redoText.isEmpty() ? tr("&Redo") : tr("&Redo %1").arg(redoText));
 }
 
 /**
@@ -601,6 +800,141 @@ void MainWindow::onTodoRemoved(const QString& id)
     // Additional handling if needed
 }
 
+/**
+ * @brief Handle background save result
+ */
+void MainWindow::onSaveFinished(bool success)
+{
+    if (!success) {
+        statusBar()->showMessage(tr("Failed to save todos, will retry on next change"), 5000);
+        return;
+    }
+
+    refreshCategories();
+}
+
+/**
+ * @brief Filter the list as the search text is typed
+ */
+void MainWindow::onSearchTextChanged(const QString& text)
+{
+    m_model->setSearchText(text);
+
+    if (m_model->searchText().isEmpty())
+        statusBar()->clearMessage();
+    else
+        statusBar()->showMessage(tr("%n match(es)", "", m_model->searchMatchCount()));
+}
+
+/**
+ * @brief Apply the sort order picked in the combo box
+ */
+void MainWindow::onSortChanged(int index)
+{
+    m_model->setSortColumns(sortPreset(index));
+}
+
+/**
+ * @brief Handle category selection
+ */
+void MainWindow::onCategoryChanged(int row)
+{
+    if (row < 0)
+        return;
+
+    // Row 0 is "All categories", which carries a null string
+    m_model->setCategoryFilter(m_categoryList->item(row)->data(Qt::UserRole).toString());
+    refreshCategories();
+}
+
+/**
+ * @brief Update the category sidebar from the model's summaries
+ *
+ * Runs after every edit: the model keeps the counts per category, so
+ * this costs O(categories). Existing rows are relabeled in place so the
+ * selection and scroll position stay put.
+ */
+void MainWindow::refreshCategories()
+{
+    const QString current = m_model->categoryFilter();
+    QVector<StorageManager::CategorySummary> summaries = m_model->categorySummaries();
+
+    // Keep a category that is empty right now selectable while it is shown
+    const bool currentListed = current.isNull()
+        || std::any_of(summaries.cbegin(), summaries.cend(),
+                       [&current](const StorageManager::CategorySummary& summary) {
+                           return summary.category == current;
+                       });
+    if (!currentListed)
+        summaries.append({current, 0, 0});
+
+    // A null name stands for "All categories", so uncategorized items
+    // need a non-null empty one
+    StorageManager::CategorySummary all;
+    for (StorageManager::CategorySummary& summary : summaries) {
+        if (summary.category.isNull())
+            summary.category = QStringLiteral("");
+        all.count += summary.count;
+        all.completed += summary.completed;
+    }
+    summaries.prepend(all);
+
+    QSignalBlocker blocker(m_categoryList);
+    while (m_categoryList->count() > summaries.size())
+        delete m_categoryList->takeItem(m_categoryList->count() - 1);
+    while (m_categoryList->count() < summaries.size())
+        m_categoryList->addItem(new QListWidgetItem());
+
+    for (int row = 0; row < summaries.size(); ++row) {
+        const StorageManager::CategorySummary& summary = summaries[row];
+        QString name = summary.category.isEmpty() ? tr("(none)") : summary.category;
+        if (row == 0)
+            name = tr("All categories");
+
+        QListWidgetItem *item = m_categoryList->item(row);
+        item->setText(tr("%1\n%2 active, %3 done")
+                      .arg(name)
+                      .arg(summary.count - summary.completed)
+                      .arg(summary.completed));
+        item->setData(Qt::UserRole, summary.category);
+
+        if (summary.category == current && summary.category.isNull() == current.isNull())
+            m_categoryList->setCurrentRow(row);
+    }
+}
+
+/**
+ * @brief Show loading progress
+ */
+void MainWindow::onLoadProgress(int done, int total)
+{
+    if (total > 0)
+        statusBar()->showMessage(tr("Loading todos... %1%").arg(100LL * done / total));
+}
+
+/**
+ * @brief Report the end of loading
+ */
+void MainWindow::onLoadFinished(int count)
+{
+    statusBar()->showMessage(tr("Loaded %1 todo(s)").arg(count), 2000);
+    refreshCategories();
+
+    if (!m_startupLoadLogged) {
+        m_startupLoadLogged = true;
+        StartupLog::mark(QStringLiteral("fully loaded (%1 todos)").arg(count));
+    }
+}
+
+/**
+ * @brief Report changes saved by another instance
+ */
+void MainWindow::onExternalChangesMerged(int count)
+{
+    statusBar()->showMessage(tr("Merged %n change(s) from another window", nullptr, count), 2000);
+    refreshCategories();
+}
+
 /**
  * @brief Handle list view double click
  */
@@ -903,8 +1237,14 @@ void MainWindow::loadSettings()
         restoreGeometry(settings.value("MainWindow/geometry").toByteArray());
     }
 
+    // Load dock placement
+    restoreState(settings.value("MainWindow/state").toByteArray());
+
     // Load theme preference
     m_isDarkTheme = settings.value("MainWindow/darkTheme", false).toBool();
+
+    // Sorting before the list arrives saves a re-sort of every item
+    m_sortCombo->setCurrentIndex(settings.value("MainWindow/sortPreset", 0).toInt());
 }
 
 /**
@@ -917,9 +1257,23 @@ void MainWindow::saveSettings()
     // Save window geometry
     settings.setValue("MainWindow/geometry", saveGeometry());
 
+    // Save dock placement
+    settings.setValue("MainWindow/state", saveState());
+
     // Save theme preference
     settings.setValue("MainWindow/darkTheme", m_isDarkTheme);
 
+    // Save sort order
+    settings.setValue("MainWindow/sortPreset", m_sortCombo->currentIndex());
+
+    // Save the category shown, which also decides what the next start reads.
+    // "All categories" is stored as a missing key: a null string would
+    // read back as the empty (uncategorized) category.
+    if (m_model->categoryFilter().isNull())
+        settings.remove("MainWindow/categoryFilter");
+    else
+        settings.setValue("MainWindow/categoryFilter", m_model->categoryFilter());
+
     settings.sync();
 }
 
@@ -928,10 +1282,32 @@ void MainWindow::saveSettings()
  */
 void MainWindow::closeEvent(QCloseEvent *event)
 {
+    // Write any debounced edits before the window goes away
+    if (!m_model->saveToStorage()) {
+        qWarning() << "Failed to save todos on close";
+    }
+
     saveSettings();
     event->accept();
 }
 
+/**
+ * @brief Handle window events
+ *
+ * The window paints its whole backing store while handling an update
+ * request, so the first frame is on screen once that event returns.
+ */
+bool MainWindow::event(QEvent *event)
+{
+    const bool handled = QMainWindow::event(event);
+
+    if (!m_firstPaintLogged && event->type() == QEvent::UpdateRequest) {
+        m_firstPaintLogged = true;
+        StartupLog::mark(QStringLiteral("first paint (%1 rows)").arg(m_model->rowCount()));
+    }
+    return handled;
+}
+
 /**
  * @brief Get selected index
  */
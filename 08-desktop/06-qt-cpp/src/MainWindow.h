@@ -16,6 +16,8 @@
 #include <QRadioButton>
 #include <QLabel>
 #include <QComboBox>
+#include <QListWidget>
+#include <QDockWidget>
 #include <QAction>
 #include <QMenu>
 #include <QMenuBar>
@@ -24,6 +26,8 @@
 #include <memory>
 #include "TodoModel.h"
 
+class StatisticsWidget;
+
 /**
  * @class MainWindow
  * @brief Main application window for the Todo List
@@ -33,6 +37,7 @@
  * - Todo list display (QListView)
  * - Add/Edit/Delete operations
  * - Filter controls (All/Active/Completed)
+ * - Category sidebar with live counts
  * - Theme switching (Light/Dark)
  * - Keyboard shortcuts
  * - Menu bar and toolbar
@@ -61,6 +66,13 @@ protected:
      */
     void closeEvent(QCloseEvent *event) override;
 
+    /**
+     * @brief Log the first painted frame to the startup timing log
+     * @param event Event to handle
+     * @return true if the event was handled
+     */
+    bool event(QEvent *event) override;
+
 private slots:
     // Todo operations
     void onAddTodo();
@@ -69,10 +81,16 @@ private slots:
     void onEditTodo();
     void onClearCompleted();
 
+    // Undo operations
+    void onUndoStackChanged();
+
     // Filter operations
     void onFilterAll();
     void onFilterActive();
     void onFilterCompleted();
+    void onCategoryChanged(int row);
+    void onSearchTextChanged(const QString& text);
+    void onSortChanged(int index);
 
     // Theme operations
     void onToggleTheme();
@@ -89,6 +107,10 @@ private slots:
     void onCountsChanged();
     void onTodoAdded(const TodoItem& item);
     void onTodoRemoved(const QString& id);
+    void onSaveFinished(bool success);
+    void onLoadProgress(int done, int total);
+    void onLoadFinished(int count);
+    void onExternalChangesMerged(int count);
 
     // List view handlers
     void onListViewDoubleClicked(const QModelIndex& index);
@@ -106,6 +128,12 @@ private:
     QRadioButton *m_filterActiveRadio;
     QRadioButton *m_filterCompletedRadio;
 
+    QLineEdit *m_searchEdit;
+    QListWidget *m_categoryList;
+    QDockWidget *m_categoryDock;
+    StatisticsWidget *m_statisticsWidget;
+    QDockWidget *m_statisticsDock;
+    QComboBox *m_sortCombo;
     QComboBox *m_priorityCombo;
     QLabel *m_statsLabel;
 
@@ -119,9 +147,13 @@ private:
     QAction *m_importAction;
     QAction *m_quitAction;
 
+    QAction *m_undoAction;
+    QAction *m_redoAction;
+
     QAction *m_filterAllAction;
     QAction *m_filterActiveAction;
     QAction *m_filterCompletedAction;
+    QAction *m_findAction;
 
     QAction *m_toggleThemeAction;
     QAction *m_aboutAction;
@@ -132,6 +164,8 @@ private:
 
     // State
     bool m_isDarkTheme;
+    bool m_firstPaintLogged = false;
+    bool m_startupLoadLogged = false;
 
     /**
      * @brief Initialize UI components
@@ -186,6 +220,11 @@ private:
      */
     void updateStatistics();
 
+    /**
+     * @brief Update the category sidebar with per-category counts
+     */
+    void refreshCategories();
+
     /**
      * @brief Load window state from settings
      */
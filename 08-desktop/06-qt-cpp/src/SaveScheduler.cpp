@@ -0,0 +1,329 @@
+/**
+ * @file SaveScheduler.cpp
+ * @brief Implementation of SaveScheduler class
+ */
+
+#include "SaveScheduler.h"
+#include "StorageManager.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+namespace {
+
+/// Default coalescing window for bursts of edits
+constexpr int kDefaultSaveDelayMs = 300;
+
+/// Delay before retrying the first failed write, doubled on each failure
+constexpr int kFirstRetryDelayMs = 1000;
+
+/// Longest delay between retries of a failing write
+constexpr int kMaxRetryDelayMs = 60000;
+
+/// Delay between a watched file changing and reading it; a save by
+/// another process touches several files
+constexpr int kPollDelayMs = 50;
+
+} // namespace
+
+/**
+ * @brief Constructor implementation
+ */
+SaveScheduler::SaveScheduler(StorageManager* storage, SnapshotProvider snapshot, QObject *parent)
+    : QObject(parent)
+    , m_storage(storage)
+    , m_snapshot(std::move(snapshot))
+{
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(kDefaultSaveDelayMs);
+    connect(&m_timer, &QTimer::timeout, this, &SaveScheduler::submit);
+
+    m_retryTimer.setSingleShot(true);
+    connect(&m_retryTimer, &QTimer::timeout, this, &SaveScheduler::submit);
+
+    m_pollTimer.setSingleShot(true);
+    m_pollTimer.setInterval(kPollDelayMs);
+    connect(&m_pollTimer, &QTimer::timeout, this, &SaveScheduler::poll);
+
+    // Not restarted by later notifications, so a steady stream of saves
+    // still gets polled
+    const auto schedulePoll = [this]() {
+        if (!m_pollTimer.isActive())
+            m_pollTimer.start();
+    };
+    connect(&m_watcher, &QFileSystemWatcher::fileChanged, this, schedulePoll);
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, schedulePoll);
+
+    // One thread that never expires: writes stay ordered, and per-thread
+    // resources such as SQLite connections remain valid between writes
+    m_pool.setMaxThreadCount(1);
+    m_pool.setExpiryTimeout(-1);
+}
+
+/**
+ * @brief Destructor implementation
+ */
+SaveScheduler::~SaveScheduler()
+{
+    flush();
+
+    // Per-thread resources such as SQLite connections must be closed by
+    // the thread that opened them, before the pool ends it
+    m_pool.start([this]() { m_storage->releaseThreadResources(); });
+    m_pool.waitForDone();
+}
+
+/**
+ * @brief Record a change and schedule a write
+ */
+void SaveScheduler::markDirty(const TodoChange& change)
+{
+    m_pending.append(change);
+    if (!m_timer.isActive())
+        m_timer.start();
+}
+
+/**
+ * @brief Record several changes and schedule a single write
+ */
+void SaveScheduler::markDirty(const TodoChangeList& changes)
+{
+    if (changes.isEmpty())
+        return;
+
+    m_pending.append(changes);
+    if (!m_timer.isActive())
+        m_timer.start();
+}
+
+/**
+ * @brief Write pending changes and wait for the worker
+ */
+bool SaveScheduler::flush()
+{
+    m_timer.stop();
+    if (m_loading) {
+        // The load runs ahead of any write; deliver it now so the
+        // snapshot taken below includes the saved items
+        m_pool.waitForDone();
+        QCoreApplication::sendPostedEvents(this, QEvent::MetaCall);
+    }
+
+    if (isDirty())
+        submit();
+
+    m_pool.waitForDone();
+    return m_lastSaveOk;
+}
+
+/**
+ * @brief Hand pending changes and a snapshot to the worker thread
+ *
+ * The snapshot shares the store's columns, so taking it is O(1) here.
+ * The worker only builds TodoItems from it for full saves and journal
+ * compaction; incremental saves write the changes alone.
+ */
+void SaveScheduler::submit()
+{
+    // Held until loaded() has been delivered
+    if (m_loading || !isDirty())
+        return;
+
+    // A running poll may read the storage before these are written
+    if (m_polling) {
+        for (const TodoChange& change : std::as_const(m_pending))
+            m_unsettledIds.insert(change.id);
+    }
+
+    TodoChangeList changes = std::move(m_pending);
+    m_pending.clear();
+    TodoStore snapshot = m_snapshot();
+    std::optional<TodoStatistics> statistics;
+    if (m_statistics)
+        statistics = m_statistics();
+
+    m_pool.start([this, changes = std::move(changes), snapshot = std::move(snapshot),
+                  statistics = std::move(statistics)]() {
+        // A failed incremental write may have lost changes, so recover
+        // by rewriting the full list
+        bool ok = m_needsFullSave.exchange(false)
+                      ? m_storage->saveTodos(snapshot.toItems())
+                      : m_storage->saveChanges(changes, snapshot);
+
+        if (!ok) {
+            qWarning() << "Background save failed, next save rewrites all todos";
+            m_needsFullSave = true;
+        }
+
+        // The history is rewritten whole and is small; losing it is not
+        // worth failing the save over
+        if (statistics && !m_storage->saveStatistics(*statistics))
+            qWarning() << "Failed to save statistics";
+        m_lastSaveOk = ok;
+        std::optional<QVector<StorageManager::CategorySummary>> summaries = readSummaries();
+
+        QMetaObject::invokeMethod(this, [this, ok, summaries = std::move(summaries)]() {
+            // Without another edit nothing would write again, so a failed
+            // write is retried on its own, backing off while it keeps failing
+            if (ok) {
+                m_retryDelayMs = 0;
+            } else {
+                m_retryDelayMs = m_retryDelayMs == 0 ? kFirstRetryDelayMs
+                                                     : qMin(2 * m_retryDelayMs, kMaxRetryDelayMs);
+                m_retryTimer.start(m_retryDelayMs);
+            }
+
+            if (summaries)
+                emit categorySummariesRead(*summaries);
+            emit saveFinished(ok);
+        }, Qt::QueuedConnection);
+    });
+}
+
+/**
+ * @brief Read the saved list on the worker thread
+ */
+void SaveScheduler::load(const QStringList& categories)
+{
+    if (m_loading)
+        return;
+
+    m_loading = true;
+    m_pool.start([this, categories]() {
+        TodoStore store = m_storage->loadStore(categories);
+        std::optional<QVector<StorageManager::CategorySummary>> summaries = readSummaries();
+
+        QMetaObject::invokeMethod(this, [this, store = std::move(store), summaries = std::move(summaries)]() {
+            m_loading = false;
+            if (summaries)
+                emit categorySummariesRead(*summaries);
+            emit loaded(store);
+
+            // Write what was edited while the list was being read
+            if (isDirty() && !m_timer.isActive())
+                m_timer.start();
+
+            if (std::exchange(m_pollAgain, false))
+                poll();
+        }, Qt::QueuedConnection);
+    });
+}
+
+/**
+ * @brief Start or stop watching the storage
+ */
+void SaveScheduler::setWatching(bool enabled)
+{
+    if (enabled == m_watching)
+        return;
+
+    m_watching = enabled;
+    if (!enabled) {
+        m_pollTimer.stop();
+        const QStringList paths = m_watcher.files() + m_watcher.directories();
+        if (!paths.isEmpty())
+            m_watcher.removePaths(paths);
+        return;
+    }
+
+    poll();
+}
+
+/**
+ * @brief Read saves by other processes on the worker thread
+ *
+ * One poll runs at a time; a notification arriving meanwhile polls
+ * again afterwards, since the running read may have missed its save.
+ */
+void SaveScheduler::poll()
+{
+    if (m_watching)
+        watchPaths();
+
+    if (m_polling || m_loading) {
+        m_pollAgain = true;
+        return;
+    }
+
+    m_polling = true;
+    m_pool.start([this]() {
+        TodoChangeList changes = m_storage->readExternalChanges();
+        std::optional<QVector<StorageManager::CategorySummary>> summaries = readSummaries();
+
+        QMetaObject::invokeMethod(this, [this, changes = std::move(changes), summaries = std::move(summaries)]() {
+            m_polling = false;
+            if (summaries)
+                emit categorySummariesRead(*summaries);
+            deliverExternalChanges(changes);
+
+            if (std::exchange(m_pollAgain, false))
+                poll();
+        }, Qt::QueuedConnection);
+    });
+}
+
+/**
+ * @brief Write pending changes, then read saves by other processes
+ */
+bool SaveScheduler::sync()
+{
+    const bool ok = flush();
+
+    // Deliver a running poll first, so changes arrive in the order read
+    while (m_polling) {
+        m_pool.waitForDone();
+        QCoreApplication::sendPostedEvents(this, QEvent::MetaCall);
+    }
+
+    TodoChangeList changes = m_storage->readExternalChanges();
+    if (const auto summaries = readSummaries())
+        emit categorySummariesRead(*summaries);
+    deliverExternalChanges(std::move(changes));
+    return ok;
+}
+
+/**
+ * @brief Watch the storage paths that exist by now
+ */
+void SaveScheduler::watchPaths()
+{
+    QStringList paths = m_storage->watchedPaths();
+    const QStringList watched = m_watcher.files() + m_watcher.directories();
+    paths.erase(std::remove_if(paths.begin(), paths.end(),
+                               [&watched](const QString& path) { return watched.contains(path); }),
+                paths.end());
+    if (!paths.isEmpty())
+        m_watcher.addPaths(paths);
+}
+
+/**
+ * @brief Read the category summaries on the worker if they are wanted
+ */
+std::optional<QVector<StorageManager::CategorySummary>> SaveScheduler::readSummaries() const
+{
+    if (!m_reportSummaries || !m_storage->isSharded())
+        return std::nullopt;
+
+    return m_storage->categorySummaries();
+}
+
+/**
+ * @brief Emit the external changes that survive pending edits
+ */
+void SaveScheduler::deliverExternalChanges(TodoChangeList changes)
+{
+    QSet<QUuid> unsaved = std::exchange(m_unsettledIds, {});
+    for (const TodoChange& change : std::as_const(m_pending))
+        unsaved.insert(change.id);
+
+    changes.erase(std::remove_if(changes.begin(), changes.end(),
+                                 [&unsaved](const TodoChange& change) {
+                                     return change.type == TodoChange::Type::Remove
+                                            && unsaved.contains(change.id);
+                                 }),
+                  changes.end());
+    if (!changes.isEmpty())
+        emit externalChanges(changes);
+}
@@ -0,0 +1,253 @@
+/**
+ * @file SaveScheduler.h
+ * @brief Debounced background persistence for the todo model
+ *
+ * This file defines the SaveScheduler class which collects changes from
+ * the model, coalesces bursts of edits into a single write and performs
+ * the write on a worker thread.
+ */
+
+#ifndef SAVESCHEDULER_H
+#define SAVESCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QThreadPool>
+#include <QFileSystemWatcher>
+#include <QSet>
+#include <QVector>
+#include <QStringList>
+#include <atomic>
+#include <functional>
+#include <optional>
+#include "TodoChange.h"
+#include "TodoStore.h"
+#include "TodoStatistics.h"
+#include "StorageManager.h"
+
+/**
+ * @class SaveScheduler
+ * @brief Coalesces model changes and saves them off the GUI thread
+ *
+ * Every mutation marks the scheduler dirty. Changes arriving within the
+ * configured delay are merged into one write on a dedicated worker
+ * thread, which gets the changes plus a snapshot of the store for the
+ * saves that need the whole list. All storage I/O runs on that
+ * single thread, one write at a time and in submission order. A failed
+ * write is retried after a delay that doubles up to a minute.
+ *
+ * flush() blocks until everything marked dirty so far is on disk; the
+ * owner must call it before the StorageManager is destroyed.
+ *
+ * load() reads the saved list on the same worker thread. Writes are held
+ * back until loaded() has been delivered, because a snapshot taken before
+ * then would lack the saved items and a journal compaction could replace
+ * them with it.
+ *
+ * While watching, saves by other processes sharing the storage are read
+ * on the worker as well, shortly after a watched file changes, and
+ * delivered by externalChanges(). Removals of items with edits not yet
+ * written are left out, since writing the edit brings them back.
+ */
+class SaveScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// Returns the complete list to persist, called on the GUI thread
+    using SnapshotProvider = std::function<TodoStore()>;
+
+    /// Returns the statistics to persist with the list, called on the GUI thread
+    using StatisticsProvider = std::function<TodoStatistics()>;
+
+    /**
+     * @brief Constructor
+     * @param storage Storage manager used by the worker (not owned)
+     * @param snapshot Provider of the list to persist
+     * @param parent Parent QObject
+     */
+    SaveScheduler(StorageManager* storage, SnapshotProvider snapshot, QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor, flushes pending changes and releases the worker's storage resources
+     */
+    ~SaveScheduler() override;
+
+    /**
+     * @brief Set the coalescing window
+     * @param msec Delay between the first change and the write
+     */
+    void setDelay(int msec) { m_timer.setInterval(msec); }
+
+    /**
+     * @brief Get the coalescing window
+     * @return Delay in milliseconds
+     */
+    int delay() const { return m_timer.interval(); }
+
+    /**
+     * @brief Save statistics along with every write
+     * @param statistics Provider of the statistics; empty saves none
+     */
+    void setStatisticsProvider(StatisticsProvider statistics) { m_statistics = std::move(statistics); }
+
+    /**
+     * @brief Record a change and schedule a write
+     * @param change Change to persist
+     */
+    void markDirty(const TodoChange& change);
+
+    /**
+     * @brief Record several changes and schedule a single write
+     * @param changes Changes to persist, in order
+     */
+    void markDirty(const TodoChangeList& changes);
+
+    /**
+     * @brief Check whether changes are waiting to be written
+     * @return true if a write is pending
+     */
+    bool isDirty() const { return !m_pending.isEmpty() || m_needsFullSave; }
+
+    /**
+     * @brief Write pending changes now and wait for all writes to finish
+     * @return true if the last write succeeded
+     */
+    bool flush();
+
+    /**
+     * @brief Read the saved list on the worker thread
+     *
+     * Emits loaded() when done. Changes marked dirty in the meantime are
+     * written afterwards; flush() delivers loaded() first if it is still
+     * pending.
+     *
+     * @param categories Categories to read from a sharded backend; empty reads all
+     */
+    void load(const QStringList& categories = QStringList());
+
+    /**
+     * @brief Check whether a load has not been delivered yet
+     * @return true between load() and loaded()
+     */
+    bool isLoading() const { return m_loading; }
+
+    /**
+     * @brief Start or stop watching the storage for saves by other processes
+     *
+     * Starting also reads what was saved since the last read.
+     *
+     * @param enabled Whether to watch
+     */
+    void setWatching(bool enabled);
+
+    /**
+     * @brief Check whether the storage is being watched
+     * @return true if externalChanges() is emitted for other processes' saves
+     */
+    bool isWatching() const { return m_watching; }
+
+    /**
+     * @brief Read the category summaries after every load, save and poll
+     *
+     * The summaries are read on the worker, so the GUI thread can keep
+     * a copy without touching the disk.
+     *
+     * @param enabled Whether to emit categorySummariesRead()
+     */
+    void setReportingSummaries(bool enabled) { m_reportSummaries = enabled; }
+
+    /**
+     * @brief Read saves by other processes on the worker thread
+     *
+     * Emits externalChanges() if there are any. Called when a watched
+     * file changes; runs after a load still in progress.
+     */
+    void poll();
+
+    /**
+     * @brief Write pending changes, then read saves by other processes now
+     *
+     * Emits externalChanges() before returning if there are any.
+     *
+     * @return true if the last write succeeded
+     */
+    bool sync();
+
+signals:
+    /**
+     * @brief Emitted on the GUI thread after each write
+     * @param success Whether the write succeeded
+     */
+    void saveFinished(bool success);
+
+    /**
+     * @brief Emitted on the GUI thread when load() has read the list
+     * @param store Saved items
+     */
+    void loaded(const TodoStore& store);
+
+    /**
+     * @brief Emitted on the GUI thread when other processes saved changes
+     * @param changes Stored state of the changed items, see StorageManager::readExternalChanges()
+     */
+    void externalChanges(const TodoChangeList& changes);
+
+    /**
+     * @brief Emitted on the GUI thread after a load, save or poll read the summaries
+     *
+     * Only emitted while reporting is enabled, and before the signal of
+     * the load, save or poll itself.
+     *
+     * @param summaries Stored per-category counts, see StorageManager::categorySummaries()
+     */
+    void categorySummariesRead(const QVector<StorageManager::CategorySummary>& summaries);
+
+private slots:
+    /**
+     * @brief Hand the pending changes to the worker thread
+     */
+    void submit();
+
+private:
+    /**
+     * @brief Watch the storage paths that exist by now
+     *
+     * Files replaced by renaming drop out of the watcher, so this runs
+     * again on every poll.
+     */
+    void watchPaths();
+
+    /**
+     * @brief Read the category summaries on the worker if they are wanted
+     * @return Summaries, or nothing while reporting is off or the backend is not sharded
+     */
+    std::optional<QVector<StorageManager::CategorySummary>> readSummaries() const;
+
+    /**
+     * @brief Emit the external changes that survive pending edits
+     * @param changes Changes read from the storage
+     */
+    void deliverExternalChanges(TodoChangeList changes);
+
+    StorageManager *m_storage;              ///< Storage manager (not owned)
+    SnapshotProvider m_snapshot;            ///< Provider of the list to persist
+    StatisticsProvider m_statistics;        ///< Provider of the statistics, may be empty
+    TodoChangeList m_pending;               ///< Changes since the last submit
+    QTimer m_timer;                         ///< Coalescing timer
+    QTimer m_retryTimer;                    ///< Retries a failed write
+    int m_retryDelayMs = 0;                 ///< Delay before the next retry, 0 after a successful write
+    QThreadPool m_pool;                     ///< Single storage worker thread
+    std::atomic<bool> m_needsFullSave{false}; ///< Last write failed, rewrite everything
+    std::atomic<bool> m_lastSaveOk{true};   ///< Result of the last write
+    bool m_loading = false;                 ///< A load is running, writes are held
+    QFileSystemWatcher m_watcher;           ///< Watches the storage files
+    QTimer m_pollTimer;                     ///< Coalesces watcher notifications into one poll
+    bool m_watching = false;                ///< Watching is enabled
+    bool m_polling = false;                 ///< A poll is running on the worker
+    bool m_pollAgain = false;               ///< Poll once the running poll or load is delivered
+    QSet<QUuid> m_unsettledIds;             ///< Items submitted while a poll was running
+    std::atomic<bool> m_reportSummaries{false}; ///< Read the category summaries on the worker
+};
+
+#endif // SAVESCHEDULER_H
@@ -0,0 +1,45 @@
+/**
+ * @file StartupLog.cpp
+ * @brief Implementation of the StartupLog helpers
+ */
+
+#include "StartupLog.h"
+#include <QElapsedTimer>
+#include <QDebug>
+
+namespace {
+
+/**
+ * @brief Clock started by StartupLog::start()
+ */
+QElapsedTimer& startupClock()
+{
+    static QElapsedTimer clock;
+    return clock;
+}
+
+} // namespace
+
+/**
+ * @brief Start the startup clock
+ */
+void StartupLog::start()
+{
+    startupClock().start();
+}
+
+/**
+ * @brief Get the time since start()
+ */
+qint64 StartupLog::elapsed()
+{
+    return startupClock().isValid() ? startupClock().elapsed() : 0;
+}
+
+/**
+ * @brief Log a milestone
+ */
+void StartupLog::mark(const QString& milestone)
+{
+    qInfo().noquote() << QStringLiteral("Startup: %1 after %2 ms").arg(milestone).arg(elapsed());
+}
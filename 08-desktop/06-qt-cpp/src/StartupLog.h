@@ -0,0 +1,43 @@
+/**
+ * @file StartupLog.h
+ * @brief Startup timing log
+ *
+ * This file declares helpers that time the application start and log
+ * milestones such as the first painted frame and the end of loading.
+ */
+
+#ifndef STARTUPLOG_H
+#define STARTUPLOG_H
+
+#include <QString>
+
+/**
+ * @namespace StartupLog
+ * @brief Milestones measured from the start of main()
+ *
+ * Each milestone is written once through qInfo() as
+ * "Startup: <milestone> after <n> ms", so the timings can be compared
+ * between runs without a profiler.
+ */
+namespace StartupLog {
+
+/**
+ * @brief Start the clock; call first thing in main()
+ */
+void start();
+
+/**
+ * @brief Get the time since start()
+ * @return Milliseconds, or 0 if start() was not called
+ */
+qint64 elapsed();
+
+/**
+ * @brief Log a milestone with the time since start()
+ * @param milestone Description of what just happened
+ */
+void mark(const QString& milestone);
+
+} // namespace StartupLog
+
+#endif // STARTUPLOG_H
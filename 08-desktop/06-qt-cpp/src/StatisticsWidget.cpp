@@ -0,0 +1,218 @@
+/**
+ * @file StatisticsWidget.cpp
+ * @brief Implementation of StatisticsWidget class
+ */
+
+#include "StatisticsWidget.h"
+#include "TodoModel.h"
+#include <QPainter>
+#include <QFontMetrics>
+#include <algorithm>
+
+namespace {
+
+/// Space around the charts and between their parts
+constexpr int kMargin = 8;
+
+/// Height of a histogram
+constexpr int kChartHeight = 80;
+
+/// Width of the labels left of the split bars
+constexpr int kLabelWidth = 80;
+
+/// Preferred width of the dashboard
+constexpr int kPreferredWidth = 260;
+
+} // namespace
+
+/**
+ * @brief Construct a dashboard for a model
+ */
+StatisticsWidget::StatisticsWidget(const TodoModel *model, QWidget *parent)
+    : QWidget(parent)
+    , m_model(model)
+{
+    setMinimumWidth(kPreferredWidth / 2);
+}
+
+/**
+ * @brief Get the preferred size
+ */
+QSize StatisticsWidget::sizeHint() const
+{
+    const int line = fontMetrics().height() + kMargin / 2;
+    const int summary = 2 * line;
+    const int headings = 4 * (line + kMargin);
+    const int charts = 2 * (kChartHeight + kMargin);
+    const int bars = (int(m_priorities.size()) + kCategories) * line;
+    return QSize(kPreferredWidth, kMargin + summary + headings + charts + bars + kMargin);
+}
+
+/**
+ * @brief Take the current statistics from the model and repaint
+ */
+void StatisticsWidget::refresh()
+{
+    if (!isVisible()) {
+        m_stale = true;
+        return;
+    }
+
+    const TodoStatistics& statistics = m_model->statistics();
+    m_today = QDate::currentDate();
+    m_days = statistics.days(m_today.addDays(1 - kDays), kDays);
+    m_weeks = statistics.weeks(m_today.addDays(-7 * (kWeeks - 1)), kWeeks);
+    m_weekRate = statistics.completionRate(m_today, 7);
+    for (int priority = 0; priority < int(m_priorities.size()); ++priority)
+        m_priorities[priority] = statistics.priorityCounts(static_cast<TodoItem::Priority>(priority));
+
+    m_categories = m_model->categorySummaries();
+    std::stable_sort(m_categories.begin(), m_categories.end(),
+                     [](const StorageManager::CategorySummary& a, const StorageManager::CategorySummary& b) {
+                         return a.count > b.count;
+                     });
+    if (m_categories.size() > kCategories)
+        m_categories.resize(kCategories);
+
+    m_stale = false;
+    update();
+}
+
+/**
+ * @brief Paint the charts
+ */
+void StatisticsWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    QPainter painter(this);
+    const int line = fontMetrics().height() + kMargin / 2;
+    const QRect textRect(kMargin, 0, width() - 2 * kMargin, line);
+    int y = kMargin;
+
+    const TodoStatistics::Bucket today = m_days.isEmpty() ? TodoStatistics::Bucket() : m_days.last();
+    painter.setPen(palette().color(QPalette::WindowText));
+    painter.drawText(textRect.translated(0, y), Qt::AlignLeft | Qt::AlignVCenter,
+                     tr("Today: %1 created, %2 completed").arg(today.created).arg(today.completed));
+    y += line;
+    painter.drawText(textRect.translated(0, y), Qt::AlignLeft | Qt::AlignVCenter,
+                     tr("Completed per day, last 7 days: %1").arg(m_weekRate, 0, 'f', 1));
+    y += line;
+
+    drawHeading(painter, y, tr("Last %n day(s)", nullptr, kDays));
+    drawHistogram(painter, y, m_days);
+
+    drawHeading(painter, y, tr("Last %n week(s)", nullptr, kWeeks));
+    drawHistogram(painter, y, m_weeks);
+
+    // Most urgent first, bars scaled to the largest level
+    drawHeading(painter, y, tr("By priority"));
+    int scale = 1;
+    for (const TodoStatistics::Counts& counts : m_priorities)
+        scale = qMax(scale, counts.total());
+    for (int priority = int(m_priorities.size()) - 1; priority >= 0; --priority) {
+        const TodoStatistics::Counts& counts = m_priorities[priority];
+        drawSplitBar(painter, y, TodoItem::priorityToString(static_cast<TodoItem::Priority>(priority)),
+                     counts.completed, counts.total(), scale);
+    }
+
+    drawHeading(painter, y, tr("By category"));
+    scale = m_categories.isEmpty() ? 1 : qMax(1, m_categories.first().count);
+    for (const StorageManager::CategorySummary& summary : std::as_const(m_categories)) {
+        drawSplitBar(painter, y, summary.category.isEmpty() ? tr("(none)") : summary.category,
+                     summary.completed, summary.count, scale);
+    }
+}
+
+/**
+ * @brief Refresh statistics that changed while hidden
+ */
+void StatisticsWidget::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    if (m_stale || m_today != QDate::currentDate())
+        refresh();
+}
+
+/**
+ * @brief Paint a section heading
+ */
+void StatisticsWidget::drawHeading(QPainter &painter, int &y, const QString &text) const
+{
+    y += kMargin;
+    QFont bold = font();
+    bold.setBold(true);
+    painter.save();
+    painter.setFont(bold);
+    painter.setPen(palette().color(QPalette::WindowText));
+    const int height = QFontMetrics(bold).height() + kMargin / 2;
+    painter.drawText(QRect(kMargin, y, width() - 2 * kMargin, height), Qt::AlignLeft | Qt::AlignVCenter, text);
+    painter.restore();
+    y += height;
+}
+
+/**
+ * @brief Paint a histogram of created and completed items
+ *
+ * Each bucket gets a created bar and a completed bar side by side; the
+ * largest value of either reaches the top.
+ */
+void StatisticsWidget::drawHistogram(QPainter &painter, int &y, const QVector<TodoStatistics::Bucket> &buckets) const
+{
+    const QRect area(kMargin, y, width() - 2 * kMargin, kChartHeight);
+    y += kChartHeight + kMargin;
+    if (buckets.isEmpty() || area.width() <= 0)
+        return;
+
+    int maximum = 1;
+    for (const TodoStatistics::Bucket& bucket : buckets)
+        maximum = qMax(maximum, qMax(bucket.created, bucket.completed));
+
+    const QColor createdColor = palette().color(QPalette::Mid);
+    const QColor completedColor = palette().color(QPalette::Highlight);
+    const qreal slotWidth = qreal(area.width()) / buckets.size();
+    const qreal barWidth = qMax(1.0, (slotWidth - 1) / 2);
+    for (int i = 0; i < buckets.size(); ++i) {
+        const qreal left = area.left() + i * slotWidth;
+        const qreal createdHeight = qreal(area.height()) * buckets[i].created / maximum;
+        const qreal completedHeight = qreal(area.height()) * buckets[i].completed / maximum;
+        painter.fillRect(QRectF(left, area.bottom() + 1 - createdHeight, barWidth, createdHeight), createdColor);
+        painter.fillRect(QRectF(left + barWidth, area.bottom() + 1 - completedHeight, barWidth, completedHeight),
+                         completedColor);
+    }
+
+    painter.setPen(palette().color(QPalette::PlaceholderText));
+    painter.drawLine(area.bottomLeft(), area.bottomRight());
+    painter.drawText(area, Qt::AlignRight | Qt::AlignTop, QString::number(maximum));
+}
+
+/**
+ * @brief Paint one labelled bar split into completed and active parts
+ */
+void StatisticsWidget::drawSplitBar(QPainter &painter, int &y, const QString &label,
+                                    int completed, int total, int scale) const
+{
+    const QFontMetrics metrics = fontMetrics();
+    const int line = metrics.height() + kMargin / 2;
+    const QString count = QString::number(total);
+    const int countWidth = metrics.horizontalAdvance(count);
+    const QRect labelRect(kMargin, y, kLabelWidth, line);
+    const int barLeft = labelRect.right() + 1 + kMargin;
+    const int barSpace = width() - barLeft - 2 * kMargin - countWidth;
+
+    painter.setPen(palette().color(QPalette::WindowText));
+    painter.drawText(labelRect, Qt::AlignLeft | Qt::AlignVCenter,
+                     metrics.elidedText(label, Qt::ElideRight, kLabelWidth));
+
+    if (barSpace > 0 && scale > 0) {
+        const int barTop = y + kMargin / 4;
+        const int barHeight = line - kMargin / 2;
+        const int totalWidth = barSpace * total / scale;
+        const int completedWidth = total > 0 ? totalWidth * completed / total : 0;
+        painter.fillRect(QRect(barLeft, barTop, completedWidth, barHeight), palette().color(QPalette::Highlight));
+        painter.fillRect(QRect(barLeft + completedWidth, barTop, totalWidth - completedWidth, barHeight),
+                         palette().color(QPalette::Mid));
+        painter.drawText(QRect(barLeft + totalWidth + kMargin, y, countWidth, line),
+                         Qt::AlignLeft | Qt::AlignVCenter, count);
+    }
+    y += line;
+}
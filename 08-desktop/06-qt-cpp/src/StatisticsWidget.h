@@ -0,0 +1,117 @@
+/**
+ * @file StatisticsWidget.h
+ * @brief Dashboard painting the model's productivity statistics
+ *
+ * This file defines the StatisticsWidget class which shows completion
+ * rates, created and completed histograms and per-priority and
+ * per-category breakdowns of the todo list.
+ */
+
+#ifndef STATISTICSWIDGET_H
+#define STATISTICSWIDGET_H
+
+#include <QWidget>
+#include <QDate>
+#include <QVector>
+#include <array>
+#include "TodoStatistics.h"
+#include "StorageManager.h"
+
+class TodoModel;
+
+/**
+ * @class StatisticsWidget
+ * @brief Charts of the statistics TodoModel keeps up to date
+ *
+ * refresh() copies the few numbers the charts need out of the model:
+ * a fixed number of day and week buckets, four priority counts and one
+ * entry per category. Painting only reads those copies, so neither
+ * depends on the size of the list. While the widget is hidden refresh()
+ * only marks the copies stale; they are taken again when it is shown.
+ */
+class StatisticsWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    /// Days in the daily histogram
+    static constexpr int kDays = 30;
+
+    /// Weeks in the weekly histogram
+    static constexpr int kWeeks = 12;
+
+    /// Categories listed, largest first
+    static constexpr int kCategories = 8;
+
+    /**
+     * @brief Construct a dashboard for a model
+     * @param model Model to read statistics from (not owned)
+     * @param parent Parent widget
+     */
+    explicit StatisticsWidget(const TodoModel *model, QWidget *parent = nullptr);
+
+    /**
+     * @brief Get the preferred size
+     * @return Size fitting every chart
+     */
+    QSize sizeHint() const override;
+
+public slots:
+    /**
+     * @brief Take the current statistics from the model and repaint
+     */
+    void refresh();
+
+protected:
+    /**
+     * @brief Paint the charts
+     * @param event Paint event
+     */
+    void paintEvent(QPaintEvent *event) override;
+
+    /**
+     * @brief Refresh statistics that changed while hidden
+     * @param event Show event
+     */
+    void showEvent(QShowEvent *event) override;
+
+private:
+    const TodoModel *m_model;                           ///< Model the statistics come from
+    QDate m_today;                                      ///< Last day of the histograms
+    QVector<TodoStatistics::Bucket> m_days;             ///< Last kDays days, oldest first
+    QVector<TodoStatistics::Bucket> m_weeks;            ///< Last kWeeks weeks, oldest first
+    double m_weekRate = 0.0;                            ///< Completions per day over the last week
+    std::array<TodoStatistics::Counts, 4> m_priorities; ///< Indexed by TodoItem::Priority
+    QVector<StorageManager::CategorySummary> m_categories; ///< Largest categories first
+    bool m_stale = true;                                ///< Copies are out of date
+
+    /**
+     * @brief Paint a section heading
+     * @param painter Painter of the widget
+     * @param y Top of the heading, moved below it
+     * @param text Heading text
+     */
+    void drawHeading(QPainter &painter, int &y, const QString &text) const;
+
+    /**
+     * @brief Paint a histogram of created and completed items
+     * @param painter Painter of the widget
+     * @param y Top of the chart, moved below it
+     * @param buckets One pair of bars per bucket
+     */
+    void drawHistogram(QPainter &painter, int &y, const QVector<TodoStatistics::Bucket> &buckets) const;
+
+    /**
+     * @brief Paint one labelled bar split into completed and active parts
+     * @param painter Painter of the widget
+     * @param y Top of the bar, moved below it
+     * @param label Text left of the bar
+     * @param completed Completed items
+     * @param total All items
+     * @param scale Total that fills the full width
+     */
+    void drawSplitBar(QPainter &painter, int &y, const QString &label,
+                      int completed, int total, int scale) const;
+};
+
+#endif // STATISTICSWIDGET_H
@@ -4,13 +4,330 @@
  */
 
 #include "StorageManager.h"
+#include "TodoSnapshot.h"
+#include "TodoJsonReader.h"
+#include "TodoExporter.h"
+#include "TodoStatistics.h"
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QFile>
+#include <QSaveFile>
+#include <QLockFile>
+#include <QFileInfo>
+#include <QHash>
 #include <QDir>
+#include <QCryptographicHash>
+#include <QDataStream>
 #include <QStandardPaths>
+#include <QThread>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QtEndian>
 #include <QDebug>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#ifdef Q_OS_WIN
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+/// Minimum number of journal records before compaction is considered,
+/// so that small lists are not snapshotted on every save
+constexpr int kMinJournalEntries = 1000;
+
+/// Signature of a block-compressed data file
+constexpr char kCompressedMagic[4] = {'Q', 'T', 'D', 'Z'};
+
+/// Magic, u32 format version and u64 uncompressed size
+constexpr int kCompressedHeaderSize = 16;
+
+/// Uncompressed bytes per compressed block
+constexpr int kCompressionBlockSize = 1024 * 1024;
+
+/// zlib cannot expand data by more than this factor
+constexpr quint64 kMaxCompressionRatio = 1032;
+
+/// Signature of the statistics file ("TDST")
+constexpr quint32 kStatisticsMagic = 0x54445354;
+
+/// Format version of the statistics file
+constexpr quint32 kStatisticsVersion = 1;
+
+/// How long to wait for another process to release the storage lock
+constexpr int kLockTimeoutMs = 5000;
+
+/**
+ * @enum JournalRecord
+ * @brief Kinds of journal line
+ */
+enum class JournalRecord {
+    Corrupt,    ///< Unreadable, skipped
+    Change,     ///< A saved change
+    Epoch       ///< First line of a journal, naming the compaction that started it
+};
+
+/**
+ * @brief Encode todos as a compact JSON array
+ *
+ * Each item is encoded on its own and appended, so no QJsonArray of the
+ * whole list is built.
+ */
+QByteArray encodeTodoArray(const QVector<TodoItem>& todos)
+{
+    QByteArray json;
+    json.append('[');
+    for (int i = 0; i < todos.size(); ++i) {
+        if (i > 0)
+            json.append(',');
+        json.append(QJsonDocument(todos[i].toJson()).toJson(QJsonDocument::Compact));
+    }
+    json.append(']');
+    return json;
+}
+
+/**
+ * @brief Decode a JSON array of todos
+ */
+QVector<TodoItem> parseTodoArray(const QByteArray& json, const QString& source)
+{
+    QVector<TodoItem> todos;
+
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(json, &parseError);
+
+    if (parseError.error != QJsonParseError::NoError) {
+        qWarning() << "Failed to parse stored JSON:" << parseError.errorString();
+        return todos;
+    }
+
+    if (!doc.isArray()) {
+        qWarning() << "Invalid stored data format";
+        return todos;
+    }
+
+    const QJsonArray todoArray = doc.array();
+    todos.reserve(todoArray.size());
+    for (const QJsonValue& value : todoArray) {
+        if (value.isObject()) {
+            todos.append(TodoItem::fromJson(value.toObject()));
+        }
+    }
+
+    qDebug() << "Loaded" << todos.size() << "todos from" << source;
+    return todos;
+}
+
+/**
+ * @brief Write data as a header followed by qCompress()ed blocks
+ *
+ * Each block is prefixed with its compressed length (u32, little-endian)
+ * and goes to the device as soon as it is compressed.
+ */
+qint64 writeCompressed(QIODevice& device, const QByteArray& data)
+{
+    uchar header[kCompressedHeaderSize] = {};
+    std::memcpy(header, kCompressedMagic, sizeof(kCompressedMagic));
+    qToLittleEndian<quint32>(1, header + 4);
+    qToLittleEndian<quint64>(quint64(data.size()), header + 8);
+    qint64 written = device.write(reinterpret_cast<const char*>(header), kCompressedHeaderSize);
+
+    for (qsizetype offset = 0; offset < data.size(); offset += kCompressionBlockSize) {
+        const QByteArray block = qCompress(reinterpret_cast<const uchar*>(data.constData() + offset),
+                                           qMin<qsizetype>(kCompressionBlockSize, data.size() - offset));
+        uchar length[4];
+        qToLittleEndian<quint32>(quint32(block.size()), length);
+        written += device.write(reinterpret_cast<const char*>(length), sizeof(length));
+        written += device.write(block);
+    }
+    return written;
+}
+
+/**
+ * @brief Check for the block-compressed file signature
+ */
+bool isCompressed(const uchar* data, qint64 size)
+{
+    return size >= kCompressedHeaderSize
+           && std::memcmp(data, kCompressedMagic, sizeof(kCompressedMagic)) == 0;
+}
+
+/**
+ * @brief Decompress a block-compressed file in one pass
+ * @return false if the file is corrupt
+ */
+bool uncompressBlocks(const uchar* data, qint64 size, QByteArray& out)
+{
+    const quint32 version = qFromLittleEndian<quint32>(data + 4);
+    const quint64 expected = qFromLittleEndian<quint64>(data + 8);
+    if (version != 1 || expected > quint64(size) * kMaxCompressionRatio) {
+        return false;
+    }
+
+    out.clear();
+    out.reserve(qsizetype(expected));
+
+    qint64 pos = kCompressedHeaderSize;
+    while (pos < size) {
+        if (size - pos < 4)
+            return false;
+        const quint32 length = qFromLittleEndian<quint32>(data + pos);
+        pos += 4;
+        if (length > quint64(size - pos))
+            return false;
+
+        const QByteArray block = qUncompress(data + pos, length);
+        if (block.isEmpty())
+            return false;
+        out.append(block);
+        pos += length;
+    }
+    return quint64(out.size()) == expected;
+}
+
+/**
+ * @brief Force what was written to a file onto the disk
+ *
+ * QFile::flush() only hands the data to the operating system, which may
+ * lose it on power failure. Must follow a successful flush().
+ */
+bool syncToDisk(QFile& file)
+{
+#if defined(Q_OS_WIN)
+    return FlushFileBuffers(reinterpret_cast<HANDLE>(_get_osfhandle(file.handle())));
+#elif defined(Q_OS_DARWIN)
+    // No fdatasync() here, and fsync() does not flush the drive cache
+    return ::fcntl(file.handle(), F_FULLFSYNC) == 0 || ::fsync(file.handle()) == 0;
+#else
+    return ::fdatasync(file.handle()) == 0;
+#endif
+}
+
+/**
+ * @brief Encode a change as a single-line journal record
+ */
+QByteArray journalRecord(const TodoChange& change)
+{
+    QJsonObject record;
+    switch (change.type) {
+        case TodoChange::Type::Upsert:
+            record["op"] = "upsert";
+            record["item"] = change.item.toJson();
+            break;
+        case TodoChange::Type::Remove:
+            record["op"] = "remove";
+            record["id"] = change.id.toString(QUuid::WithoutBraces);
+            break;
+        case TodoChange::Type::Clear:
+            record["op"] = "clear";
+            break;
+    }
+    return QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n';
+}
+
+/**
+ * @brief Encode the first line of a new journal
+ */
+QByteArray epochRecord(const QString& epoch)
+{
+    QJsonObject record;
+    record["op"] = "epoch";
+    record["id"] = epoch;
+    return QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n';
+}
+
+/**
+ * @brief Decode a journal line written by journalRecord() or epochRecord()
+ */
+JournalRecord parseJournalRecord(const QByteArray& line, TodoChange& change, QString& epoch)
+{
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+        // Only the last record can be torn by a crash during append
+        qWarning() << "Skipping corrupt journal record:" << parseError.errorString();
+        return JournalRecord::Corrupt;
+    }
+
+    const QJsonObject record = doc.object();
+    const QString op = record["op"].toString();
+    if (op == "upsert" && record["item"].isObject()) {
+        change = TodoChange::upsert(TodoItem::fromJson(record["item"].toObject()));
+    } else if (op == "remove") {
+        change = TodoChange::remove(QUuid::fromString(record["id"].toString()));
+    } else if (op == "clear") {
+        change = TodoChange::clear();
+    } else if (op == "epoch") {
+        epoch = record["id"].toString();
+        return JournalRecord::Epoch;
+    } else {
+        return JournalRecord::Corrupt;
+    }
+    return JournalRecord::Change;
+}
+
+/**
+ * @brief Name of the shard file of a category
+ *
+ * Category names may contain any character, so files are named after a
+ * hash of the name; the name itself is stored inside the shard.
+ */
+QString shardFileName(const QString& category)
+{
+    const QByteArray hash = QCryptographicHash::hash(category.toUtf8(), QCryptographicHash::Sha1);
+    return QString::fromLatin1(hash.toHex().left(16)) + QStringLiteral(".snapshot");
+}
+
+/**
+ * @brief Apply changes to stored items
+ *
+ * An upsert only replaces an item that was not modified later, so the
+ * result does not depend on which process saved last.
+ */
+void applyChanges(TodoStore& store, const TodoChangeList& changes)
+{
+    QHash<QUuid, int> positions;
+    positions.reserve(store.size());
+    for (int i = 0; i < store.size(); ++i) {
+        if (store.isLive(i))
+            positions.insert(store.id(i), i);
+    }
+
+    for (const TodoChange& change : changes) {
+        if (change.type == TodoChange::Type::Upsert) {
+            auto it = positions.constFind(change.id);
+            if (it == positions.constEnd()) {
+                positions.insert(change.id, store.size());
+                store.append(change.item);
+            } else if (change.item.modifiedAtMs() >= store.modifiedAtMs(it.value())) {
+                store.replace(it.value(), change.item);
+            }
+        } else if (change.type == TodoChange::Type::Remove) {
+            auto it = positions.find(change.id);
+            if (it != positions.end()) {
+                store.remove(it.value());
+                positions.erase(it);
+            }
+        } else {
+            store.clear();
+            positions.clear();
+        }
+    }
+}
+
+} // namespace
 
 /**
  * @brief Constructor implementation
@@ -18,8 +335,9 @@
 StorageManager::StorageManager(StorageBackend backend)
     : m_backend(backend)
 {
-    if (m_backend == StorageBackend::QSettingsJson) {
+    if (m_backend != StorageBackend::SQLite) {
         // Initialize QSettings with custom format
+        // (Journal and Sharded only read it to migrate existing data)
         m_settings = std::make_unique<QSettings>(
             QSettings::IniFormat,
             QSettings::UserScope,
@@ -37,7 +355,14 @@ StorageManager::StorageManager(StorageBackend backend)
  */
 StorageManager::~StorageManager()
 {
-    // Cleanup handled by smart pointers
+    // Connections of other threads are theirs to remove; one still open
+    // is removed when its thread finishes
+    releaseThreadResources();
+    QMutexLocker locker(&m_sqliteMutex);
+    for (const SqliteConnection& connection : std::as_const(m_sqliteConnections)) {
+        if (QSqlDatabase::contains(connection.name))
+            qWarning() << "SQLite connection" << connection.name << "outlives its storage manager";
+    }
 }
 
 /**
@@ -45,17 +370,50 @@ StorageManager::~StorageManager()
  */
 bool StorageManager::saveTodos(const QVector<TodoItem>& todos)
 {
+    QLockFile lock(getLockPath());
+    if (!lockSharedFiles(lock))
+        return false;
+
     switch (m_backend) {
         case StorageBackend::QSettingsJson:
             return saveWithQSettings(todos);
+        case StorageBackend::Journal:
+            catchUpJournal();
+            return compactJournal(withExternalChanges(todos));
         case StorageBackend::SQLite:
             return saveWithSQLite(todos);
+        case StorageBackend::Sharded:
+            return saveShards(todos);
         default:
             qWarning() << "Unknown storage backend";
             return false;
     }
 }
 
+/**
+ * @brief Save a set of changes to storage
+ */
+bool StorageManager::saveChanges(const TodoChangeList& changes, const TodoStore& snapshot)
+{
+    if (changes.isEmpty())
+        return true;
+
+    QLockFile lock(getLockPath());
+    if (!lockSharedFiles(lock))
+        return false;
+
+    if (m_backend == StorageBackend::Journal)
+        return appendToJournal(changes, snapshot);
+
+    if (m_backend == StorageBackend::SQLite)
+        return applyChangesWithSQLite(changes);
+
+    if (m_backend == StorageBackend::Sharded)
+        return saveShardChanges(changes);
+
+    return saveTodos(snapshot.toItems());
+}
+
 /**
  * @brief Load todos from storage
  */
@@ -64,39 +422,315 @@ QVector<TodoItem> StorageManager::loadTodos()
     switch (m_backend) {
         case StorageBackend::QSettingsJson:
             return loadWithQSettings();
+        case StorageBackend::Journal: {
+            QLockFile lock(getLockPath());
+            if (!lockSharedFiles(lock))
+                return QVector<TodoItem>();
+            m_externalChanges.clear();
+            return loadWithJournal().toItems();
+        }
         case StorageBackend::SQLite:
             return loadWithSQLite();
+        case StorageBackend::Sharded:
+            return loadStore().toItems();
         default:
             qWarning() << "Unknown storage backend";
             return QVector<TodoItem>();
     }
 }
 
+/**
+ * @brief Load todos into column storage
+ */
+TodoStore StorageManager::loadStore(const QStringList& categories)
+{
+    if (m_backend != StorageBackend::Journal && m_backend != StorageBackend::Sharded)
+        return TodoStore(loadTodos());
+
+    QLockFile lock(getLockPath());
+    if (!lockSharedFiles(lock))
+        return TodoStore();
+
+    // The caller drops what it held before, and what it is about to get
+    // includes what other processes saved
+    m_externalChanges.clear();
+    if (m_backend == StorageBackend::Journal)
+        return loadWithJournal();
+
+    m_shardOfId.clear();
+    m_loadedShards.clear();
+    m_storedModified.clear();
+    m_shardGenerations.clear();
+    m_indexGeneration = -1;
+    m_loadedAllShards = categories.isEmpty();
+    return readShards(categories);
+}
+
+/**
+ * @brief Load additional shards
+ */
+TodoStore StorageManager::loadShards(const QStringList& categories)
+{
+    if (m_backend != StorageBackend::Sharded || categories.isEmpty())
+        return TodoStore();
+
+    QLockFile lock(getLockPath());
+    if (!lockSharedFiles(lock))
+        return TodoStore();
+
+    return readShards(categories);
+}
+
+/**
+ * @brief Get per-category counts from the shard index
+ */
+QVector<StorageManager::CategorySummary> StorageManager::categorySummaries() const
+{
+    if (m_backend != StorageBackend::Sharded)
+        return QVector<CategorySummary>();
+
+    return readShardIndex();
+}
+
+/**
+ * @brief Read what other processes saved since the last look
+ *
+ * Writes catch up as well and stash what they find, so this also
+ * returns changes picked up by saves since the last call.
+ */
+TodoChangeList StorageManager::readExternalChanges()
+{
+    if (m_backend != StorageBackend::Journal && m_backend != StorageBackend::Sharded)
+        return TodoChangeList();
+
+    QLockFile lock(getLockPath());
+    if (!lockSharedFiles(lock))
+        return TodoChangeList();
+
+    if (m_backend == StorageBackend::Journal) {
+        catchUpJournal();
+    } else {
+        qint64 generation = 0;
+        const QVector<CategorySummary> index = readShardIndex(&generation);
+        catchUpShards(index, generation);
+    }
+    return std::exchange(m_externalChanges, {});
+}
+
+/**
+ * @brief Get the paths to watch for saves by other processes
+ *
+ * Snapshots and the shard index are replaced by renaming, which only
+ * their directory reports; journal appends are only reported by the
+ * journal itself.
+ */
+QStringList StorageManager::watchedPaths() const
+{
+    QStringList paths;
+    if (m_backend == StorageBackend::Journal) {
+        paths = {QFileInfo(getJournalPath()).absolutePath(), getJournalPath()};
+    } else if (m_backend == StorageBackend::Sharded) {
+        paths = {getShardDirectory()};
+    }
+
+    paths.erase(std::remove_if(paths.begin(), paths.end(),
+                               [](const QString& path) { return !QFileInfo::exists(path); }),
+                paths.end());
+    return paths;
+}
+
+/**
+ * @brief Take the lock shared with other processes
+ *
+ * A lock left by a crashed process counts as stale and is taken over.
+ */
+bool StorageManager::lockSharedFiles(QLockFile& lock) const
+{
+    if (m_backend != StorageBackend::Journal && m_backend != StorageBackend::Sharded)
+        return true;
+
+    QDir().mkpath(QFileInfo(getLockPath()).absolutePath());
+    if (!lock.tryLock(kLockTimeoutMs)) {
+        qWarning() << "Failed to lock storage:" << getLockPath();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Record changes this manager wrote
+ *
+ * An upsert older than the stored item changed nothing, since the later
+ * edit wins; the stash still delivers the stored one. Otherwise the
+ * write settles the item and stashed changes of it are dropped.
+ */
+void StorageManager::recordOwnChanges(const TodoChangeList& changes)
+{
+    QSet<QUuid> settled;
+    for (const TodoChange& change : changes) {
+        switch (change.type) {
+            case TodoChange::Type::Upsert: {
+                auto stored = m_storedModified.find(change.id);
+                if (stored == m_storedModified.end()) {
+                    m_storedModified.insert(change.id, change.item.modifiedAtMs());
+                } else if (stored.value() <= change.item.modifiedAtMs()) {
+                    stored.value() = change.item.modifiedAtMs();
+                } else {
+                    continue;
+                }
+                settled.insert(change.id);
+                break;
+            }
+            case TodoChange::Type::Remove:
+                m_storedModified.remove(change.id);
+                settled.insert(change.id);
+                break;
+            case TodoChange::Type::Clear:
+                m_storedModified.clear();
+                m_externalChanges.clear();
+                settled.clear();
+                break;
+        }
+    }
+
+    if (settled.isEmpty() || m_externalChanges.isEmpty())
+        return;
+
+    m_externalChanges.erase(std::remove_if(m_externalChanges.begin(), m_externalChanges.end(),
+                                           [&settled](const TodoChange& change) {
+                                               return settled.contains(change.id);
+                                           }),
+                            m_externalChanges.end());
+}
+
+/**
+ * @brief Apply the stashed changes of other processes to a complete list
+ */
+QVector<TodoItem> StorageManager::withExternalChanges(const QVector<TodoItem>& todos) const
+{
+    if (m_externalChanges.isEmpty())
+        return todos;
+
+    TodoStore store(todos);
+    applyChanges(store, m_externalChanges);
+    return store.toItems();
+}
+
 /**
  * @brief Clear all stored data
  */
 bool StorageManager::clearStorage()
 {
+    // The statistics history goes with the data it describes
+    if (QFile::exists(getStatisticsPath()) && !QFile::remove(getStatisticsPath())) {
+        qWarning() << "Failed to remove" << getStatisticsPath();
+    }
+
     if (m_backend == StorageBackend::QSettingsJson && m_settings) {
+        const bool ok = removeQSettingsData();
         m_settings->clear();
         m_settings->sync();
-        return true;
+        return ok;
+    } else if (m_backend == StorageBackend::Journal || m_backend == StorageBackend::Sharded) {
+        QLockFile lock(getLockPath());
+        if (!lockSharedFiles(lock))
+            return false;
+
+        // Shards are migrated from the journal, so its files go as well
+        bool ok = m_backend != StorageBackend::Sharded || removeShards();
+        for (const QString& path : {getSnapshotPath(), getLegacySnapshotPath(), getJournalPath()}) {
+            if (QFile::exists(path) && !QFile::remove(path)) {
+                qWarning() << "Failed to remove" << path;
+                ok = false;
+            }
+        }
+        // Drop migrated legacy data so it is not imported again
+        if (!removeQSettingsData()) {
+            ok = false;
+        }
+        m_journalEntries = 0;
+        m_snapshotCount = 0;
+        m_journalOffset = 0;
+        m_journalEpoch.clear();
+        m_journalShared = false;
+        m_shardOfId.clear();
+        m_loadedShards.clear();
+        m_storedModified.clear();
+        m_externalChanges.clear();
+        m_shardGenerations.clear();
+        m_indexGeneration = -1;
+        return ok;
     } else if (m_backend == StorageBackend::SQLite) {
-        // For SQLite, just save an empty list
-        return saveTodos(QVector<TodoItem>());
+        return applyChangesWithSQLite({TodoChange::clear()});
     }
     return false;
 }
 
+/**
+ * @brief Save the statistics history
+ */
+bool StorageManager::saveStatistics(const TodoStatistics& statistics)
+{
+    QDir().mkpath(QFileInfo(getStatisticsPath()).absolutePath());
+    QSaveFile file(getStatisticsPath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to open statistics file:" << file.fileName();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << kStatisticsMagic << kStatisticsVersion;
+    statistics.writeHistory(stream);
+    if (stream.status() != QDataStream::Ok || !file.commit()) {
+        qWarning() << "Failed to write statistics file:" << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Load the statistics history
+ */
+bool StorageManager::loadStatistics(TodoStatistics& statistics)
+{
+    statistics.clearHistory();
+
+    QFile file(getStatisticsPath());
+    if (!file.exists()) {
+        return true;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open statistics file:" << file.fileName();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+    if (magic != kStatisticsMagic || version == 0 || version > kStatisticsVersion
+        || !statistics.readHistory(stream)) {
+        qWarning() << "Ignoring damaged statistics file:" << file.fileName();
+        return false;
+    }
+    return true;
+}
+
 /**
  * @brief Get storage file path
  */
 QString StorageManager::getStoragePath() const
 {
     if (m_backend == StorageBackend::QSettingsJson && m_settings) {
-        return m_settings->fileName();
+        return getDataFilePath(m_compression);
+    } else if (m_backend == StorageBackend::Journal) {
+        return getJournalPath();
     } else if (m_backend == StorageBackend::SQLite) {
         return getSQLitePath();
+    } else if (m_backend == StorageBackend::Sharded) {
+        return getShardIndexPath();
     }
     return QString();
 }
@@ -108,8 +742,12 @@ bool StorageManager::isStorageAvailable() const
 {
     if (m_backend == StorageBackend::QSettingsJson && m_settings) {
         return m_settings->isWritable();
+    } else if (m_backend == StorageBackend::Journal) {
+        return QFileInfo(QFileInfo(getJournalPath()).absolutePath()).isWritable();
     } else if (m_backend == StorageBackend::SQLite) {
         return QFile::exists(getSQLitePath());
+    } else if (m_backend == StorageBackend::Sharded) {
+        return QFileInfo(QFileInfo(getShardDirectory()).absolutePath()).isWritable();
     }
     return false;
 }
@@ -121,8 +759,19 @@ int StorageManager::getStoredCount() const
 {
     if (m_backend == StorageBackend::QSettingsJson && m_settings) {
         return m_settings->value("todos/count", 0).toInt();
+    } else if (m_backend == StorageBackend::SQLite) {
+        QSqlQuery query(sqliteConnection(getSQLitePath()));
+        if (query.exec("SELECT COUNT(*) FROM todos") && query.next()) {
+            return query.value(0).toInt();
+        }
+    } else if (m_backend == StorageBackend::Sharded && QFile::exists(getShardIndexPath())) {
+        int count = 0;
+        for (const CategorySummary& summary : readShardIndex()) {
+            count += summary.count;
+        }
+        return count;
     }
-    // For other backends, would need to query the storage
+    // The journal only knows its count after replaying
     return -1;
 }
 
@@ -131,30 +780,7 @@ int StorageManager::getStoredCount() const
  */
 bool StorageManager::exportToJson(const QString& filePath, const QVector<TodoItem>& todos)
 {
-    QJsonArray todoArray;
-    for (const auto& todo : todos) {
-        todoArray.append(todo.toJson());
-    }
-
-    QJsonObject root;
-    root["version"] = "1.0";
-    root["count"] = todos.size();
-    root["exportDate"] = QDateTime::currentDateTime().toString(Qt::ISODate);
-    root["todos"] = todoArray;
-
-    QJsonDocument doc(root);
-
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qWarning() << "Failed to open file for export:" << filePath;
-        return false;
-    }
-
-    file.write(doc.toJson(QJsonDocument::Indented));
-    file.close();
-
-    qDebug() << "Exported" << todos.size() << "todos to" << filePath;
-    return true;
+    return TodoExporter::exportStore(filePath, TodoStore(todos), TodoExporter::Format::Json);
 }
 
 /**
@@ -165,39 +791,18 @@ QVector<TodoItem> StorageManager::importFromJson(const QString& filePath)
     QVector<TodoItem> todos;
 
     QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    if (!file.open(QIODevice::ReadOnly)) {
         qWarning() << "Failed to open file for import:" << filePath;
         return todos;
     }
 
-    QByteArray data = file.readAll();
-    file.close();
-
-    QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
-
-    if (parseError.error != QJsonParseError::NoError) {
-        qWarning() << "JSON parse error:" << parseError.errorString();
-        return todos;
-    }
-
-    if (!doc.isObject()) {
-        qWarning() << "Invalid JSON format: root is not an object";
-        return todos;
-    }
-
-    QJsonObject root = doc.object();
-    if (!root.contains("todos") || !root["todos"].isArray()) {
-        qWarning() << "Invalid JSON format: missing 'todos' array";
-        return todos;
-    }
+    // Decode element by element instead of parsing the whole document,
+    // so only the result grows with the file
+    TodoJsonReader reader(&file);
+    reader.readBatch(todos, std::numeric_limits<int>::max());
 
-    QJsonArray todoArray = root["todos"].toArray();
-    for (const QJsonValue& value : todoArray) {
-        if (value.isObject()) {
-            TodoItem item = TodoItem::fromJson(value.toObject());
-            todos.append(item);
-        }
+    if (reader.hasError()) {
+        return QVector<TodoItem>();
     }
 
     qDebug() << "Imported" << todos.size() << "todos from" << filePath;
@@ -214,22 +819,38 @@ bool StorageManager::saveWithQSettings(const QVector<TodoItem>& todos)
         return false;
     }
 
-    // Convert todos to JSON
-    QJsonArray todoArray;
-    for (const auto& todo : todos) {
-        todoArray.append(todo.toJson());
+    const QByteArray json = encodeTodoArray(todos);
+    const QString path = getDataFilePath(m_compression);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    // QSaveFile replaces the data file atomically; the metadata below is
+    // only updated once the new file is in place
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to open data file:" << file.fileName();
+        return false;
     }
 
-    QJsonDocument doc(todoArray);
-    QString jsonString = QString::fromUtf8(doc.toJson(QJsonDocument::Compact));
+    const qint64 bytes = m_compression == Compression::Zlib ? writeCompressed(file, json)
+                                                              : file.write(json);
+    if (!file.commit()) {
+        qWarning() << "Failed to write data file:" << file.errorString();
+        return false;
+    }
 
-    // Save to QSettings
-    m_settings->setValue("todos/data", jsonString);
+    // QSettings keeps only small metadata values, so sync() stays cheap
+    m_settings->remove("todos/data");
+    m_settings->setValue("todos/file", QFileInfo(path).fileName());
     m_settings->setValue("todos/count", todos.size());
-    m_settings->setValue("todos/lastModified", QDateTime::currentDateTime().toString(Qt::ISODate));
+    m_settings->setValue("todos/bytes", bytes);
+    m_settings->setValue("todos/lastModified", Timestamp::toIso(Timestamp::now()));
     m_settings->sync();
 
-    qDebug() << "Saved" << todos.size() << "todos to" << m_settings->fileName();
+    // Drop the file written with the other compression setting
+    const Compression other = m_compression == Compression::Zlib ? Compression::None : Compression::Zlib;
+    QFile::remove(getDataFilePath(other));
+
+    qDebug() << "Saved" << todos.size() << "todos (" << bytes << "bytes) to" << path;
     return m_settings->status() == QSettings::NoError;
 }
 
@@ -245,97 +866,1164 @@ QVector<TodoItem> StorageManager::loadWithQSettings()
         return todos;
     }
 
-    QString jsonString = m_settings->value("todos/data", "").toString();
-    if (jsonString.isEmpty()) {
-        qDebug() << "No stored todos found";
-        return todos;
+    const QString fileName = m_settings->value("todos/file").toString();
+    if (fileName.isEmpty()) {
+        // Versions before the data file embedded the JSON in the INI file;
+        // the next save moves it out
+        QString jsonString = m_settings->value("todos/data", "").toString();
+        if (jsonString.isEmpty()) {
+            qDebug() << "No stored todos found";
+            return todos;
+        }
+        return parseTodoArray(jsonString.toUtf8(), m_settings->fileName());
     }
 
-    QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(jsonString.toUtf8(), &parseError);
+    const QString path = QFileInfo(getDataFilePath(Compression::None)).dir()
+                             .filePath(QFileInfo(fileName).fileName());
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open data file:" << path;
+        return todos;
+    }
 
-    if (parseError.error != QJsonParseError::NoError) {
-        qWarning() << "Failed to parse stored JSON:" << parseError.errorString();
+    const qint64 size = file.size();
+    if (size == 0) {
         return todos;
     }
 
-    if (!doc.isArray()) {
-        qWarning() << "Invalid stored data format";
+    uchar* data = file.map(0, size);
+    if (!data) {
+        qWarning() << "Failed to map data file:" << file.errorString();
         return todos;
     }
 
-    QJsonArray todoArray = doc.array();
-    for (const QJsonValue& value : todoArray) {
-        if (value.isObject()) {
-            TodoItem item = TodoItem::fromJson(value.toObject());
-            todos.append(item);
+    if (isCompressed(data, size)) {
+        QByteArray json;
+        if (uncompressBlocks(data, size, json)) {
+            todos = parseTodoArray(json, path);
+        } else {
+            qWarning() << "Corrupt compressed data file:" << path;
         }
+    } else {
+        // Parse straight from the mapping without copying the file
+        todos = parseTodoArray(QByteArray::fromRawData(reinterpret_cast<const char*>(data), size), path);
     }
 
-    qDebug() << "Loaded" << todos.size() << "todos from" << m_settings->fileName();
+    file.unmap(data);
     return todos;
 }
 
+/**
+ * @brief Remove the QSettingsJson data files and their metadata
+ */
+bool StorageManager::removeQSettingsData()
+{
+    bool ok = true;
+    for (Compression compression : {Compression::None, Compression::Zlib}) {
+        const QString path = getDataFilePath(compression);
+        if (QFile::exists(path) && !QFile::remove(path)) {
+            qWarning() << "Failed to remove" << path;
+            ok = false;
+        }
+    }
+
+    if (m_settings) {
+        m_settings->remove("todos");
+        m_settings->sync();
+    }
+    return ok;
+}
+
+/**
+ * @brief Get the QSettingsJson data file path
+ */
+QString StorageManager::getDataFilePath(Compression compression) const
+{
+    QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return dataPath + (compression == Compression::Zlib ? "/todos.json.qz" : "/todos.json");
+}
+
+/**
+ * @brief Append changes to the journal
+ *
+ * Each change becomes one line in the journal file, so the cost of a save
+ * depends on the size of the change rather than the size of the list.
+ * The appended lines are synced to the disk before the save reports
+ * success, once per call however many changes it holds.
+ * Once the journal holds more records than the snapshot holds items, it is
+ * folded into a new snapshot, keeping the amortized cost per change constant.
+ *
+ * Records other processes appended since the last look are read first.
+ * @p snapshot lacks them, so once there are any, compaction snapshots the
+ * replayed journal instead. Only compaction turns @p snapshot into items.
+ */
+bool StorageManager::appendToJournal(const TodoChangeList& changes, const TodoStore& snapshot)
+{
+    catchUpJournal();
+
+    const bool compact = m_journalEntries + changes.size() > qMax(kMinJournalEntries, m_snapshotCount);
+    if (compact && !m_journalShared) {
+        recordOwnChanges(changes);
+        return compactJournal(snapshot.toItems());
+    }
+
+    QDir().mkpath(QFileInfo(getJournalPath()).absolutePath());
+
+    QFile file(getJournalPath());
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "Failed to open journal:" << file.fileName();
+        return false;
+    }
+
+    // A journal started here, after a clear, gets an epoch of its own too
+    QByteArray buffer;
+    QString epoch = m_journalEpoch;
+    if (file.size() == 0) {
+        epoch = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        buffer.append(epochRecord(epoch));
+    }
+    for (const auto& change : changes) {
+        buffer.append(journalRecord(change));
+    }
+
+    // One sync per save: a record is reported as saved only once it is
+    // on the disk
+    if (file.write(buffer) != buffer.size() || !file.flush() || !syncToDisk(file)) {
+        qWarning() << "Failed to append to journal:" << file.errorString();
+        return false;
+    }
+
+    m_journalEntries += changes.size();
+    m_journalOffset = file.size();
+    m_journalEpoch = epoch;
+    recordOwnChanges(changes);
+
+    if (compact) {
+        return compactJournal(loadWithJournal().toItems());
+    }
+    return true;
+}
+
+/**
+ * @brief Write a new snapshot and start a new journal
+ *
+ * The new journal starts with a fresh epoch id, which tells other
+ * processes that the records they read are gone.
+ */
+bool StorageManager::compactJournal(const QVector<TodoItem>& todos)
+{
+    QDir().mkpath(QFileInfo(getSnapshotPath()).absolutePath());
+
+    // The snapshot is replaced atomically, so a crash never leaves a
+    // half-written snapshot next to an already truncated journal
+    if (!TodoSnapshot::write(getSnapshotPath(), todos)) {
+        return false;
+    }
+
+    // The binary snapshot supersedes one left by an older version
+    QFile::remove(getLegacySnapshotPath());
+
+    const QString epoch = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    const QByteArray header = epochRecord(epoch);
+    QFile journal(getJournalPath());
+    if (!journal.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        || journal.write(header) != header.size() || !journal.flush() || !syncToDisk(journal)) {
+        qWarning() << "Failed to truncate journal:" << journal.fileName();
+        return false;
+    }
+
+    m_journalEntries = 0;
+    m_snapshotCount = todos.size();
+    m_journalOffset = header.size();
+    m_journalEpoch = epoch;
+    m_journalShared = false;
+    m_storedModified.clear();
+    m_storedModified.reserve(todos.size());
+    for (const TodoItem& todo : todos) {
+        m_storedModified.insert(todo.getUuid(), todo.modifiedAtMs());
+    }
+
+    qDebug() << "Compacted journal into snapshot of" << todos.size() << "todos";
+    return true;
+}
+
+/**
+ * @brief Load the snapshot and replay the journal
+ */
+TodoStore StorageManager::loadWithJournal()
+{
+    TodoStore store;
+    m_storedModified.clear();
+    m_journalOffset = 0;
+    m_journalEpoch.clear();
+    m_journalShared = false;
+
+    QFile journal(getJournalPath());
+    const bool hasSnapshot = QFile::exists(getSnapshotPath());
+    const bool hasLegacySnapshot = QFile::exists(getLegacySnapshotPath());
+
+    if (!hasSnapshot && !hasLegacySnapshot && !journal.exists()) {
+        // First run with this backend: migrate data saved by QSettingsJson
+        const QVector<TodoItem> todos = loadWithQSettings();
+        if (!todos.isEmpty()) {
+            compactJournal(todos);
+        }
+        return TodoStore(todos);
+    }
+
+    if (hasSnapshot) {
+        TodoSnapshot::read(getSnapshotPath(), store);
+    } else if (hasLegacySnapshot) {
+        // Snapshot written by a version that predates the binary format;
+        // the next compaction replaces it
+        QFile snapshot(getLegacySnapshotPath());
+        if (snapshot.open(QIODevice::ReadOnly)) {
+            QJsonParseError parseError;
+            QJsonDocument doc = QJsonDocument::fromJson(snapshot.readAll(), &parseError);
+
+            if (parseError.error != QJsonParseError::NoError || !doc.isArray()) {
+                qWarning() << "Failed to parse snapshot:" << parseError.errorString();
+            } else {
+                const QJsonArray todoArray = doc.array();
+                store.reserve(todoArray.size());
+                for (const QJsonValue& value : todoArray) {
+                    if (value.isObject()) {
+                        store.append(TodoItem::fromJson(value.toObject()));
+                    }
+                }
+            }
+        }
+    }
+
+    m_snapshotCount = store.size();
+    m_journalEntries = 0;
+
+    if (journal.open(QIODevice::ReadOnly) && journal.size() > 0) {
+        // Replay the journal. Removed items are only tombstoned here and
+        // dropped in one pass at the end, so replay stays linear in the
+        // journal length.
+        QHash<QUuid, int> positions;
+        positions.reserve(store.size());
+        for (int i = 0; i < store.size(); ++i) {
+            positions.insert(store.id(i), i);
+        }
+
+        TodoChange change;
+        while (!journal.atEnd()) {
+            const QByteArray line = journal.readLine().trimmed();
+            if (line.isEmpty() || parseJournalRecord(line, change, m_journalEpoch) != JournalRecord::Change)
+                continue;
+
+            ++m_journalEntries;
+            if (change.type == TodoChange::Type::Upsert) {
+                // Processes append in the order they save, not in the
+                // order they edited; the later edit wins
+                auto it = positions.constFind(change.id);
+                if (it == positions.constEnd()) {
+                    positions.insert(change.id, store.size());
+                    store.append(change.item);
+                } else if (change.item.modifiedAtMs() >= store.modifiedAtMs(it.value())) {
+                    store.replace(it.value(), change.item);
+                }
+            } else if (change.type == TodoChange::Type::Remove) {
+                auto it = positions.find(change.id);
+                if (it != positions.end()) {
+                    store.remove(it.value());
+                    positions.erase(it);
+                }
+            } else {
+                store.clear();
+                positions.clear();
+            }
+        }
+        m_journalOffset = journal.pos();
+        store.compact();
+    }
+
+    m_storedModified.reserve(store.size());
+    for (int i = 0; i < store.size(); ++i) {
+        m_storedModified.insert(store.id(i), store.modifiedAtMs(i));
+    }
+
+    qDebug() << "Loaded" << store.size() << "todos from journal" << journal.fileName()
+             << "(" << m_journalEntries << "records replayed)";
+    return store;
+}
+
+/**
+ * @brief Stash what other processes appended to the journal
+ *
+ * Usually only the bytes after m_journalOffset are read. A different
+ * epoch, or a journal shorter than what was read, means another process
+ * compacted or cleared it; then the whole list is read and compared
+ * with the stored modification times.
+ */
+void StorageManager::catchUpJournal()
+{
+    QFile journal(getJournalPath());
+    QString epoch;
+    if (journal.open(QIODevice::ReadOnly) && journal.size() > 0) {
+        TodoChange change;
+        parseJournalRecord(journal.readLine().trimmed(), change, epoch);
+    }
+    const qint64 size = journal.isOpen() ? journal.size() : 0;
+
+    if (epoch == m_journalEpoch && size >= m_journalOffset) {
+        if (size == m_journalOffset)
+            return;
+
+        journal.seek(m_journalOffset);
+        TodoChange change;
+        while (!journal.atEnd()) {
+            const QByteArray line = journal.readLine().trimmed();
+            if (line.isEmpty() || parseJournalRecord(line, change, epoch) != JournalRecord::Change)
+                continue;
+
+            ++m_journalEntries;
+            m_journalShared = true;
+            switch (change.type) {
+                case TodoChange::Type::Upsert: {
+                    auto stored = m_storedModified.find(change.id);
+                    if (stored == m_storedModified.end()) {
+                        m_storedModified.insert(change.id, change.item.modifiedAtMs());
+                    } else if (stored.value() <= change.item.modifiedAtMs()) {
+                        stored.value() = change.item.modifiedAtMs();
+                    } else {
+                        break;
+                    }
+                    m_externalChanges.append(change);
+                    break;
+                }
+                case TodoChange::Type::Remove:
+                    if (m_storedModified.remove(change.id) > 0)
+                        m_externalChanges.append(change);
+                    break;
+                case TodoChange::Type::Clear:
+                    for (auto it = m_storedModified.cbegin(); it != m_storedModified.cend(); ++it) {
+                        m_externalChanges.append(TodoChange::remove(it.key()));
+                    }
+                    m_storedModified.clear();
+                    break;
+            }
+        }
+        m_journalOffset = journal.pos();
+        return;
+    }
+
+    // Another process compacted or cleared the journal
+    journal.close();
+    const QHash<QUuid, qint64> known = std::exchange(m_storedModified, {});
+    const TodoStore stored = loadWithJournal();
+    for (int i = 0; i < stored.size(); ++i) {
+        auto it = known.constFind(stored.id(i));
+        if (it == known.cend() || it.value() != stored.modifiedAtMs(i))
+            m_externalChanges.append(TodoChange::upsert(stored.item(i)));
+    }
+    for (auto it = known.cbegin(); it != known.cend(); ++it) {
+        if (!m_storedModified.contains(it.key()))
+            m_externalChanges.append(TodoChange::remove(it.key()));
+    }
+
+    // The caller may not have merged what was read before, so the next
+    // compaction must not trust its list
+    m_journalShared = true;
+}
+
+/**
+ * @brief Get journal snapshot path
+ */
+QString StorageManager::getSnapshotPath() const
+{
+    QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return dataPath + "/todos.snapshot";
+}
+
+/**
+ * @brief Get legacy JSON snapshot path
+ */
+QString StorageManager::getLegacySnapshotPath() const
+{
+    QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return dataPath + "/todos.snapshot.json";
+}
+
+/**
+ * @brief Get journal log path
+ */
+QString StorageManager::getJournalPath() const
+{
+    QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return dataPath + "/todos.journal";
+}
+
+/**
+ * @brief Get the lock file path
+ *
+ * The lock lives in a directory of its own, so taking it does not
+ * wake the watchers of the data directory.
+ */
+QString StorageManager::getLockPath() const
+{
+    QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return dataPath + "/locks/todos.lock";
+}
+
+/**
+ * @brief Get statistics file path
+ */
+QString StorageManager::getStatisticsPath() const
+{
+    QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return dataPath + "/todos.stats";
+}
+
+/**
+ * @brief Read shards, migrating journal data on first use
+ *
+ * Loading every shard also picks up shards the index does not list: a
+ * new shard is written before the index, so a crash in between leaves
+ * one behind.
+ */
+TodoStore StorageManager::readShards(const QStringList& categories)
+{
+    if (!QFile::exists(getShardIndexPath())) {
+        // First run with this backend: migrate data saved by the journal,
+        // which in turn migrates data saved by QSettingsJson
+        // Every item goes to a new shard, none of which the caller holds yet
+        const QVector<TodoItem> todos = loadWithJournal().toItems();
+        const QHash<QUuid, QString> known = std::exchange(m_shardOfId, {});
+        const QSet<QString> loaded = std::exchange(m_loadedShards, {});
+        const QHash<QUuid, qint64> stored = std::exchange(m_storedModified, {});
+        if (!saveShards(todos)) {
+            qWarning() << "Failed to migrate todos into shards";
+        }
+        m_shardOfId = known;
+        m_loadedShards = loaded;
+        m_storedModified = stored;
+    }
+
+    qint64 generation = 0;
+    QVector<CategorySummary> index = readShardIndex(&generation);
+    QStringList wanted = categories;
+    if (wanted.isEmpty()) {
+        for (const CategorySummary& summary : std::as_const(index)) {
+            wanted.append(summary.category);
+        }
+    }
+
+    QHash<QString, qint64> generations;
+    for (const CategorySummary& summary : std::as_const(index)) {
+        generations.insert(summary.category, summary.generation);
+    }
+
+    TodoStore store;
+    auto readShard = [this, &store, &generations](const QString& path, const QString& category) {
+        TodoStore shard;
+        if (!TodoSnapshot::read(path, shard)) {
+            // Not marked as loaded, so saves merge into it instead of
+            // replacing it
+            return false;
+        }
+        for (int i = 0; i < shard.size(); ++i) {
+            m_shardOfId.insert(shard.id(i), category);
+            m_storedModified.insert(shard.id(i), shard.modifiedAtMs(i));
+        }
+        m_loadedShards.insert(category);
+        m_shardGenerations.insert(category, generations.value(category));
+        store.append(shard);
+        return true;
+    };
+
+    for (const QString& category : std::as_const(wanted)) {
+        const QString path = getShardPath(category);
+        if (QFile::exists(path)) {
+            readShard(path, category);
+        } else {
+            m_loadedShards.insert(category);
+        }
+    }
+
+    if (categories.isEmpty()) {
+        QSet<QString> listed;
+        for (const QString& category : std::as_const(wanted)) {
+            listed.insert(shardFileName(category));
+        }
+
+        const QDir dir(getShardDirectory());
+        bool repaired = false;
+        for (const QString& fileName : dir.entryList({QStringLiteral("*.snapshot")}, QDir::Files)) {
+            TodoStore shard;
+            if (listed.contains(fileName) || !TodoSnapshot::read(dir.filePath(fileName), shard) || shard.size() == 0)
+                continue;
+
+            const QString category = shard.category(0);
+            qWarning() << "Recovering shard missing from the index:" << category;
+            if (readShard(dir.filePath(fileName), category)) {
+                CategorySummary summary;
+                summary.category = category;
+                summary.count = shard.liveCount();
+                summary.completed = shard.countCompleted();
+                index.append(summary);
+                repaired = true;
+            }
+        }
+        if (repaired) {
+            writeShardIndex(index, generation + 1);
+        } else {
+            m_indexGeneration = generation;
+        }
+    }
+
+    qDebug() << "Loaded" << store.size() << "todos from" << m_loadedShards.size() << "shards";
+    return store;
+}
+
+/**
+ * @brief Apply changes to the shards they touch
+ */
+bool StorageManager::saveShardChanges(const TodoChangeList& changes)
+{
+    // Shards other processes rewrote are read before this write, which
+    // may rewrite them again
+    qint64 generation = 0;
+    QVector<CategorySummary> index = readShardIndex(&generation);
+    catchUpShards(index, generation);
+    ++generation;
+
+    QHash<QString, TodoChangeList> touched;
+    bool ok = true;
+
+    for (const TodoChange& change : changes) {
+        switch (change.type) {
+            case TodoChange::Type::Upsert: {
+                // Another process saved a later edit, which stays where it is
+                auto stored = m_storedModified.constFind(change.id);
+                if (stored != m_storedModified.cend() && stored.value() > change.item.modifiedAtMs())
+                    break;
+
+                // An item that changed category leaves its old shard
+                const QString category = change.item.getCategory();
+                auto previous = m_shardOfId.find(change.id);
+                if (previous == m_shardOfId.end()) {
+                    m_shardOfId.insert(change.id, category);
+                } else if (previous.value() != category) {
+                    touched[previous.value()].append(TodoChange::remove(change.id));
+                    previous.value() = category;
+                }
+                touched[category].append(change);
+                break;
+            }
+            case TodoChange::Type::Remove: {
+                auto previous = m_shardOfId.find(change.id);
+                if (previous != m_shardOfId.end()) {
+                    touched[previous.value()].append(change);
+                    m_shardOfId.erase(previous);
+                }
+                break;
+            }
+            case TodoChange::Type::Clear:
+                // Changes after a clear start from empty shards
+                ok = removeShards() && ok;
+                index.clear();
+                touched.clear();
+                m_shardOfId.clear();
+                m_loadedShards.clear();
+                m_shardGenerations.clear();
+                break;
+        }
+    }
+
+    for (auto it = touched.cbegin(); it != touched.cend(); ++it) {
+        TodoStore shard;
+        const QString path = getShardPath(it.key());
+        if (QFile::exists(path) && !TodoSnapshot::read(path, shard)) {
+            // Never replace a shard that could not be read
+            ok = false;
+            continue;
+        }
+
+        applyChanges(shard, it.value());
+        ok = writeShard(it.key(), shard.toItems(), index, generation) && ok;
+    }
+
+    recordOwnChanges(changes);
+    return writeShardIndex(index, generation) && ok;
+}
+
+/**
+ * @brief Rewrite the shards of a complete list
+ */
+bool StorageManager::saveShards(const QVector<TodoItem>& todos)
+{
+    qint64 generation = 0;
+    QVector<CategorySummary> index = readShardIndex(&generation);
+    catchUpShards(index, generation);
+    ++generation;
+
+    // Loaded shards are replaced, so what other processes saved to them
+    // goes into the list first
+    const QVector<TodoItem> merged = withExternalChanges(todos);
+
+    // Group by category, keeping list order within each group
+    QHash<QString, QVector<TodoItem>> groups;
+    QStringList order;
+    QHash<QUuid, QString> current;
+    current.reserve(merged.size());
+    m_storedModified.clear();
+    m_storedModified.reserve(merged.size());
+    for (const TodoItem& todo : merged) {
+        const QString category = todo.getCategory();
+        if (!groups.contains(category))
+            order.append(category);
+        groups[category].append(todo);
+        current.insert(todo.getUuid(), category);
+        m_storedModified.insert(todo.getUuid(), todo.modifiedAtMs());
+    }
+
+    // Shards nobody loaded only get the listed items merged in, and lose
+    // those this manager saved there before that have since moved or gone
+    QHash<QString, TodoChangeList> merges;
+    for (auto it = m_shardOfId.cbegin(); it != m_shardOfId.cend(); ++it) {
+        if (m_loadedShards.contains(it.value()))
+            continue;
+        auto now = current.constFind(it.key());
+        if (now == current.cend() || now.value() != it.value())
+            merges[it.value()].append(TodoChange::remove(it.key()));
+    }
+    for (const QString& category : std::as_const(order)) {
+        if (m_loadedShards.contains(category))
+            continue;
+        TodoChangeList& changes = merges[category];
+        for (const TodoItem& todo : std::as_const(groups[category])) {
+            changes.append(TodoChange::upsert(todo));
+        }
+    }
+
+    bool ok = true;
+    for (const QString& category : std::as_const(m_loadedShards)) {
+        ok = writeShard(category, groups.value(category), index, generation) && ok;
+    }
+    for (auto it = merges.cbegin(); it != merges.cend(); ++it) {
+        TodoStore shard;
+        const QString path = getShardPath(it.key());
+        if (QFile::exists(path) && !TodoSnapshot::read(path, shard)) {
+            ok = false;
+            continue;
+        }
+
+        applyChanges(shard, it.value());
+        ok = writeShard(it.key(), shard.toItems(), index, generation) && ok;
+    }
+
+    m_shardOfId = std::move(current);
+    return writeShardIndex(index, generation) && ok;
+}
+
+/**
+ * @brief Stash what other processes wrote to loaded shards
+ *
+ * Each write stamps the shards it rewrote with the new index generation,
+ * so only shards whose stamp changed are read.
+ */
+void StorageManager::catchUpShards(const QVector<CategorySummary>& index, qint64 generation)
+{
+    if (generation == m_indexGeneration)
+        return;
+
+    QSet<QString> listed;
+    listed.reserve(index.size());
+    for (const CategorySummary& summary : index) {
+        listed.insert(summary.category);
+        auto known = m_shardGenerations.constFind(summary.category);
+        if (known != m_shardGenerations.cend() && known.value() == summary.generation)
+            continue;
+
+        if (m_loadedAllShards || m_loadedShards.contains(summary.category)) {
+            TodoStore shard;
+            const QString path = getShardPath(summary.category);
+            if (QFile::exists(path) && !TodoSnapshot::read(path, shard)) {
+                // Tried again on the next look
+                continue;
+            }
+            m_loadedShards.insert(summary.category);
+            collectShard(summary.category, shard);
+        }
+        m_shardGenerations.insert(summary.category, summary.generation);
+    }
+
+    // Shards another process emptied
+    for (auto it = m_shardGenerations.begin(); it != m_shardGenerations.end();) {
+        if (listed.contains(it.key())) {
+            ++it;
+            continue;
+        }
+        if (m_loadedShards.contains(it.key()))
+            collectShard(it.key(), TodoStore());
+        it = m_shardGenerations.erase(it);
+    }
+
+    m_indexGeneration = generation;
+}
+
+/**
+ * @brief Stash the differences between a shard and what was known of it
+ *
+ * Items are compared by modification time. Finding the items that left
+ * the shard takes a pass over the known items, once per changed shard.
+ */
+void StorageManager::collectShard(const QString& category, const TodoStore& shard)
+{
+    QSet<QUuid> present;
+    present.reserve(shard.size());
+    for (int i = 0; i < shard.size(); ++i) {
+        if (!shard.isLive(i))
+            continue;
+
+        const QUuid& id = shard.id(i);
+        present.insert(id);
+        m_shardOfId.insert(id, category);
+        auto stored = m_storedModified.find(id);
+        if (stored != m_storedModified.end() && stored.value() == shard.modifiedAtMs(i))
+            continue;
+
+        m_storedModified.insert(id, shard.modifiedAtMs(i));
+        m_externalChanges.append(TodoChange::upsert(shard.item(i)));
+    }
+
+    for (auto it = m_shardOfId.begin(); it != m_shardOfId.end();) {
+        if (it.value() != category || present.contains(it.key())) {
+            ++it;
+            continue;
+        }
+        m_storedModified.remove(it.key());
+        m_externalChanges.append(TodoChange::remove(it.key()));
+        it = m_shardOfId.erase(it);
+    }
+}
+
+/**
+ * @brief Write one shard and update its index entry
+ */
+bool StorageManager::writeShard(const QString& category, const QVector<TodoItem>& items,
+                                QVector<CategorySummary>& index, qint64 generation)
+{
+    auto entry = std::find_if(index.begin(), index.end(), [&category](const CategorySummary& summary) {
+        return summary.category == category;
+    });
+    const QString path = getShardPath(category);
+
+    if (items.isEmpty()) {
+        if (QFile::exists(path) && !QFile::remove(path)) {
+            qWarning() << "Failed to remove shard" << path;
+            return false;
+        }
+        if (entry != index.end())
+            index.erase(entry);
+        m_shardGenerations.remove(category);
+        return true;
+    }
+
+    QDir().mkpath(getShardDirectory());
+    if (!TodoSnapshot::write(path, items)) {
+        return false;
+    }
+
+    CategorySummary summary;
+    summary.category = category;
+    summary.count = items.size();
+    summary.completed = static_cast<int>(std::count_if(items.cbegin(), items.cend(),
+                                                       [](const TodoItem& item) { return item.isCompleted(); }));
+    summary.generation = generation;
+    m_shardGenerations.insert(category, generation);
+    if (entry != index.end())
+        *entry = summary;
+    else
+        index.append(summary);
+    return true;
+}
+
+/**
+ * @brief Remove every shard and the index
+ */
+bool StorageManager::removeShards()
+{
+    bool ok = true;
+    const QDir dir(getShardDirectory());
+    QStringList files = dir.entryList({QStringLiteral("*.snapshot")}, QDir::Files);
+    files.append(QFileInfo(getShardIndexPath()).fileName());
+
+    for (const QString& fileName : std::as_const(files)) {
+        const QString path = dir.filePath(fileName);
+        if (QFile::exists(path) && !QFile::remove(path)) {
+            qWarning() << "Failed to remove" << path;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief Read the shard summary index
+ */
+QVector<StorageManager::CategorySummary> StorageManager::readShardIndex(qint64* generation) const
+{
+    QVector<CategorySummary> index;
+    if (generation)
+        *generation = 0;
+
+    QFile file(getShardIndexPath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return index;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+        qWarning() << "Failed to parse shard index:" << parseError.errorString();
+        return index;
+    }
+
+    if (generation)
+        *generation = doc.object()["generation"].toInteger();
+
+    const QJsonArray shards = doc.object()["shards"].toArray();
+    index.reserve(shards.size());
+    for (const QJsonValue& value : shards) {
+        const QJsonObject shard = value.toObject();
+        CategorySummary summary;
+        summary.category = shard["category"].toString();
+        summary.count = shard["count"].toInt();
+        summary.completed = shard["completed"].toInt();
+        summary.generation = shard["generation"].toInteger();
+        index.append(summary);
+    }
+    return index;
+}
+
+/**
+ * @brief Write the shard summary index
+ */
+bool StorageManager::writeShardIndex(const QVector<CategorySummary>& index, qint64 generation)
+{
+    QJsonArray shards;
+    for (const CategorySummary& summary : index) {
+        QJsonObject shard;
+        shard["category"] = summary.category;
+        shard["file"] = shardFileName(summary.category);
+        shard["count"] = summary.count;
+        shard["completed"] = summary.completed;
+        shard["generation"] = summary.generation;
+        shards.append(shard);
+    }
+
+    QJsonObject root;
+    root["version"] = 1;
+    root["generation"] = generation;
+    root["shards"] = shards;
+
+    QDir().mkpath(getShardDirectory());
+    QSaveFile file(getShardIndexPath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to open shard index:" << file.fileName();
+        return false;
+    }
+
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    if (!file.commit()) {
+        qWarning() << "Failed to write shard index:" << file.errorString();
+        return false;
+    }
+    m_indexGeneration = generation;
+    return true;
+}
+
+/**
+ * @brief Get the shard directory
+ */
+QString StorageManager::getShardDirectory() const
+{
+    QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return dataPath + "/shards";
+}
+
+/**
+ * @brief Get the file of a category shard
+ */
+QString StorageManager::getShardPath(const QString& category) const
+{
+    return getShardDirectory() + "/" + shardFileName(category);
+}
+
+/**
+ * @brief Get the shard index path
+ */
+QString StorageManager::getShardIndexPath() const
+{
+    return getShardDirectory() + "/index.json";
+}
+
 /**
  * @brief Save using SQLite backend
- * @note This is a placeholder implementation. Full SQLite support requires QtSql module.
+ *
+ * Replaces the table contents in one transaction. Used for full saves
+ * only; regular edits go through applyChangesWithSQLite().
  */
 bool StorageManager::saveWithSQLite(const QVector<TodoItem>& todos)
 {
-    // Placeholder: Full SQLite implementation would require:
-    // 1. QtSql module linked
-    // 2. Database connection management
-    // 3. SQL queries for CRUD operations
-    // 4. Transaction handling
+    QSqlDatabase db = sqliteConnection(getSQLitePath());
+    if (!db.isOpen())
+        return false;
 
-    qWarning() << "SQLite backend not fully implemented. Falling back to JSON file.";
+    if (!db.transaction()) {
+        qWarning() << "Failed to begin transaction:" << db.lastError().text();
+        return false;
+    }
 
-    // Fallback: Save as JSON file
-    QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
-    QDir().mkpath(dataPath);
-    QString filePath = dataPath + "/todos.json";
+    QSqlQuery clear(db);
+    QSqlQuery insert(db);
+    bool ok = clear.exec("DELETE FROM todos")
+           && insert.prepare("INSERT INTO todos (id, position, title, completed, priority, "
+                             "category, created_at, modified_at) "
+                             "VALUES (?, ?, ?, ?, ?, ?, ?, ?)");
 
-    return exportToJson(filePath, todos);
+    for (int i = 0; ok && i < todos.size(); ++i) {
+        const TodoItem& todo = todos[i];
+        insert.addBindValue(todo.getUuid().toRfc4122());
+        insert.addBindValue(i);
+        insert.addBindValue(todo.getTitle());
+        insert.addBindValue(todo.isCompleted());
+        insert.addBindValue(todo.priorityValue());
+        insert.addBindValue(todo.getCategory());
+        insert.addBindValue(todo.createdAtMs());
+        insert.addBindValue(todo.modifiedAtMs());
+        ok = insert.exec();
+    }
+
+    if (!ok || !db.commit()) {
+        qWarning() << "Failed to save todos to SQLite:" << insert.lastError().text()
+                   << db.lastError().text();
+        db.rollback();
+        return false;
+    }
+
+    qDebug() << "Saved" << todos.size() << "todos to" << getSQLitePath();
+    return true;
+}
+
+/**
+ * @brief Apply changes to the SQLite database
+ *
+ * Every change becomes one UPSERT or DELETE through a prepared statement,
+ * all inside a single transaction, so a save touches only the changed rows.
+ */
+bool StorageManager::applyChangesWithSQLite(const TodoChangeList& changes)
+{
+    QSqlDatabase db = sqliteConnection(getSQLitePath());
+    if (!db.isOpen())
+        return false;
+
+    if (!db.transaction()) {
+        qWarning() << "Failed to begin transaction:" << db.lastError().text();
+        return false;
+    }
+
+    // New rows are appended after the current last position, which the
+    // position index answers without a scan; updates keep their position
+    QSqlQuery upsert(db);
+    QSqlQuery remove(db);
+    QSqlQuery clear(db);
+    bool ok = upsert.prepare("INSERT INTO todos (id, position, title, completed, priority, "
+                             "category, created_at, modified_at) "
+                             "VALUES (:id, (SELECT COALESCE(MAX(position), -1) + 1 FROM todos), "
+                             ":title, :completed, :priority, :category, :createdAt, :modifiedAt) "
+                             "ON CONFLICT(id) DO UPDATE SET "
+                             "title = excluded.title, completed = excluded.completed, "
+                             "priority = excluded.priority, category = excluded.category, "
+                             "modified_at = excluded.modified_at")
+           && remove.prepare("DELETE FROM todos WHERE id = :id");
+
+    for (int i = 0; ok && i < changes.size(); ++i) {
+        const TodoChange& change = changes[i];
+        switch (change.type) {
+            case TodoChange::Type::Upsert:
+                upsert.bindValue(":id", change.id.toRfc4122());
+                upsert.bindValue(":title", change.item.getTitle());
+                upsert.bindValue(":completed", change.item.isCompleted());
+                upsert.bindValue(":priority", change.item.priorityValue());
+                upsert.bindValue(":category", change.item.getCategory());
+                upsert.bindValue(":createdAt", change.item.createdAtMs());
+                upsert.bindValue(":modifiedAt", change.item.modifiedAtMs());
+                ok = upsert.exec();
+                break;
+            case TodoChange::Type::Remove:
+                remove.bindValue(":id", change.id.toRfc4122());
+                ok = remove.exec();
+                break;
+            case TodoChange::Type::Clear:
+                ok = clear.exec("DELETE FROM todos");
+                break;
+        }
+    }
+
+    if (!ok || !db.commit()) {
+        qWarning() << "Failed to apply changes to SQLite:" << upsert.lastError().text()
+                   << remove.lastError().text() << db.lastError().text();
+        db.rollback();
+        return false;
+    }
+
+    return true;
 }
 
 /**
  * @brief Load using SQLite backend
- * @note This is a placeholder implementation.
  */
 QVector<TodoItem> StorageManager::loadWithSQLite()
 {
-    qWarning() << "SQLite backend not fully implemented. Falling back to JSON file.";
+    QVector<TodoItem> todos;
 
-    // Fallback: Load from JSON file
-    QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
-    QString filePath = dataPath + "/todos.json";
+    QSqlDatabase db = sqliteConnection(getSQLitePath());
+    if (!db.isOpen())
+        return todos;
+
+    QSqlQuery count(db);
+    if (count.exec("SELECT COUNT(*) FROM todos") && count.next()) {
+        todos.reserve(count.value(0).toInt());
+    }
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT id, title, completed, priority, category, created_at, modified_at "
+                    "FROM todos ORDER BY position")) {
+        qWarning() << "Failed to load todos from SQLite:" << query.lastError().text();
+        return todos;
+    }
+
+    while (query.next()) {
+        int priorityValue = query.value(3).toInt();
+        if (priorityValue < 0 || priorityValue > 3) {
+            priorityValue = static_cast<int>(TodoItem::Priority::Normal);
+        }
 
-    if (QFile::exists(filePath)) {
-        return importFromJson(filePath);
+        todos.append(TodoItem(QUuid::fromRfc4122(query.value(0).toByteArray()),
+                              query.value(1).toString(),
+                              query.value(2).toBool(),
+                              static_cast<TodoItem::Priority>(priorityValue),
+                              query.value(4).toString(),
+                              query.value(5).toLongLong(),
+                              query.value(6).toLongLong()));
     }
 
-    return QVector<TodoItem>();
+    qDebug() << "Loaded" << todos.size() << "todos from" << getSQLitePath();
+    return todos;
 }
 
 /**
  * @brief Initialize SQLite database
+ *
+ * Creates the schema on first use. The primary key indexes id; the
+ * secondary indices serve ordered loading and filtering by completion,
+ * priority and category.
  */
 bool StorageManager::initializeSQLite()
 {
-    // Placeholder implementation
-    // Full implementation would:
-    // 1. Create database file if it doesn't exist
-    // 2. Create tables with proper schema
-    // 3. Create indices for performance
-    // 4. Set up foreign keys and constraints
-
     QString dbPath = getSQLitePath();
     QDir().mkpath(QFileInfo(dbPath).absolutePath());
 
+    QSqlDatabase db = sqliteConnection(dbPath);
+    if (!db.isOpen())
+        return false;
+
+    const QStringList schema = {
+        "CREATE TABLE IF NOT EXISTS todos ("
+        "  id BLOB PRIMARY KEY NOT NULL,"
+        "  position INTEGER NOT NULL,"
+        "  title TEXT NOT NULL,"
+        "  completed INTEGER NOT NULL DEFAULT 0,"
+        "  priority INTEGER NOT NULL DEFAULT 1,"
+        "  category TEXT NOT NULL DEFAULT '',"
+        "  created_at INTEGER NOT NULL,"
+        "  modified_at INTEGER NOT NULL)",
+        "CREATE INDEX IF NOT EXISTS idx_todos_position ON todos(position)",
+        "CREATE INDEX IF NOT EXISTS idx_todos_completed ON todos(completed)",
+        "CREATE INDEX IF NOT EXISTS idx_todos_priority ON todos(priority)",
+        "CREATE INDEX IF NOT EXISTS idx_todos_category ON todos(category)"
+    };
+
+    QSqlQuery query(db);
+    for (const QString& statement : schema) {
+        if (!query.exec(statement)) {
+            qWarning() << "Failed to initialize SQLite schema:" << query.lastError().text();
+            return false;
+        }
+    }
+
     qDebug() << "SQLite database path:" << dbPath;
     return true;
 }
 
+/**
+ * @brief Close what the calling thread opened through this manager
+ */
+void StorageManager::releaseThreadResources()
+{
+    QThread *thread = QThread::currentThread();
+    QMutexLocker locker(&m_sqliteMutex);
+    for (auto it = m_sqliteConnections.begin(); it != m_sqliteConnections.end();) {
+        if (it->thread == thread) {
+            QObject::disconnect(it->finished);
+            QSqlDatabase::removeDatabase(it->name);
+            it = m_sqliteConnections.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+/**
+ * @brief Get this manager's SQLite connection for the calling thread
+ */
+QSqlDatabase StorageManager::sqliteConnection(const QString& path) const
+{
+    QThread *thread = QThread::currentThread();
+    const QString name = QStringLiteral("QtTodoList-%1-%2")
+                             .arg(reinterpret_cast<quintptr>(this))
+                             .arg(reinterpret_cast<quintptr>(thread));
+
+    if (QSqlDatabase::contains(name))
+        return QSqlDatabase::database(name);
+
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", name);
+
+    // A thread that ends without releaseThreadResources() still takes its
+    // connection along, before another thread can reuse its address;
+    // finished() is emitted on that thread. The lambda only needs the
+    // name, so it may outlive the manager.
+    SqliteConnection connection;
+    connection.name = name;
+    connection.thread = thread;
+    connection.finished = QObject::connect(thread, &QThread::finished, [name]() {
+        QSqlDatabase::removeDatabase(name);
+    });
+    {
+        QMutexLocker locker(&m_sqliteMutex);
+        m_sqliteConnections.append(connection);
+    }
+
+    db.setDatabaseName(path);
+    if (!db.open()) {
+        qWarning() << "Failed to open SQLite database:" << db.lastError().text();
+        return db;
+    }
+
+    // WAL lets readers proceed during writes and turns each commit into a
+    // sequential append; NORMAL sync is durable at WAL checkpoints
+    QSqlQuery pragma(db);
+    pragma.exec("PRAGMA journal_mode=WAL");
+    pragma.exec("PRAGMA synchronous=NORMAL");
+    return db;
+}
+
 /**
  * @brief Get SQLite database path
  */
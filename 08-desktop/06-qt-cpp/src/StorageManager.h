@@ -3,7 +3,8 @@
  * @brief Storage Manager for Persistent Data
  *
  * This file defines the StorageManager class which handles persistent
- * storage of todo items using QSettings (JSON format) or SQLite database.
+ * storage of todo items using QSettings (JSON format), an append-only
+ * journal, or SQLite database.
  */
 
 #ifndef STORAGEMANAGER_H
@@ -11,20 +12,44 @@
 
 #include <QString>
 #include <QVector>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
 #include <QSettings>
+#include <QMutex>
+#include <QObject>
 #include <memory>
 #include "TodoItem.h"
+#include "TodoChange.h"
+#include "TodoStore.h"
+
+class TodoStatistics;
+class QLockFile;
+class QSqlDatabase;
+class QThread;
 
 /**
  * @class StorageManager
  * @brief Manages persistent storage of todo items
  *
  * This class provides an abstraction layer for storing and retrieving
- * todo items. It supports two storage backends:
- * 1. QSettings (JSON format) - Default, simple, cross-platform
- * 2. SQLite (QtSql) - More robust, better for large datasets
+ * todo items. It supports four storage backends:
+ * 1. QSettings (JSON format) - Default, simple, cross-platform; QSettings
+ *    holds the metadata and the items go to a separate JSON file
+ * 2. Journal - Append-only operation log compacted into a binary
+ *    snapshot, save cost proportional to the size of the change
+ * 3. SQLite (QtSql) - More robust, better for large datasets
+ * 4. Sharded - One binary snapshot per category plus a summary index,
+ *    so categories can be loaded on demand and a save rewrites only
+ *    the categories it touches
  *
  * The storage backend can be configured at compile time or runtime.
+ *
+ * The Journal and Sharded backends can be shared by several processes.
+ * Every read and write holds a lock file, a write first catches up with
+ * what other processes saved since, and items saved on both sides keep
+ * the version with the later modification time. readExternalChanges()
+ * reports what other processes changed.
  */
 class StorageManager
 {
@@ -35,7 +60,29 @@ public:
      */
     enum class StorageBackend {
         QSettingsJson,  ///< QSettings with JSON serialization
-        SQLite          ///< SQLite database (requires QtSql)
+        Journal,        ///< Append-only journal plus periodic snapshot
+        SQLite,         ///< SQLite database (requires QtSql)
+        Sharded         ///< One snapshot file per category
+    };
+
+    /**
+     * @enum Compression
+     * @brief Compression of the QSettingsJson data file
+     */
+    enum class Compression {
+        None,   ///< Plain JSON
+        Zlib    ///< JSON in independently qCompress()ed blocks
+    };
+
+    /**
+     * @struct CategorySummary
+     * @brief Item counts of one category
+     */
+    struct CategorySummary {
+        QString category;   ///< Category name
+        int count = 0;      ///< Items in the category
+        int completed = 0;  ///< Completed items in the category
+        qint64 generation = 0; ///< Index generation the shard was last written at
     };
 
     /**
@@ -56,24 +103,146 @@ public:
      */
     bool saveTodos(const QVector<TodoItem>& todos);
 
+    /**
+     * @brief Persist a set of changes
+     *
+     * Backends with incremental persistence (Journal, SQLite, Sharded)
+     * only write the changes, which carry the items they store, and
+     * leave @p snapshot alone unless the journal compacts. QSettingsJson
+     * falls back to a full save of @p snapshot.
+     *
+     * @param changes Mutations since the last save, in order
+     * @param snapshot Complete list after the changes were applied
+     * @return true if successful, false otherwise
+     */
+    bool saveChanges(const TodoChangeList& changes, const TodoStore& snapshot);
+
     /**
      * @brief Load todos from persistent storage
      * @return Vector of loaded todo items (empty if none exist)
      */
     QVector<TodoItem> loadTodos();
 
+    /**
+     * @brief Load todos into column storage
+     *
+     * The Journal and Sharded backends fill the store straight from their
+     * binary snapshots, leaving titles encoded until they are first read.
+     *
+     * With the Sharded backend only the shards of @p categories are read,
+     * and they replace any shards loaded before. Other backends always
+     * load every item.
+     *
+     * @param categories Categories to load; empty loads all of them
+     * @return Store holding the loaded todos, without removed slots
+     */
+    TodoStore loadStore(const QStringList& categories = QStringList());
+
+    /**
+     * @brief Load more shards in addition to those already loaded
+     *
+     * Only meaningful for the Sharded backend; other backends return an
+     * empty store since loadStore() already returned everything.
+     *
+     * @param categories Categories to read
+     * @return Items of those categories
+     */
+    TodoStore loadShards(const QStringList& categories);
+
+    /**
+     * @brief Get per-category counts without loading any items
+     *
+     * Read from the summary index of the Sharded backend; other backends
+     * keep no index and return an empty list.
+     *
+     * @return One entry per stored category
+     */
+    QVector<CategorySummary> categorySummaries() const;
+
+    /**
+     * @brief Check whether categories can be loaded separately
+     * @return true for the Sharded backend
+     */
+    bool isSharded() const { return m_backend == StorageBackend::Sharded; }
+
+    /**
+     * @brief Read what other processes saved since this manager last looked
+     *
+     * Only the records and shards written since are read. The result
+     * describes stored state rather than history: one upsert carrying
+     * the stored item for each item another process added or changed,
+     * and one remove for each item it removed; it never holds a Clear.
+     * With the Sharded backend only shards the caller loaded are read.
+     * Backends that cannot be shared report nothing.
+     *
+     * @return Changes since the last call, empty if there are none
+     */
+    TodoChangeList readExternalChanges();
+
+    /**
+     * @brief Get the paths to watch for saves by other processes
+     * @return Existing files and directories whose change may mean that
+     *         readExternalChanges() has something to report; empty for
+     *         backends that cannot be shared
+     */
+    QStringList watchedPaths() const;
+
+    /**
+     * @brief Close what the calling thread opened through this manager
+     *
+     * Removes the thread's SQLite connection. The destructor does this
+     * for its own thread; any other thread that used the manager calls
+     * it when done, since connections must be removed by their thread.
+     */
+    void releaseThreadResources();
+
     /**
      * @brief Clear all stored todos
      * @return true if successful, false otherwise
      */
     bool clearStorage();
 
+    /**
+     * @brief Save the statistics history
+     *
+     * The history is kept in a file of its own next to the data,
+     * whichever backend is used.
+     *
+     * @param statistics Statistics to save
+     * @return true if successful
+     */
+    bool saveStatistics(const TodoStatistics& statistics);
+
+    /**
+     * @brief Load the statistics history saved by saveStatistics()
+     * @param statistics Statistics whose history is replaced
+     * @return true if loaded or nothing was saved yet; false if the file
+     *         is damaged, in which case the history is left empty
+     */
+    bool loadStatistics(TodoStatistics& statistics);
+
     /**
      * @brief Get the current storage backend
      * @return Current storage backend type
      */
     StorageBackend getBackend() const { return m_backend; }
 
+    /**
+     * @brief Set the compression used by later QSettingsJson saves
+     *
+     * Loading detects the compression of the existing file, so this can
+     * change between runs.
+     *
+     * @param compression Compression to use
+     */
+    void setCompression(Compression compression) { m_compression = compression; }
+
+    /**
+     * @brief Get the compression used by QSettingsJson saves
+     * @return Current compression
+     */
+    Compression getCompression() const { return m_compression; }
+
     /**
      * @brief Get the storage file path
      * @return Path to storage file (or database)
@@ -110,6 +279,83 @@ public:
 private:
     StorageBackend m_backend;                  ///< Current storage backend
     std::unique_ptr<QSettings> m_settings;     ///< QSettings instance (for QSettingsJson backend)
+    int m_journalEntries = 0;                  ///< Records appended since the last snapshot
+    int m_snapshotCount = 0;                   ///< Number of items in the last snapshot
+    Compression m_compression = Compression::None; ///< Compression of QSettingsJson saves
+    QHash<QUuid, QString> m_shardOfId;         ///< Shard each item seen by this manager is stored in
+    QSet<QString> m_loadedShards;              ///< Shards the caller holds in full
+    bool m_loadedAllShards = false;            ///< The caller holds every shard, including new ones
+    QHash<QUuid, qint64> m_storedModified;     ///< Modification time of each item as last read or written
+    TodoChangeList m_externalChanges;          ///< Changes by other processes not reported yet
+    qint64 m_journalOffset = 0;                ///< Bytes of the journal read or written by this manager
+    QString m_journalEpoch;                    ///< Id of the compaction that started the journal
+    bool m_journalShared = false;              ///< The journal holds records of other processes
+    QHash<QString, qint64> m_shardGenerations; ///< Generation of each shard when last read or written
+    qint64 m_indexGeneration = -1;             ///< Generation of the shard index when last read or written
+    /**
+     * @brief SQLite connection opened by one thread
+     */
+    struct SqliteConnection {
+        QString name;                          ///< Connection name
+        QThread *thread = nullptr;             ///< Thread that opened and uses it
+        QMetaObject::Connection finished;      ///< Removes it if the thread finishes first
+    };
+
+    mutable QMutex m_sqliteMutex;              ///< Guards m_sqliteConnections
+    mutable QVector<SqliteConnection> m_sqliteConnections; ///< SQLite connections opened by this manager
+
+    /**
+     * @brief Take the lock shared with other processes
+     * @param lock Lock on getLockPath(), held until it is destroyed
+     * @return true if locked or the backend is not shared
+     */
+    bool lockSharedFiles(QLockFile& lock) const;
+
+    /**
+     * @brief Get the lock file path
+     * @return Path to the lock file, outside every watched directory
+     */
+    QString getLockPath() const;
+
+    /**
+     * @brief Stash what other processes appended to the journal
+     *
+     * Reads the records after m_journalOffset. If the journal was
+     * compacted or cleared meanwhile, reads everything and compares it
+     * with the stored modification times instead.
+     */
+    void catchUpJournal();
+
+    /**
+     * @brief Stash what other processes wrote to loaded shards
+     * @param index Shard index as read from disk
+     * @param generation Generation of @p index
+     */
+    void catchUpShards(const QVector<CategorySummary>& index, qint64 generation);
+
+    /**
+     * @brief Stash the differences between a shard and what was known of it
+     * @param category Category of the shard
+     * @param shard Items now stored in the shard
+     */
+    void collectShard(const QString& category, const TodoStore& shard);
+
+    /**
+     * @brief Record changes this manager wrote
+     *
+     * Updates the stored modification times and drops stashed changes
+     * the write superseded.
+     *
+     * @param changes Changes just written
+     */
+    void recordOwnChanges(const TodoChangeList& changes);
+
+    /**
+     * @brief Apply the stashed changes of other processes to a complete list
+     * @param todos List held by the caller
+     * @return @p todos as it will look once the caller merged the stash
+     */
+    QVector<TodoItem> withExternalChanges(const QVector<TodoItem>& todos) const;
 
     /**
      * @brief Save using QSettings backend
@@ -124,6 +370,149 @@ private:
      */
     QVector<TodoItem> loadWithQSettings();
 
+    /**
+     * @brief Remove the QSettingsJson data files and their metadata
+     * @return true if every file was removed
+     */
+    bool removeQSettingsData();
+
+    /**
+     * @brief Get the QSettingsJson data file path
+     * @param compression Compression the file is written with
+     * @return Path to the data file
+     */
+    QString getDataFilePath(Compression compression) const;
+
+    /**
+     * @brief Append changes to the journal, compacting when it grows too long
+     * @param changes Changes to append
+     * @param snapshot Complete list, written as the new snapshot on compaction
+     * @return true if successful
+     */
+    bool appendToJournal(const TodoChangeList& changes, const TodoStore& snapshot);
+
+    /**
+     * @brief Write a snapshot and start a new journal
+     * @param todos Complete list to snapshot
+     * @return true if successful
+     */
+    bool compactJournal(const QVector<TodoItem>& todos);
+
+    /**
+     * @brief Load the snapshot and replay the journal on top of it
+     * @return Loaded todos
+     */
+    TodoStore loadWithJournal();
+
+    /**
+     * @brief Get journal snapshot file path
+     * @return Path to the binary snapshot file
+     */
+    QString getSnapshotPath() const;
+
+    /**
+     * @brief Get the path of the JSON snapshot written by older versions
+     * @return Path to the legacy snapshot file
+     */
+    QString getLegacySnapshotPath() const;
+
+    /**
+     * @brief Get journal log file path
+     * @return Path to the journal file
+     */
+    QString getJournalPath() const;
+
+    /**
+     * @brief Get statistics file path
+     * @return Path to the statistics history
+     */
+    QString getStatisticsPath() const;
+
+    /**
+     * @brief Read shards, migrating journal data on first use
+     * @param categories Categories to read; empty reads every shard
+     * @return Items of the shards in index order
+     */
+    TodoStore readShards(const QStringList& categories);
+
+    /**
+     * @brief Apply changes to the shards they touch
+     *
+     * Each touched shard is read, updated and rewritten; the others are
+     * left alone, so a save costs the size of the touched categories.
+     *
+     * @param changes Changes to apply
+     * @return true if successful
+     */
+    bool saveShardChanges(const TodoChangeList& changes);
+
+    /**
+     * @brief Rewrite the shards of a complete list
+     *
+     * Shards the caller holds in full are replaced; items of any other
+     * category are merged into their shard, whose other items the
+     * caller never saw.
+     *
+     * @param todos Items held by the caller
+     * @return true if successful
+     */
+    bool saveShards(const QVector<TodoItem>& todos);
+
+    /**
+     * @brief Write one shard and update its index entry
+     * @param category Category of the shard
+     * @param items Items of the shard; empty removes the file
+     * @param index Summary index to update
+     * @param generation Generation of the index being written
+     * @return true if successful
+     */
+    bool writeShard(const QString& category, const QVector<TodoItem>& items,
+                    QVector<CategorySummary>& index, qint64 generation);
+
+    /**
+     * @brief Remove every shard and the index
+     * @return true if every file was removed
+     */
+    bool removeShards();
+
+    /**
+     * @brief Read the shard summary index
+     * @param generation Set to the generation of the index, 0 if there is none
+     * @return Index entries in shard order, empty if there is no index
+     */
+    QVector<CategorySummary> readShardIndex(qint64* generation = nullptr) const;
+
+    /**
+     * @brief Write the shard summary index
+     *
+     * Each write gets the next generation, so that other processes can
+     * tell which shards changed without reading them.
+     *
+     * @param index Index entries in shard order
+     * @param generation Generation of the index
+     * @return true if successful
+     */
+    bool writeShardIndex(const QVector<CategorySummary>& index, qint64 generation);
+
+    /**
+     * @brief Get the directory holding the shards
+     * @return Path to the shard directory
+     */
+    QString getShardDirectory() const;
+
+    /**
+     * @brief Get the file of a category shard
+     * @param category Category name
+     * @return Path to the shard snapshot
+     */
+    QString getShardPath(const QString& category) const;
+
+    /**
+     * @brief Get the shard summary index path
+     * @return Path to the index file
+     */
+    QString getShardIndexPath() const;
+
     /**
      * @brief Save using SQLite backend
      * @param todos Todos to save
@@ -131,6 +520,13 @@ private:
      */
     bool saveWithSQLite(const QVector<TodoItem>& todos);
 
+    /**
+     * @brief Apply changes as per-row UPSERT/DELETE statements
+     * @param changes Changes to apply
+     * @return true if successful
+     */
+    bool applyChangesWithSQLite(const TodoChangeList& changes);
+
     /**
      * @brief Load using SQLite backend
      * @return Loaded todos
@@ -143,6 +539,19 @@ private:
      */
     bool initializeSQLite();
 
+    /**
+     * @brief Get this manager's SQLite connection for the calling thread
+     *
+     * QSqlDatabase connections may only be used from the thread that
+     * created them, so each thread gets its own named connection to the
+     * same file. Each is removed on its own thread, by
+     * releaseThreadResources() or when the thread finishes.
+     *
+     * @param path Database file path
+     * @return Connection, not open if opening failed
+     */
+    QSqlDatabase sqliteConnection(const QString& path) const;
+
     /**
      * @brief Get SQLite database path
      * @return Path to SQLite database file
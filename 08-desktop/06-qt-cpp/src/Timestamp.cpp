@@ -0,0 +1,241 @@
+/**
+ * @file Timestamp.cpp
+ * @brief Implementation of the Timestamp helpers
+ */
+
+#include "Timestamp.h"
+
+namespace {
+
+constexpr qint64 kMsecsPerDay = 24 * 60 * 60 * 1000;
+
+/// Length of "YYYY-MM-DDTHH:MM:SS.sssZ"
+constexpr int kIsoLength = 24;
+
+/**
+ * @brief Days since 1970-01-01 of a proleptic Gregorian date
+ *
+ * Counts in 400-year eras starting in March, so leap days fall at the
+ * end of each year (H. Hinnant, "chrono-Compatible Low-Level Date
+ * Algorithms").
+ */
+qint64 daysFromCivil(qint64 year, int month, int day)
+{
+    year -= month <= 2 ? 1 : 0;
+    const qint64 era = (year >= 0 ? year : year - 399) / 400;
+    const qint64 yearOfEra = year - era * 400;
+    const qint64 dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const qint64 dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+/**
+ * @brief Proleptic Gregorian date of a day since 1970-01-01
+ */
+void civilFromDays(qint64 days, qint64& year, int& month, int& day)
+{
+    days += 719468;
+    const qint64 era = (days >= 0 ? days : days - 146096) / 146097;
+    const qint64 dayOfEra = days - era * 146097;
+    const qint64 yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const qint64 dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const qint64 monthIndex = (5 * dayOfYear + 2) / 153;
+    day = int(dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+    month = int(monthIndex < 10 ? monthIndex + 3 : monthIndex - 9);
+    year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+}
+
+/**
+ * @brief Number of days in a month
+ */
+int daysInMonth(qint64 year, int month)
+{
+    static const int kDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    const bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return month == 2 && leap ? 29 : kDays[month - 1];
+}
+
+/**
+ * @brief Write a zero-padded decimal number
+ */
+void writeDigits(QChar* out, int value, int width)
+{
+    for (int i = width - 1; i >= 0; --i) {
+        out[i] = QChar(u'0' + value % 10);
+        value /= 10;
+    }
+}
+
+/**
+ * @brief Check for an ASCII digit
+ *
+ * QChar::isDigit() also accepts other scripts' digits, which do not
+ * follow '0' in the code table.
+ */
+bool isAsciiDigit(QChar c)
+{
+    return c.unicode() >= u'0' && c.unicode() <= u'9';
+}
+
+/**
+ * @brief Read a fixed-width decimal number
+ * @return The number, or -1 if a character is not a digit
+ */
+int readDigits(QStringView text, int pos, int width)
+{
+    int value = 0;
+    for (int i = pos; i < pos + width; ++i) {
+        if (!isAsciiDigit(text[i]))
+            return -1;
+        value = value * 10 + (text[i].unicode() - u'0');
+    }
+    return value;
+}
+
+/**
+ * @brief Decode the fixed ISO-8601 layout with an explicit offset
+ * @return false if @p text needs the general parser
+ */
+bool parseFixed(QStringView text, qint64& msecs)
+{
+    const int size = int(text.size());
+    if (size < 19 || text[4] != u'-' || text[7] != u'-' || (text[10] != u'T' && text[10] != u' ')
+        || text[13] != u':' || text[16] != u':') {
+        return false;
+    }
+
+    const int year = readDigits(text, 0, 4);
+    const int month = readDigits(text, 5, 2);
+    const int day = readDigits(text, 8, 2);
+    const int hour = readDigits(text, 11, 2);
+    const int minute = readDigits(text, 14, 2);
+    const int second = readDigits(text, 17, 2);
+    if (year < 0 || month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month)
+        || hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 59) {
+        return false;
+    }
+
+    // Fraction: keep milliseconds, ignore finer digits
+    int pos = 19;
+    int msec = 0;
+    if (pos < size && text[pos] == u'.') {
+        int digits = 0;
+        for (++pos; pos < size && isAsciiDigit(text[pos]); ++pos, ++digits) {
+            if (digits < 3)
+                msec = msec * 10 + (text[pos].unicode() - u'0');
+        }
+        if (digits == 0)
+            return false;
+        for (; digits < 3; ++digits)
+            msec *= 10;
+    }
+
+    // Offset: "Z", "+HH:MM" or "+HHMM"; local times take the slow path
+    qint64 offset = 0;
+    if (pos < size && text[pos] == u'Z' && pos + 1 == size) {
+        offset = 0;
+    } else if (pos < size && (text[pos] == u'+' || text[pos] == u'-')) {
+        const bool colon = size == pos + 6 && text[pos + 3] == u':';
+        if (!colon && size != pos + 5)
+            return false;
+        const int offsetHours = readDigits(text, pos + 1, 2);
+        const int offsetMinutes = readDigits(text, colon ? pos + 4 : pos + 3, 2);
+        if (offsetHours < 0 || offsetHours > 23 || offsetMinutes < 0 || offsetMinutes > 59)
+            return false;
+        offset = (offsetHours * 60 + offsetMinutes) * 60 * 1000;
+        if (text[pos] == u'-')
+            offset = -offset;
+    } else {
+        return false;
+    }
+
+    msecs = daysFromCivil(year, month, day) * kMsecsPerDay
+            + ((hour * 60 + minute) * 60 + second) * qint64(1000) + msec - offset;
+    return true;
+}
+
+} // namespace
+
+namespace Timestamp {
+
+/**
+ * @brief Get the current time
+ */
+qint64 now()
+{
+    return QDateTime::currentMSecsSinceEpoch();
+}
+
+/**
+ * @brief Format a timestamp as ISO-8601 in UTC
+ */
+QString toIso(qint64 msecs)
+{
+    if (msecs == kInvalid)
+        return QString();
+
+    qint64 days = msecs / kMsecsPerDay;
+    qint64 rest = msecs % kMsecsPerDay;
+    if (rest < 0) {
+        rest += kMsecsPerDay;
+        --days;
+    }
+
+    qint64 year = 0;
+    int month = 0;
+    int day = 0;
+    civilFromDays(days, year, month, day);
+    if (year < 0 || year > 9999) {
+        // Outside the four-digit layout
+        return QDateTime::fromMSecsSinceEpoch(msecs).toUTC().toString(Qt::ISODateWithMs);
+    }
+
+    const int msOfDay = int(rest);
+    QString text(kIsoLength, Qt::Uninitialized);
+    QChar* out = text.data();
+    writeDigits(out, int(year), 4);
+    out[4] = u'-';
+    writeDigits(out + 5, month, 2);
+    out[7] = u'-';
+    writeDigits(out + 8, day, 2);
+    out[10] = u'T';
+    writeDigits(out + 11, msOfDay / 3600000, 2);
+    out[13] = u':';
+    writeDigits(out + 14, msOfDay / 60000 % 60, 2);
+    out[16] = u':';
+    writeDigits(out + 17, msOfDay / 1000 % 60, 2);
+    out[19] = u'.';
+    writeDigits(out + 20, msOfDay % 1000, 3);
+    out[23] = u'Z';
+    return text;
+}
+
+/**
+ * @brief Parse an ISO-8601 date and time
+ */
+qint64 fromIso(QStringView text)
+{
+    qint64 msecs = 0;
+    if (parseFixed(text, msecs))
+        return msecs;
+
+    return fromDateTime(QDateTime::fromString(text.toString(), Qt::ISODate));
+}
+
+/**
+ * @brief Convert a timestamp to a QDateTime
+ */
+QDateTime toDateTime(qint64 msecs)
+{
+    return msecs == kInvalid ? QDateTime() : QDateTime::fromMSecsSinceEpoch(msecs);
+}
+
+/**
+ * @brief Convert a QDateTime to a timestamp
+ */
+qint64 fromDateTime(const QDateTime& dateTime)
+{
+    return dateTime.isValid() ? dateTime.toMSecsSinceEpoch() : kInvalid;
+}
+
+} // namespace Timestamp
@@ -0,0 +1,72 @@
+/**
+ * @file Timestamp.h
+ * @brief Epoch-millisecond timestamps and their ISO-8601 codec
+ *
+ * This file declares helpers for the int64 UTC millisecond timestamps
+ * used by TodoItem and TodoStore, including a fixed-layout ISO-8601
+ * formatter and parser for the serialization paths.
+ */
+
+#ifndef TIMESTAMP_H
+#define TIMESTAMP_H
+
+#include <QString>
+#include <QStringView>
+#include <QDateTime>
+#include <limits>
+
+/**
+ * @namespace Timestamp
+ * @brief Milliseconds since 1970-01-01T00:00:00Z
+ *
+ * Converting with QDateTime involves time zone lookups on every call.
+ * These helpers work on the integer directly, so QDateTime is only built
+ * where a caller actually needs one, such as the date roles of the model.
+ */
+namespace Timestamp {
+
+/// Stored in place of a time that is unknown or not a valid date
+constexpr qint64 kInvalid = std::numeric_limits<qint64>::min();
+
+/**
+ * @brief Get the current time
+ * @return Milliseconds since the epoch, UTC
+ */
+qint64 now();
+
+/**
+ * @brief Format a timestamp as "YYYY-MM-DDTHH:MM:SS.sssZ"
+ * @param msecs Milliseconds since the epoch
+ * @return ISO-8601 text in UTC, empty for kInvalid
+ */
+QString toIso(qint64 msecs);
+
+/**
+ * @brief Parse an ISO-8601 date and time
+ *
+ * "YYYY-MM-DDTHH:MM:SS" with optional fraction and a "Z" or "+HH:MM"
+ * offset is decoded without QDateTime. Text without an offset is local
+ * time, as written by older versions, and goes through QDateTime.
+ *
+ * @param text ISO-8601 text
+ * @return Milliseconds since the epoch, or kInvalid if @p text is not a date
+ */
+qint64 fromIso(QStringView text);
+
+/**
+ * @brief Convert a timestamp to a QDateTime
+ * @param msecs Milliseconds since the epoch
+ * @return Date in local time, invalid for kInvalid
+ */
+QDateTime toDateTime(qint64 msecs);
+
+/**
+ * @brief Convert a QDateTime to a timestamp
+ * @param dateTime Date to convert
+ * @return Milliseconds since the epoch, kInvalid if @p dateTime is invalid
+ */
+qint64 fromDateTime(const QDateTime& dateTime);
+
+} // namespace Timestamp
+
+#endif // TIMESTAMP_H
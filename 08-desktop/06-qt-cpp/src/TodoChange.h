@@ -0,0 +1,68 @@
+/**
+ * @file TodoChange.h
+ * @brief Change records passed from the model to the storage layer
+ *
+ * This file defines the TodoChange structure which describes a single
+ * mutation of the todo list. Storage backends that support incremental
+ * persistence use these records instead of re-serializing the whole list.
+ */
+
+#ifndef TODOCHANGE_H
+#define TODOCHANGE_H
+
+#include <QUuid>
+#include <QVector>
+#include "TodoItem.h"
+
+/**
+ * @struct TodoChange
+ * @brief A single mutation of the todo list
+ *
+ * - Upsert: the item was added or one of its fields changed
+ * - Remove: the item with the given id was removed
+ * - Clear:  every item was removed
+ */
+struct TodoChange
+{
+    /**
+     * @enum Type
+     * @brief Kind of mutation
+     */
+    enum class Type {
+        Upsert,
+        Remove,
+        Clear
+    };
+
+    Type type = Type::Upsert;   ///< Kind of mutation
+    QUuid id;                   ///< Id of the affected item (null for Clear)
+    TodoItem item;              ///< New item state (Upsert only)
+
+    static TodoChange upsert(const TodoItem& item)
+    {
+        TodoChange change;
+        change.type = Type::Upsert;
+        change.id = item.getUuid();
+        change.item = item;
+        return change;
+    }
+
+    static TodoChange remove(const QUuid& id)
+    {
+        TodoChange change;
+        change.type = Type::Remove;
+        change.id = id;
+        return change;
+    }
+
+    static TodoChange clear()
+    {
+        TodoChange change;
+        change.type = Type::Clear;
+        return change;
+    }
+};
+
+using TodoChangeList = QVector<TodoChange>;
+
+#endif // TODOCHANGE_H
@@ -0,0 +1,277 @@
+/**
+ * @file TodoExporter.cpp
+ * @brief Implementation of TodoExporter class
+ */
+
+#include "TodoExporter.h"
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSemaphore>
+#include <QThread>
+#include <QDebug>
+#include <functional>
+
+namespace {
+
+/// Called after each round with the number of slots written
+using ProgressCallback = std::function<void(int)>;
+
+/**
+ * @brief Quote a CSV field if it contains separators, quotes or newlines
+ */
+QByteArray csvField(const QString& value)
+{
+    QByteArray field = value.toUtf8();
+    if (field.contains(',') || field.contains('"') || field.contains('\n') || field.contains('\r')) {
+        field.replace("\"", "\"\"");
+        field.prepend('"');
+        field.append('"');
+    }
+    return field;
+}
+
+/**
+ * @brief Append one item as a CSV row
+ */
+void appendCsvRow(QByteArray& out, const TodoItem& item)
+{
+    out.append(item.getId().toUtf8()).append(',');
+    out.append(csvField(item.getTitle())).append(',');
+    out.append(item.isCompleted() ? "true" : "false").append(',');
+    out.append(TodoItem::priorityToString(item.getPriority()).toUtf8()).append(',');
+    out.append(csvField(item.getCategory())).append(',');
+    out.append(Timestamp::toIso(item.createdAtMs()).toLatin1()).append(',');
+    out.append(Timestamp::toIso(item.modifiedAtMs()).toLatin1()).append("\r\n");
+}
+
+/**
+ * @brief Encode the live items of one chunk of slots
+ *
+ * JSON elements are separated by ",\n" within the chunk; the separator
+ * between chunks is written by writeExport(). Only reads the store.
+ */
+QByteArray encodeChunk(const TodoStore& store, int begin, int end, TodoExporter::Format format)
+{
+    QByteArray chunk;
+    for (int i = begin; i < end; ++i) {
+        if (!store.isLive(i))
+            continue;
+
+        const TodoItem item = store.item(i);
+        switch (format) {
+            case TodoExporter::Format::Json:
+                if (!chunk.isEmpty())
+                    chunk.append(",\n");
+                chunk.append(QJsonDocument(item.toJson()).toJson(QJsonDocument::Compact));
+                break;
+            case TodoExporter::Format::NdJson:
+                chunk.append(QJsonDocument(item.toJson()).toJson(QJsonDocument::Compact));
+                chunk.append('\n');
+                break;
+            case TodoExporter::Format::Csv:
+                appendCsvRow(chunk, item);
+                break;
+        }
+    }
+    return chunk;
+}
+
+/**
+ * @brief Get the bytes that precede the items
+ */
+QByteArray header(TodoExporter::Format format, int count)
+{
+    switch (format) {
+        case TodoExporter::Format::Json:
+            // Same members as the QJsonDocument-based export, in the same order
+            return QString("{\"count\":%1,\"exportDate\":\"%2\",\"todos\":[\n")
+                .arg(count)
+                .arg(Timestamp::toIso(Timestamp::now()))
+                .toUtf8();
+        case TodoExporter::Format::Csv:
+            return "id,title,completed,priority,category,createdAt,modifiedAt\r\n";
+        case TodoExporter::Format::NdJson:
+            break;
+    }
+    return QByteArray();
+}
+
+/**
+ * @brief Get the bytes that follow the items
+ */
+QByteArray footer(TodoExporter::Format format)
+{
+    return format == TodoExporter::Format::Json ? "\n],\"version\":\"1.0\"}\n" : QByteArray();
+}
+
+/**
+ * @brief Encode a store in parallel rounds and write it in order
+ *
+ * Each round encodes one chunk per core. The calling thread encodes the
+ * first chunk of the round itself, so the export also progresses when
+ * the global thread pool is busy.
+ *
+ * @return false on error or cancellation; @p error is empty if cancelled
+ */
+bool writeExport(const QString& filePath, const TodoStore& store, TodoExporter::Format format,
+                 const std::atomic<bool>& cancelled, const ProgressCallback& progress, QString& error)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        error = QString("Failed to open file for export: %1").arg(filePath);
+        return false;
+    }
+
+    file.write(header(format, store.liveCount()));
+
+    const int size = store.size();
+    const int chunkSize = TodoExporter::kChunkSize;
+    const int chunkCount = (size + chunkSize - 1) / chunkSize;
+    const int roundSize = qMax(1, QThread::idealThreadCount());
+    QThreadPool* workers = QThreadPool::globalInstance();
+    bool wroteItem = false;
+
+    for (int first = 0; first < chunkCount; first += roundSize) {
+        if (cancelled) {
+            file.cancelWriting();
+            return false;
+        }
+
+        const int count = qMin(roundSize, chunkCount - first);
+        QVector<QByteArray> encoded(count);
+        QByteArray* results = encoded.data();
+        QSemaphore done;
+
+        for (int c = 1; c < count; ++c) {
+            const int begin = (first + c) * chunkSize;
+            workers->start([&store, &done, results, c, begin, size, chunkSize, format]() {
+                results[c] = encodeChunk(store, begin, qMin(begin + chunkSize, size), format);
+                done.release();
+            });
+        }
+        const int begin = first * chunkSize;
+        results[0] = encodeChunk(store, begin, qMin(begin + chunkSize, size), format);
+        done.acquire(count - 1);
+
+        for (const QByteArray& chunk : std::as_const(encoded)) {
+            if (chunk.isEmpty())
+                continue;
+            if (format == TodoExporter::Format::Json && wroteItem)
+                file.write(",\n");
+            file.write(chunk);
+            wroteItem = true;
+        }
+
+        if (progress)
+            progress(qMin(size, (first + count) * chunkSize));
+    }
+
+    file.write(footer(format));
+    if (!file.commit()) {
+        error = QString("Failed to write export: %1").arg(file.errorString());
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief Constructor implementation
+ */
+TodoExporter::TodoExporter(QObject *parent)
+    : QObject(parent)
+{
+    m_pool.setMaxThreadCount(1);
+}
+
+/**
+ * @brief Destructor implementation
+ */
+TodoExporter::~TodoExporter()
+{
+    cancel();
+    m_pool.waitForDone();
+}
+
+/**
+ * @brief Start exporting in the background
+ */
+bool TodoExporter::start(const QString& filePath, const TodoStore& snapshot, Format format)
+{
+    if (m_running)
+        return false;
+
+    // The previous writer may still be returning after posting finished()
+    m_pool.waitForDone();
+
+    m_running = true;
+    m_cancelled = false;
+    m_error.clear();
+
+    m_pool.start([this, filePath, snapshot, format]() {
+        const int total = snapshot.size();
+        QString error;
+        const bool ok = writeExport(filePath, snapshot, format, m_cancelled, [this, total](int done) {
+            QMetaObject::invokeMethod(this, [this, done, total]() {
+                emit progressChanged(done, total);
+            }, Qt::QueuedConnection);
+        }, error);
+
+        const int count = snapshot.liveCount();
+        if (ok)
+            qDebug() << "Exported" << count << "todos to" << filePath;
+        else if (!error.isEmpty())
+            qWarning() << error;
+
+        QMetaObject::invokeMethod(this, [this, ok, error, count]() {
+            m_running = false;
+            m_error = error;
+            if (ok)
+                emit finished(Status::Finished, count);
+            else
+                emit finished(error.isEmpty() ? Status::Cancelled : Status::Failed, 0);
+        }, Qt::QueuedConnection);
+    });
+    return true;
+}
+
+/**
+ * @brief Stop the running export
+ */
+void TodoExporter::cancel()
+{
+    if (m_running)
+        m_cancelled = true;
+}
+
+/**
+ * @brief Export on the calling thread
+ */
+bool TodoExporter::exportStore(const QString& filePath, const TodoStore& snapshot, Format format)
+{
+    const std::atomic<bool> never{false};
+    QString error;
+    if (!writeExport(filePath, snapshot, format, never, ProgressCallback(), error)) {
+        qWarning() << error;
+        return false;
+    }
+
+    qDebug() << "Exported" << snapshot.liveCount() << "todos to" << filePath;
+    return true;
+}
+
+/**
+ * @brief Pick the format matching a file name
+ */
+TodoExporter::Format TodoExporter::formatForPath(const QString& filePath)
+{
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+    if (suffix == "ndjson" || suffix == "jsonl")
+        return Format::NdJson;
+    if (suffix == "csv")
+        return Format::Csv;
+    return Format::Json;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file TodoExporter.h
+ * @brief Background export of todo lists
+ *
+ * This file defines the TodoExporter class which encodes a snapshot of
+ * the todo list on several threads and writes it as JSON, NDJSON or CSV.
+ */
+
+#ifndef TODOEXPORTER_H
+#define TODOEXPORTER_H
+
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <atomic>
+#include "TodoStore.h"
+
+/**
+ * @class TodoExporter
+ * @brief Writes a TodoStore snapshot to disk without blocking the caller
+ *
+ * The snapshot is cut into chunks of kChunkSize slots. Each round encodes
+ * one chunk per core in parallel and then appends the round to the file
+ * in slot order, so the output is identical to a sequential export and
+ * only one round of encoded data is held in memory.
+ *
+ * The file is written through QSaveFile: a cancelled or failed export
+ * leaves any existing file untouched.
+ */
+class TodoExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @enum Format
+     * @brief Output formats
+     */
+    enum class Format {
+        Json,       ///< Object with a "todos" array, readable by importFromJson()
+        NdJson,     ///< One JSON object per line
+        Csv         ///< RFC 4180 CSV with a header row
+    };
+    Q_ENUM(Format)
+
+    /**
+     * @enum Status
+     * @brief How an export ended
+     */
+    enum class Status {
+        Finished,   ///< The file was written
+        Cancelled,  ///< cancel() stopped the export
+        Failed      ///< The file could not be written
+    };
+    Q_ENUM(Status)
+
+    /// Slots encoded per task
+    static constexpr int kChunkSize = 4096;
+
+    /**
+     * @brief Constructor
+     * @param parent Parent QObject
+     */
+    explicit TodoExporter(QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor, cancels and waits for the export
+     */
+    ~TodoExporter() override;
+
+    /**
+     * @brief Start exporting in the background
+     * @param filePath Destination file
+     * @param snapshot Items to export; removed slots are skipped
+     * @param format Output format
+     * @return false if an export is already running
+     */
+    bool start(const QString& filePath, const TodoStore& snapshot, Format format);
+
+    /**
+     * @brief Check whether an export is running
+     * @return true between start() and finished()
+     */
+    bool isRunning() const { return m_running; }
+
+    /**
+     * @brief Get the error of a failed export
+     * @return Error message, empty unless finished() reported Failed
+     */
+    QString errorString() const { return m_error; }
+
+    /**
+     * @brief Export on the calling thread, encoding in parallel
+     * @param filePath Destination file
+     * @param snapshot Items to export; removed slots are skipped
+     * @param format Output format
+     * @return true if successful
+     */
+    static bool exportStore(const QString& filePath, const TodoStore& snapshot, Format format);
+
+    /**
+     * @brief Pick the format matching a file name
+     * @param filePath File name ending in .ndjson/.jsonl, .csv or anything else for JSON
+     * @return Output format
+     */
+    static Format formatForPath(const QString& filePath);
+
+public slots:
+    /**
+     * @brief Stop the running export; finished() reports Cancelled
+     */
+    void cancel();
+
+signals:
+    /**
+     * @brief Emitted after each round of chunks is written
+     * @param done Slots written so far
+     * @param total Slots in the snapshot
+     */
+    void progressChanged(int done, int total);
+
+    /**
+     * @brief Emitted once when the export ends
+     * @param status How the export ended
+     * @param count Number of items written
+     */
+    void finished(TodoExporter::Status status, int count);
+
+private:
+    QThreadPool m_pool;                     ///< Thread that writes the file
+    std::atomic<bool> m_cancelled{false};   ///< Set by cancel(), read by the writer
+    bool m_running = false;                 ///< An export is in progress
+    QString m_error;                        ///< Error of the last export
+};
+
+#endif // TODOEXPORTER_H
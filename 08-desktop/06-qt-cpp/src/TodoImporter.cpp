@@ -0,0 +1,129 @@
+/**
+ * @file TodoImporter.cpp
+ * @brief Implementation of TodoImporter class
+ */
+
+#include "TodoImporter.h"
+#include "TodoJsonReader.h"
+#include <QFile>
+#include <QDebug>
+
+namespace {
+
+/// How often a worker waiting for a free batch slot checks for cancellation
+constexpr int kCancelPollMs = 50;
+
+} // namespace
+
+/**
+ * @brief Constructor implementation
+ */
+TodoImporter::TodoImporter(QObject *parent)
+    : QObject(parent)
+    , m_freeSlots(kMaxQueuedBatches)
+{
+    m_pool.setMaxThreadCount(1);
+}
+
+/**
+ * @brief Destructor implementation
+ */
+TodoImporter::~TodoImporter()
+{
+    cancel();
+    m_pool.waitForDone();
+}
+
+/**
+ * @brief Start importing a file in the background
+ */
+bool TodoImporter::start(const QString& filePath)
+{
+    if (m_running)
+        return false;
+
+    // The previous worker may still be returning after posting finished()
+    m_pool.waitForDone();
+
+    m_running = true;
+    m_cancelled = false;
+    m_error.clear();
+    m_delivered = 0;
+
+    // A cancelled worker can exit holding a slot, so start from a full set
+    m_freeSlots.acquire(m_freeSlots.available());
+    m_freeSlots.release(kMaxQueuedBatches);
+
+    m_pool.start([this, filePath]() { run(filePath); });
+    return true;
+}
+
+/**
+ * @brief Stop the running import
+ */
+void TodoImporter::cancel()
+{
+    if (m_running)
+        m_cancelled = true;
+}
+
+/**
+ * @brief Decode the file on the worker thread
+ *
+ * Each batch is posted to the owner thread, which releases its slot once
+ * the batch was delivered. Batches still queued when cancel() is called
+ * are dropped there, so nothing arrives after the user cancelled.
+ */
+void TodoImporter::run(const QString& filePath)
+{
+    QFile file(filePath);
+    TodoJsonReader reader(&file);
+    QString error;
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = QString("Failed to open file for import: %1").arg(filePath);
+        qWarning() << error;
+    } else {
+        const qint64 total = file.size();
+
+        while (!reader.atEnd() && !m_cancelled) {
+            QVector<TodoItem> batch;
+            batch.reserve(kBatchSize);
+            reader.readBatch(batch, kBatchSize);
+
+            // Wait until the owner thread has caught up
+            while (!m_freeSlots.tryAcquire(1, kCancelPollMs)) {
+                if (m_cancelled)
+                    break;
+            }
+            if (m_cancelled)
+                break;
+
+            const qint64 bytesRead = reader.bytesRead();
+            QMetaObject::invokeMethod(this, [this, batch = std::move(batch), bytesRead, total]() {
+                if (!m_cancelled && !batch.isEmpty()) {
+                    m_delivered += batch.size();
+                    emit batchReady(batch);
+                }
+                emit progressChanged(bytesRead, total);
+                m_freeSlots.release();
+            }, Qt::QueuedConnection);
+        }
+
+        error = reader.errorString();
+    }
+
+    const Status status = error.isEmpty() ? Status::Finished : Status::Failed;
+    QMetaObject::invokeMethod(this, [this, status, error]() {
+        m_running = false;
+        if (m_cancelled) {
+            emit finished(Status::Cancelled, m_delivered);
+            return;
+        }
+
+        m_error = error;
+        if (status == Status::Finished)
+            qDebug() << "Imported" << m_delivered << "todos";
+        emit finished(status, m_delivered);
+    }, Qt::QueuedConnection);
+}
@@ -0,0 +1,124 @@
+/**
+ * @file TodoImporter.h
+ * @brief Background import of exported todo lists
+ *
+ * This file defines the TodoImporter class which streams an export file
+ * on a worker thread and delivers its items to the GUI thread in batches.
+ */
+
+#ifndef TODOIMPORTER_H
+#define TODOIMPORTER_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <atomic>
+#include "TodoItem.h"
+
+/**
+ * @class TodoImporter
+ * @brief Streams an export file into batches of todo items
+ *
+ * The file is decoded with TodoJsonReader on a worker thread. Batches,
+ * progress and the final result are delivered on the thread that owns
+ * the importer. The worker waits while kMaxQueuedBatches batches are
+ * still undelivered, so a slow consumer bounds memory use at a few
+ * batches instead of letting the whole file pile up in the event queue.
+ */
+class TodoImporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @enum Status
+     * @brief How an import ended
+     */
+    enum class Status {
+        Finished,   ///< Every item was read
+        Cancelled,  ///< cancel() stopped the import
+        Failed      ///< The file could not be opened or parsed
+    };
+    Q_ENUM(Status)
+
+    /// Items per batch handed to the consumer
+    static constexpr int kBatchSize = 1000;
+
+    /// Batches that may wait for delivery before the worker pauses
+    static constexpr int kMaxQueuedBatches = 2;
+
+    /**
+     * @brief Constructor
+     * @param parent Parent QObject
+     */
+    explicit TodoImporter(QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor, cancels and waits for the worker
+     */
+    ~TodoImporter() override;
+
+    /**
+     * @brief Start importing a file in the background
+     * @param filePath Path of the export file
+     * @return false if an import is already running
+     */
+    bool start(const QString& filePath);
+
+    /**
+     * @brief Check whether an import is running
+     * @return true between start() and finished()
+     */
+    bool isRunning() const { return m_running; }
+
+    /**
+     * @brief Get the error of a failed import
+     * @return Error message, empty unless finished() reported Failed
+     */
+    QString errorString() const { return m_error; }
+
+public slots:
+    /**
+     * @brief Stop the running import; finished() reports Cancelled
+     */
+    void cancel();
+
+signals:
+    /**
+     * @brief Emitted for each decoded batch
+     * @param batch Items in file order
+     */
+    void batchReady(const QVector<TodoItem>& batch);
+
+    /**
+     * @brief Emitted after each batch
+     * @param bytesRead Bytes of the file processed so far
+     * @param bytesTotal File size
+     */
+    void progressChanged(qint64 bytesRead, qint64 bytesTotal);
+
+    /**
+     * @brief Emitted once when the import ends
+     * @param status How the import ended
+     * @param count Number of items delivered through batchReady()
+     */
+    void finished(TodoImporter::Status status, int count);
+
+private:
+    QThreadPool m_pool;                     ///< Single import worker thread
+    QSemaphore m_freeSlots;                 ///< Batches the worker may still queue
+    std::atomic<bool> m_cancelled{false};   ///< Set by cancel(), read by the worker
+    bool m_running = false;                 ///< An import is in progress
+    QString m_error;                        ///< Error of the last import
+    int m_delivered = 0;                    ///< Items delivered by the current import
+
+    /**
+     * @brief Decode the file; runs on the worker thread
+     * @param filePath Path of the export file
+     */
+    void run(const QString& filePath);
+};
+
+#endif // TODOIMPORTER_H
@@ -10,12 +10,12 @@
  * @brief Default constructor implementation
  */
 TodoItem::TodoItem()
-    : m_id(QUuid::createUuid().toString(QUuid::WithoutBraces))
+    : m_id(QUuid::createUuid())
     , m_title("")
     , m_completed(false)
     , m_priority(Priority::Normal)
-    , m_createdAt(QDateTime::currentDateTime())
-    , m_modifiedAt(QDateTime::currentDateTime())
+    , m_createdAtMs(Timestamp::now())
+    , m_modifiedAtMs(m_createdAtMs)
     , m_category("")
 {
 }
@@ -24,12 +24,12 @@ TodoItem::TodoItem()
  * @brief Constructor with title implementation
  */
 TodoItem::TodoItem(const QString& title)
-    : m_id(QUuid::createUuid().toString(QUuid::WithoutBraces))
+    : m_id(QUuid::createUuid())
     , m_title(title)
     , m_completed(false)
     , m_priority(Priority::Normal)
-    , m_createdAt(QDateTime::currentDateTime())
-    , m_modifiedAt(QDateTime::currentDateTime())
+    , m_createdAtMs(Timestamp::now())
+    , m_modifiedAtMs(m_createdAtMs)
     , m_category("")
 {
 }
@@ -38,16 +38,42 @@ TodoItem::TodoItem(const QString& title)
  * @brief Full constructor implementation
  */
 TodoItem::TodoItem(const QString& title, bool completed, Priority priority)
-    : m_id(QUuid::createUuid().toString(QUuid::WithoutBraces))
+    : m_id(QUuid::createUuid())
     , m_title(title)
     , m_completed(completed)
     , m_priority(priority)
-    , m_createdAt(QDateTime::currentDateTime())
-    , m_modifiedAt(QDateTime::currentDateTime())
+    , m_createdAtMs(Timestamp::now())
+    , m_modifiedAtMs(m_createdAtMs)
     , m_category("")
 {
 }
 
+/**
+ * @brief Restore constructor implementation
+ */
+TodoItem::TodoItem(const QUuid& id, const QString& title, bool completed, Priority priority,
+                   const QString& category, qint64 createdAtMs, qint64 modifiedAtMs)
+    : m_id(id)
+    , m_title(title)
+    , m_completed(completed)
+    , m_priority(priority)
+    , m_createdAtMs(createdAtMs)
+    , m_modifiedAtMs(modifiedAtMs)
+    , m_category(category)
+{
+}
+
+/**
+ * @brief Set ID from its string form
+ */
+void TodoItem::setId(const QString& id)
+{
+    QUuid uuid = QUuid::fromString(id);
+    if (!uuid.isNull()) {
+        m_id = uuid;
+    }
+}
+
 /**
  * @brief Set title and update modification time
  */
@@ -107,7 +133,7 @@ bool TodoItem::toggleCompleted()
  */
 void TodoItem::updateModifiedTime()
 {
-    m_modifiedAt = QDateTime::currentDateTime();
+    m_modifiedAtMs = Timestamp::now();
 }
 
 /**
@@ -116,12 +142,12 @@ void TodoItem::updateModifiedTime()
 QJsonObject TodoItem::toJson() const
 {
     QJsonObject json;
-    json["id"] = m_id;
+    json["id"] = getId();
     json["title"] = m_title;
     json["completed"] = m_completed;
     json["priority"] = static_cast<int>(m_priority);
-    json["createdAt"] = m_createdAt.toString(Qt::ISODate);
-    json["modifiedAt"] = m_modifiedAt.toString(Qt::ISODate);
+    json["createdAt"] = Timestamp::toIso(m_createdAtMs);
+    json["modifiedAt"] = Timestamp::toIso(m_modifiedAtMs);
     json["category"] = m_category;
     return json;
 }
@@ -133,8 +159,9 @@ TodoItem TodoItem::fromJson(const QJsonObject& json)
 {
     TodoItem item;
 
+    // Ids that are not UUIDs keep the freshly generated one
     if (json.contains("id") && json["id"].isString()) {
-        item.m_id = json["id"].toString();
+        item.setId(json["id"].toString());
     }
 
     if (json.contains("title") && json["title"].isString()) {
@@ -153,11 +180,11 @@ TodoItem TodoItem::fromJson(const QJsonObject& json)
     }
 
     if (json.contains("createdAt") && json["createdAt"].isString()) {
-        item.m_createdAt = QDateTime::fromString(json["createdAt"].toString(), Qt::ISODate);
+        item.m_createdAtMs = Timestamp::fromIso(json["createdAt"].toString());
     }
 
     if (json.contains("modifiedAt") && json["modifiedAt"].isString()) {
-        item.m_modifiedAt = QDateTime::fromString(json["modifiedAt"].toString(), Qt::ISODate);
+        item.m_modifiedAtMs = Timestamp::fromIso(json["modifiedAt"].toString());
     }
 
     if (json.contains("category") && json["category"].isString()) {
@@ -172,12 +199,21 @@ TodoItem TodoItem::fromJson(const QJsonObject& json)
  */
 QString TodoItem::priorityString() const
 {
-    switch (m_priority) {
-        case Priority::Low:    return "Low";
-        case Priority::Normal: return "Normal";
-        case Priority::High:   return "High";
-        case Priority::Urgent: return "Urgent";
-        default:               return "Unknown";
+    return priorityToString(m_priority);
+}
+
+/**
+ * @brief Get the display name of a priority
+ */
+QString TodoItem::priorityToString(Priority priority)
+{
+    // Literals share static data, so views asking per row allocate nothing
+    switch (priority) {
+        case Priority::Low:    return QStringLiteral("Low");
+        case Priority::Normal: return QStringLiteral("Normal");
+        case Priority::High:   return QStringLiteral("High");
+        case Priority::Urgent: return QStringLiteral("Urgent");
+        default:               return QStringLiteral("Unknown");
     }
 }
 
@@ -15,16 +15,19 @@
 #include <QUuid>
 #include <QJsonObject>
 #include <QMetaType>
+#include "Timestamp.h"
 
 /**
  * @class TodoItem
  * @brief Represents a single todo item with all its properties
  *
  * This class encapsulates all data related to a todo item including:
- * - Unique identifier (UUID)
+ * - Unique identifier (UUID, held as a 16-byte QUuid and converted to a
+ *   string only for serialization and display)
  * - Title/text content
  * - Completion status
- * - Creation and modification timestamps
+ * - Creation and modification timestamps (UTC milliseconds since the
+ *   epoch; QDateTime is built only by the date getters)
  * - Priority level
  * - Tags/categories
  */
@@ -62,6 +65,21 @@ public:
      */
     TodoItem(const QString& title, bool completed, Priority priority = Priority::Normal);
 
+    /**
+     * @brief Restore constructor
+     * Recreates a persisted item with all of its fields, without generating
+     * a new UUID or timestamps
+     * @param id Unique identifier
+     * @param title The todo item title
+     * @param completed Completion status
+     * @param priority Priority level
+     * @param category Category/tag
+     * @param createdAtMs Creation time in ms since epoch, or Timestamp::kInvalid
+     * @param modifiedAtMs Modification time in ms since epoch, or Timestamp::kInvalid
+     */
+    TodoItem(const QUuid& id, const QString& title, bool completed, Priority priority,
+             const QString& category, qint64 createdAtMs, qint64 modifiedAtMs);
+
     /**
      * @brief Copy constructor
      */
@@ -88,16 +106,20 @@ public:
     ~TodoItem() = default;
 
     // Getters
-    QString getId() const { return m_id; }
+    QString getId() const { return m_id.toString(QUuid::WithoutBraces); }
+    const QUuid& getUuid() const { return m_id; }
     QString getTitle() const { return m_title; }
     bool isCompleted() const { return m_completed; }
     Priority getPriority() const { return m_priority; }
-    QDateTime getCreatedAt() const { return m_createdAt; }
-    QDateTime getModifiedAt() const { return m_modifiedAt; }
+    QDateTime getCreatedAt() const { return Timestamp::toDateTime(m_createdAtMs); }
+    QDateTime getModifiedAt() const { return Timestamp::toDateTime(m_modifiedAtMs); }
+    qint64 createdAtMs() const { return m_createdAtMs; }
+    qint64 modifiedAtMs() const { return m_modifiedAtMs; }
     QString getCategory() const { return m_category; }
 
     // Setters
-    void setId(const QString& id) { m_id = id; }
+    void setId(const QUuid& id) { m_id = id; }
+    void setId(const QString& id);
     void setTitle(const QString& title);
     void setCompleted(bool completed);
     void setPriority(Priority priority);
@@ -128,6 +150,13 @@ public:
      */
     QString priorityString() const;
 
+    /**
+     * @brief Get the display name of a priority
+     * @param priority Priority level
+     * @return Priority name
+     */
+    static QString priorityToString(Priority priority);
+
     /**
      * @brief Get priority as integer
      * @return Priority value (0-3)
@@ -145,12 +174,12 @@ public:
     bool operator!=(const TodoItem& other) const;
 
 private:
-    QString m_id;                  ///< Unique identifier (UUID)
+    QUuid m_id;                    ///< Unique identifier
     QString m_title;               ///< Todo item title/description
     bool m_completed;              ///< Completion status
     Priority m_priority;           ///< Priority level
-    QDateTime m_createdAt;         ///< Creation timestamp
-    QDateTime m_modifiedAt;        ///< Last modification timestamp
+    qint64 m_createdAtMs;          ///< Creation time, ms since epoch (UTC)
+    qint64 m_modifiedAtMs;         ///< Last modification time, ms since epoch (UTC)
     QString m_category;            ///< Category/tag for organization
 
     /**
@@ -0,0 +1,259 @@
+/**
+ * @file TodoItemDelegate.cpp
+ * @brief Implementation of TodoItemDelegate class
+ */
+
+#include "TodoItemDelegate.h"
+#include "TodoModel.h"
+#include <QApplication>
+#include <QStyle>
+#include <QPainter>
+#include <QMouseEvent>
+#include <QFontMetrics>
+#include <memory>
+
+namespace {
+
+/// Horizontal gap between the parts of a row, and vertical padding
+constexpr int kPadding = 6;
+
+/// Horizontal padding inside a priority badge
+constexpr int kBadgePadding = 6;
+
+/// Corner radius of a priority badge
+constexpr qreal kBadgeRadius = 4.0;
+
+/// Widest share of a row the category may take before it is elided
+constexpr int kCategoryShare = 4;
+
+/**
+ * @brief Get the badge color of a priority level
+ */
+QColor priorityColor(int priority)
+{
+    switch (static_cast<TodoItem::Priority>(priority)) {
+        case TodoItem::Priority::Low:    return QColor(0x9e, 0x9e, 0x9e);
+        case TodoItem::Priority::Normal: return QColor(0x19, 0x76, 0xd2);
+        case TodoItem::Priority::High:   return QColor(0xf5, 0x7c, 0x00);
+        case TodoItem::Priority::Urgent: return QColor(0xd3, 0x2f, 0x2f);
+    }
+    return QColor(0x9e, 0x9e, 0x9e);
+}
+
+/**
+ * @brief Prepare a plain-text layout for repeated drawing
+ */
+QStaticText prepareText(const QString& text, const QFont& font)
+{
+    QStaticText staticText(text);
+    staticText.setTextFormat(Qt::PlainText);
+    staticText.setPerformanceHint(QStaticText::AggressiveCaching);
+    staticText.prepare(QTransform(), font);
+    return staticText;
+}
+
+/**
+ * @brief Get the style a view item is drawn with
+ */
+QStyle* itemStyle(const QStyleOptionViewItem& option)
+{
+    return option.widget ? option.widget->style() : QApplication::style();
+}
+
+} // namespace
+
+/**
+ * @brief Construct a delegate for the rows of a model
+ */
+TodoItemDelegate::TodoItemDelegate(QAbstractItemModel *model, QObject *parent)
+    : QStyledItemDelegate(parent)
+    , m_rows(kCachedRows)
+{
+    connect(model, &QAbstractItemModel::dataChanged, this, &TodoItemDelegate::invalidateRows);
+    connect(model, &QAbstractItemModel::modelReset, this, &TodoItemDelegate::invalidateAll);
+    connect(model, &QAbstractItemModel::layoutChanged, this, &TodoItemDelegate::invalidateAll);
+    connect(model, &QAbstractItemModel::rowsInserted, this, &TodoItemDelegate::invalidateAll);
+    connect(model, &QAbstractItemModel::rowsRemoved, this, &TodoItemDelegate::invalidateAll);
+    connect(model, &QAbstractItemModel::rowsMoved, this, &TodoItemDelegate::invalidateAll);
+}
+
+/**
+ * @brief Paint one row
+ */
+void TodoItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
+                             const QModelIndex &index) const
+{
+    checkFont(option.font);
+    const RowLayout& row = rowLayout(option, index);
+    const Badge& badge = m_badges[row.priority];
+    QStyle *style = itemStyle(option);
+
+    // Background, alternate rows, selection and hover as the style draws them
+    style->drawPrimitive(QStyle::PE_PanelItemViewItem, &option, painter, option.widget);
+
+    QStyleOptionViewItem check(option);
+    check.rect = checkRect(option);
+    check.state &= ~(QStyle::State_On | QStyle::State_Off | QStyle::State_HasFocus);
+    check.state |= row.completed ? QStyle::State_On : QStyle::State_Off;
+    style->drawPrimitive(QStyle::PE_IndicatorItemViewItemCheck, &check, painter, option.widget);
+
+    painter->save();
+
+    const QRect content = option.rect.adjusted(kPadding, 0, -kPadding, 0);
+    const int lineHeight = option.fontMetrics.height();
+    const int textY = content.top() + (content.height() - lineHeight) / 2;
+    const bool selected = option.state & QStyle::State_Selected;
+    const QColor textColor = option.palette.color(selected ? QPalette::HighlightedText : QPalette::Text);
+    const QColor dimColor = selected ? textColor : option.palette.color(QPalette::PlaceholderText);
+
+    // Priority badge at the right edge
+    const QRect badgeRect(content.right() - badge.width + 1, textY - 1, badge.width, lineHeight + 2);
+    painter->setRenderHint(QPainter::Antialiasing);
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(priorityColor(row.priority));
+    painter->drawRoundedRect(badgeRect, kBadgeRadius, kBadgeRadius);
+    painter->setFont(m_font);
+    painter->setPen(Qt::white);
+    painter->drawStaticText(badgeRect.left() + kBadgePadding, textY, badge.text);
+
+    // Category just left of the badge
+    if (row.categoryWidth > 0) {
+        painter->setPen(dimColor);
+        painter->drawStaticText(badgeRect.left() - kPadding - row.categoryWidth, textY, row.category);
+    }
+
+    // Title after the checkbox; completed ones were prepared struck out
+    QFont titleFont = m_font;
+    titleFont.setStrikeOut(row.completed);
+    painter->setFont(titleFont);
+    painter->setPen(row.completed ? dimColor : textColor);
+    painter->drawStaticText(check.rect.right() + 1 + kPadding, textY, row.title);
+
+    painter->restore();
+}
+
+/**
+ * @brief Get the size of a row
+ */
+QSize TodoItemDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    Q_UNUSED(index);
+    const QStyle *style = itemStyle(option);
+    const int indicator = style->pixelMetric(QStyle::PM_IndicatorHeight, &option, option.widget);
+    const int height = qMax(option.fontMetrics.height() + 2, indicator) + 2 * kPadding;
+    return QSize(option.rect.width(), height);
+}
+
+/**
+ * @brief Toggle completion when the checkbox is clicked
+ */
+bool TodoItemDelegate::editorEvent(QEvent *event, QAbstractItemModel *model,
+                                   const QStyleOptionViewItem &option, const QModelIndex &index)
+{
+    const QEvent::Type type = event->type();
+    if (type != QEvent::MouseButtonPress && type != QEvent::MouseButtonRelease
+        && type != QEvent::MouseButtonDblClick)
+        return false;
+
+    const auto *mouse = static_cast<QMouseEvent*>(event);
+    if (mouse->button() != Qt::LeftButton || !checkRect(option).contains(mouse->position().toPoint()))
+        return false;
+
+    // Presses and double clicks on the checkbox are swallowed so that
+    // one click toggles once
+    if (type != QEvent::MouseButtonRelease)
+        return true;
+
+    const bool completed = index.data(TodoModel::CompletedRole).toBool();
+    return model->setData(index, !completed, TodoModel::CompletedRole);
+}
+
+/**
+ * @brief Get the layout of a row, building it on a cache miss
+ */
+const TodoItemDelegate::RowLayout& TodoItemDelegate::rowLayout(const QStyleOptionViewItem &option,
+                                                               const QModelIndex &index) const
+{
+    const int width = option.rect.width();
+    if (const RowLayout* cached = m_rows.object(index.row()); cached && cached->width == width)
+        return *cached;
+
+    auto row = std::make_unique<RowLayout>();
+    row->width = width;
+    row->completed = index.data(TodoModel::CompletedRole).toBool();
+    row->priority = qBound(0, index.data(TodoModel::PriorityRole).toInt(), int(m_badges.size()) - 1);
+
+    const QFontMetrics& metrics = option.fontMetrics;
+    const int checkWidth = checkRect(option).width();
+    const QString category = index.data(TodoModel::CategoryRole).toString();
+    if (!category.isEmpty()) {
+        const QString elided = metrics.elidedText(category, Qt::ElideRight, width / kCategoryShare);
+        row->categoryWidth = metrics.horizontalAdvance(elided);
+        row->category = prepareText(elided, m_font);
+    }
+
+    // Whatever the checkbox, badge and category leave over
+    const int titleWidth = width - 4 * kPadding - checkWidth - m_badges[row->priority].width
+                         - (row->categoryWidth > 0 ? row->categoryWidth + kPadding : 0);
+    QFont titleFont = m_font;
+    titleFont.setStrikeOut(row->completed);
+    const QString title = index.data(TodoModel::TitleRole).toString();
+    row->title = prepareText(metrics.elidedText(title, Qt::ElideRight, qMax(0, titleWidth)), titleFont);
+
+    RowLayout* layout = row.release();
+    m_rows.insert(index.row(), layout);
+    return *layout;
+}
+
+/**
+ * @brief Drop every cached layout if the view font changed
+ */
+void TodoItemDelegate::checkFont(const QFont &font) const
+{
+    if (font == m_font && m_badges[0].width > 0)
+        return;
+
+    m_font = font;
+    m_rows.clear();
+
+    const QFontMetrics metrics(font);
+    for (int priority = 0; priority < int(m_badges.size()); ++priority) {
+        const QString name = TodoItem::priorityToString(static_cast<TodoItem::Priority>(priority));
+        m_badges[priority].text = prepareText(name, font);
+        m_badges[priority].width = metrics.horizontalAdvance(name) + 2 * kBadgePadding;
+    }
+}
+
+/**
+ * @brief Get the checkbox rectangle of a row
+ */
+QRect TodoItemDelegate::checkRect(const QStyleOptionViewItem &option)
+{
+    const QStyle *style = itemStyle(option);
+    const int width = style->pixelMetric(QStyle::PM_IndicatorWidth, &option, option.widget);
+    const int height = style->pixelMetric(QStyle::PM_IndicatorHeight, &option, option.widget);
+    return QRect(option.rect.left() + kPadding, option.rect.top() + (option.rect.height() - height) / 2,
+                 width, height);
+}
+
+/**
+ * @brief Drop the layouts of a range of rows
+ */
+void TodoItemDelegate::invalidateRows(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    // A change spread over many rows is cheaper to forget at once
+    if (bottomRight.row() - topLeft.row() >= kCachedRows) {
+        m_rows.clear();
+        return;
+    }
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row)
+        m_rows.remove(row);
+}
+
+/**
+ * @brief Drop every cached layout
+ */
+void TodoItemDelegate::invalidateAll()
+{
+    m_rows.clear();
+}
@@ -0,0 +1,135 @@
+/**
+ * @file TodoItemDelegate.h
+ * @brief Item delegate painting todo rows from cached text layouts
+ *
+ * This file defines the TodoItemDelegate class which draws each row of
+ * the todo list view: checkbox, title, category and priority badge.
+ */
+
+#ifndef TODOITEMDELEGATE_H
+#define TODOITEMDELEGATE_H
+
+#include <QStyledItemDelegate>
+#include <QStaticText>
+#include <QCache>
+#include <QFont>
+#include <array>
+
+/**
+ * @class TodoItemDelegate
+ * @brief Paints todo rows without querying the model on every frame
+ *
+ * The first paint of a row reads its title, category, completion and
+ * priority once and keeps the elided title and category as prepared
+ * QStaticText layouts. Later paints, such as the ones scrolling
+ * produces, draw from that cache without calling data() or building
+ * strings. Priority badges are shared by all rows.
+ *
+ * Entries are keyed by row. A dataChanged drops the rows it covers;
+ * anything that moves rows drops the whole cache. Entries are also
+ * laid out again when the row width or the font changes.
+ *
+ * Every row has the same height, so the view can use uniformItemSizes.
+ */
+class TodoItemDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    /// Rows whose layouts are kept; a screenful is far below this
+    static constexpr int kCachedRows = 512;
+
+    /**
+     * @brief Construct a delegate for the rows of a model
+     * @param model Model whose changes invalidate the cache
+     * @param parent Parent object, usually the view
+     */
+    explicit TodoItemDelegate(QAbstractItemModel *model, QObject *parent = nullptr);
+
+    /**
+     * @brief Paint one row
+     * @param painter Painter of the view's viewport
+     * @param option Geometry, palette and state of the row
+     * @param index Row to paint
+     */
+    void paint(QPainter *painter, const QStyleOptionViewItem &option,
+               const QModelIndex &index) const override;
+
+    /**
+     * @brief Get the size of a row
+     * @param option Style options of the view
+     * @param index Row, unused since every row has the same height
+     * @return Row size
+     */
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+
+protected:
+    /**
+     * @brief Toggle completion when the checkbox is clicked
+     * @return true if the event was handled
+     */
+    bool editorEvent(QEvent *event, QAbstractItemModel *model,
+                     const QStyleOptionViewItem &option, const QModelIndex &index) override;
+
+private:
+    /**
+     * @struct RowLayout
+     * @brief Prepared text and state of one row
+     */
+    struct RowLayout {
+        QStaticText title;      ///< Elided title
+        QStaticText category;   ///< Elided category, empty if none
+        int categoryWidth = 0;  ///< Advance of the elided category
+        int width = 0;          ///< Row width the texts were elided for
+        bool completed = false; ///< Draws the title struck out and dimmed
+        int priority = 0;       ///< TodoItem::Priority, selects the badge
+    };
+
+    /**
+     * @struct Badge
+     * @brief Prepared label of one priority level
+     */
+    struct Badge {
+        QStaticText text;       ///< Priority name
+        int width = 0;          ///< Width of the badge including padding
+    };
+
+    mutable QCache<int, RowLayout> m_rows;  ///< Row -> layout
+    mutable std::array<Badge, 4> m_badges;  ///< Indexed by TodoItem::Priority
+    mutable QFont m_font;                   ///< Font the cache was built with
+
+    /**
+     * @brief Get the layout of a row, building it on a cache miss
+     * @param option Style options of the row
+     * @param index Row
+     * @return Layout owned by the cache
+     */
+    const RowLayout& rowLayout(const QStyleOptionViewItem &option, const QModelIndex &index) const;
+
+    /**
+     * @brief Drop every cached layout if the view font changed
+     * @param font Font of the row being painted
+     */
+    void checkFont(const QFont &font) const;
+
+    /**
+     * @brief Get the checkbox rectangle of a row
+     * @param option Style options of the row
+     * @return Indicator geometry inside option.rect
+     */
+    static QRect checkRect(const QStyleOptionViewItem &option);
+
+    /**
+     * @brief Drop the layouts of a range of rows
+     * @param topLeft First changed row
+     * @param bottomRight Last changed row
+     */
+    void invalidateRows(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+
+    /**
+     * @brief Drop every cached layout
+     */
+    void invalidateAll();
+};
+
+#endif // TODOITEMDELEGATE_H
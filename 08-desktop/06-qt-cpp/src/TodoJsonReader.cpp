@@ -0,0 +1,248 @@
+/**
+ * @file TodoJsonReader.cpp
+ * @brief Implementation of TodoJsonReader class
+ */
+
+#include "TodoJsonReader.h"
+#include <QIODevice>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+
+namespace {
+
+/// Bytes read from the device at a time
+constexpr qint64 kChunkSize = 64 * 1024;
+
+/**
+ * @brief Check for JSON whitespace
+ */
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+/**
+ * @brief Check for a byte that ends a number or literal
+ */
+bool isDelimiter(char c)
+{
+    return c == ',' || c == '}' || c == ']' || isSpace(c);
+}
+
+} // namespace
+
+/**
+ * @brief Constructor implementation
+ */
+TodoJsonReader::TodoJsonReader(QIODevice* device)
+    : m_device(device)
+{
+}
+
+/**
+ * @brief Read the next items
+ */
+int TodoJsonReader::readBatch(QVector<TodoItem>& batch, int maxItems)
+{
+    int added = 0;
+    char c = 0;
+
+    while (added < maxItems && !atEnd()) {
+        switch (m_state) {
+            case State::Start:
+                if (!peekToken(c) || c != '{') {
+                    fail("Invalid JSON format: root is not an object");
+                    break;
+                }
+                ++m_pos;
+                m_state = State::RootMembers;
+                break;
+
+            case State::RootMembers: {
+                if (!peekToken(c)) {
+                    fail("Unexpected end of file");
+                    break;
+                }
+                if (c == '}') {
+                    fail("Invalid JSON format: missing 'todos' array");
+                    break;
+                }
+                if (c == ',') {
+                    ++m_pos;
+                    break;
+                }
+
+                QByteArray key;
+                if (c != '"' || !skipValue(&key) || !expect(':')) {
+                    fail("Invalid JSON format: expected a member name");
+                    break;
+                }
+
+                if (key == "\"todos\"") {
+                    if (expect('['))
+                        m_state = State::TodoArray;
+                } else {
+                    skipValue(nullptr);
+                }
+                break;
+            }
+
+            case State::TodoArray: {
+                if (!peekToken(c)) {
+                    fail("Unexpected end of file");
+                    break;
+                }
+                if (c == ']') {
+                    ++m_pos;
+                    m_state = State::Done;
+                    break;
+                }
+                if (c == ',') {
+                    ++m_pos;
+                    break;
+                }
+                if (c != '{') {
+                    skipValue(nullptr);
+                    break;
+                }
+
+                // resize() keeps the capacity, so elements reuse one buffer
+                m_element.resize(0);
+                if (!skipValue(&m_element))
+                    break;
+
+                QJsonParseError parseError;
+                const QJsonDocument doc = QJsonDocument::fromJson(m_element, &parseError);
+                if (parseError.error != QJsonParseError::NoError) {
+                    fail(QString("JSON parse error near byte %1: %2")
+                             .arg(m_bytesRead - (m_buffer.size() - m_pos))
+                             .arg(parseError.errorString()));
+                    break;
+                }
+
+                batch.append(TodoItem::fromJson(doc.object()));
+                ++added;
+                break;
+            }
+
+            case State::Done:
+            case State::Failed:
+                break;
+        }
+    }
+
+    return added;
+}
+
+/**
+ * @brief Make sure an unread byte is buffered
+ */
+bool TodoJsonReader::fill()
+{
+    if (m_pos < m_buffer.size())
+        return true;
+
+    m_buffer = m_device->read(kChunkSize);
+    m_pos = 0;
+    m_bytesRead += m_buffer.size();
+    return !m_buffer.isEmpty();
+}
+
+/**
+ * @brief Look at the next non-whitespace byte
+ */
+bool TodoJsonReader::peekToken(char& c)
+{
+    while (fill()) {
+        c = m_buffer.at(m_pos);
+        if (!isSpace(c))
+            return true;
+        ++m_pos;
+    }
+    return false;
+}
+
+/**
+ * @brief Consume one complete JSON value
+ *
+ * Strings and containers are scanned for their closing byte while
+ * tracking nesting and escapes; whole chunk ranges are copied at once.
+ */
+bool TodoJsonReader::skipValue(QByteArray* capture)
+{
+    char c = 0;
+    if (!peekToken(c))
+        return fail("Unexpected end of file");
+
+    if (c != '{' && c != '[' && c != '"') {
+        // Number, true, false or null: runs up to the next delimiter
+        while (fill() && !isDelimiter(m_buffer.at(m_pos))) {
+            if (capture)
+                capture->append(m_buffer.at(m_pos));
+            ++m_pos;
+        }
+        return true;
+    }
+
+    int depth = 0;
+    bool inString = false;
+    bool escaped = false;
+    do {
+        if (!fill())
+            return fail("Unexpected end of file");
+
+        const int start = m_pos;
+        while (m_pos < m_buffer.size()) {
+            c = m_buffer.at(m_pos++);
+            if (inString) {
+                if (escaped)
+                    escaped = false;
+                else if (c == '\\')
+                    escaped = true;
+                else if (c == '"')
+                    inString = false;
+            } else if (c == '"') {
+                inString = true;
+            } else if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                --depth;
+            }
+
+            if (depth == 0 && !inString)
+                break;
+        }
+
+        if (capture)
+            capture->append(m_buffer.constData() + start, m_pos - start);
+    } while (depth > 0 || inString);
+
+    return true;
+}
+
+/**
+ * @brief Consume an expected structural byte
+ */
+bool TodoJsonReader::expect(char expected)
+{
+    char c = 0;
+    if (!peekToken(c) || c != expected)
+        return fail(QString("Invalid JSON format: expected '%1'").arg(QLatin1Char(expected)));
+
+    ++m_pos;
+    return true;
+}
+
+/**
+ * @brief Stop reading with an error
+ */
+bool TodoJsonReader::fail(const QString& message)
+{
+    if (m_state != State::Failed) {
+        m_state = State::Failed;
+        m_error = message;
+        qWarning() << "Import failed:" << message;
+    }
+    return false;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file TodoJsonReader.h
+ * @brief Streaming reader for exported todo lists
+ *
+ * This file defines the TodoJsonReader class which pulls todo items out
+ * of an export file one array element at a time, without building a
+ * QJsonDocument for the whole file.
+ */
+
+#ifndef TODOJSONREADER_H
+#define TODOJSONREADER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include "TodoItem.h"
+
+class QIODevice;
+
+/**
+ * @class TodoJsonReader
+ * @brief Pull parser for the "todos" array of an export file
+ *
+ * The reader scans the root object in fixed-size chunks, skips every
+ * member other than "todos" and hands each element of that array to
+ * QJsonDocument on its own. Memory use is bounded by the chunk size, the
+ * largest single element and the batch the caller asks for, regardless
+ * of the file size.
+ *
+ * Only the structure needed to find element boundaries is checked here;
+ * each element is then validated by QJsonDocument. Elements that are
+ * not objects are skipped, as in StorageManager::importFromJson().
+ */
+class TodoJsonReader
+{
+public:
+    /**
+     * @brief Constructor
+     * @param device Open device positioned at the start of the export
+     */
+    explicit TodoJsonReader(QIODevice* device);
+
+    /**
+     * @brief Read the next items
+     * @param batch Receives up to @p maxItems items, appended
+     * @param maxItems Maximum number of items to read
+     * @return Number of items appended; 0 once atEnd()
+     */
+    int readBatch(QVector<TodoItem>& batch, int maxItems);
+
+    /**
+     * @brief Check whether reading has stopped
+     * @return true after the end of the array or an error
+     */
+    bool atEnd() const { return m_state == State::Done || m_state == State::Failed; }
+
+    /**
+     * @brief Check whether reading stopped because of an error
+     * @return true if the file is not a valid export
+     */
+    bool hasError() const { return m_state == State::Failed; }
+
+    /**
+     * @brief Get a description of the last error
+     * @return Error message, empty if none occurred
+     */
+    QString errorString() const { return m_error; }
+
+    /**
+     * @brief Get the number of bytes read from the device so far
+     * @return Byte count, for progress reporting
+     */
+    qint64 bytesRead() const { return m_bytesRead; }
+
+private:
+    /**
+     * @enum State
+     * @brief Position of the reader in the export structure
+     */
+    enum class State {
+        Start,          ///< Before the root object
+        RootMembers,    ///< Between members of the root object
+        TodoArray,      ///< Between elements of the "todos" array
+        Done,           ///< After the "todos" array
+        Failed          ///< Stopped on an error
+    };
+
+    QIODevice *m_device;                ///< Source device (not owned)
+    QByteArray m_buffer;                ///< Current chunk
+    int m_pos = 0;                      ///< Read position in m_buffer
+    qint64 m_bytesRead = 0;             ///< Bytes read from m_device
+    State m_state = State::Start;       ///< Parser state
+    QString m_error;                    ///< Last error message
+    QByteArray m_element;               ///< Raw bytes of the current element
+
+    /**
+     * @brief Make sure an unread byte is buffered, reading the next chunk
+     * @return false at the end of the device
+     */
+    bool fill();
+
+    /**
+     * @brief Look at the next non-whitespace byte without consuming it
+     * @param c Receives the byte
+     * @return false at the end of the device
+     */
+    bool peekToken(char& c);
+
+    /**
+     * @brief Consume one complete JSON value
+     * @param capture Receives the raw bytes of the value if not null
+     * @return false on a premature end of the device
+     */
+    bool skipValue(QByteArray* capture);
+
+    /**
+     * @brief Consume an expected structural byte
+     * @param expected Byte that must come next, after whitespace
+     * @return false if a different byte or the end came first
+     */
+    bool expect(char expected);
+
+    /**
+     * @brief Stop reading with an error
+     * @param message Error message
+     * @return false, for use in return statements
+     */
+    bool fail(const QString& message);
+};
+
+#endif // TODOJSONREADER_H
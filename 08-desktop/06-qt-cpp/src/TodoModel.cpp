@@ -5,19 +5,81 @@
 
 #include "TodoModel.h"
 #include "StorageManager.h"
+#include "SaveScheduler.h"
 #include <QDebug>
 #include <algorithm>
+#include <utility>
+
+namespace {
+
+/// Removed slots are only reclaimed once there are this many of them
+constexpr int kMinTombstonesForCompaction = 1024;
+
+/// Above this many separate row blocks one reset is cheaper for views
+/// than a notification per block
+constexpr int kMaxRowRanges = 256;
+
+/// Larger batches of new items are merged into the sort order at once
+/// instead of being placed one by one
+constexpr int kMaxSortedInserts = 16;
+
+/**
+ * @brief Get the preset query a filter mode stands for
+ */
+TodoQuery queryForMode(TodoModel::FilterMode mode)
+{
+    switch (mode) {
+        case TodoModel::FilterMode::Active:
+            return TodoQuery::completed(false);
+        case TodoModel::FilterMode::Completed:
+            return TodoQuery::completed(true);
+        default:
+            return TodoQuery();
+    }
+}
+
+/**
+ * @brief Check whether a slot already holds every field of an item
+ */
+bool sameContents(const TodoStore& store, int slot, const TodoItem& item)
+{
+    return store.modifiedAtMs(slot) == item.modifiedAtMs()
+           && store.createdAtMs(slot) == item.createdAtMs()
+           && store.isCompleted(slot) == item.isCompleted()
+           && store.priority(slot) == item.getPriority()
+           && store.category(slot) == item.getCategory()
+           && store.title(slot) == item.getTitle();
+}
+
+} // namespace
 
 /**
  * @brief Constructor implementation
  */
 TodoModel::TodoModel(QObject *parent)
+    : TodoModel(StorageManager::StorageBackend::Journal, parent)
+{
+}
+
+/**
+ * @brief Constructor with a storage backend
+ */
+TodoModel::TodoModel(StorageManager::StorageBackend backend, QObject *parent)
     : QAbstractListModel(parent)
     , m_filterMode(FilterMode::All)
-    , m_storage(std::make_unique<StorageManager>())
+    , m_storage(std::make_unique<StorageManager>(backend))
 {
-    // Load data from storage on initialization
-    loadFromStorage();
+    m_saveScheduler = std::make_unique<SaveScheduler>(m_storage.get(), [this]() { return m_store; });
+    m_saveScheduler->setStatisticsProvider([this]() { return m_statistics; });
+    connect(m_saveScheduler.get(), &SaveScheduler::saveFinished, this, &TodoModel::saveFinished);
+    connect(m_saveScheduler.get(), &SaveScheduler::loaded, this, &TodoModel::onStoreLoaded);
+    connect(m_saveScheduler.get(), &SaveScheduler::externalChanges, this, &TodoModel::mergeExternalChanges);
+    connect(m_saveScheduler.get(), &SaveScheduler::categorySummariesRead, this, &TodoModel::onCategorySummariesRead);
+
+    // Zero interval: each chunk waits for the events queued before it
+    m_revealTimer.setSingleShot(true);
+    m_revealTimer.setInterval(0);
+    connect(&m_revealTimer, &QTimer::timeout, this, &TodoModel::revealLoadedRows);
 }
 
 /**
@@ -25,8 +87,12 @@ TodoModel::TodoModel(QObject *parent)
  */
 TodoModel::~TodoModel()
 {
-    // Auto-save on destruction
+    // Flush pending edits before the storage manager goes away
     saveToStorage();
+
+    // The scheduler flushes again when destroyed if the save above failed,
+    // and its providers read m_store and m_statistics, so it goes first
+    m_saveScheduler.reset();
 }
 
 /**
@@ -37,7 +103,7 @@ int TodoModel::rowCount(const QModelIndex &parent) const
     if (parent.isValid())
         return 0;
 
-    return m_filteredIndices.size();
+    return m_visibleRows.count();
 }
 
 /**
@@ -45,43 +111,42 @@ int TodoModel::rowCount(const QModelIndex &parent) const
  */
 QVariant TodoModel::data(const QModelIndex &index, int role) const
 {
-    if (!index.isValid() || index.row() >= m_filteredIndices.size())
+    if (!index.isValid() || index.row() >= m_visibleRows.count())
         return QVariant();
 
     int actualIndex = getActualIndex(index.row());
-    if (actualIndex < 0 || actualIndex >= m_todos.size())
+    if (actualIndex < 0 || actualIndex >= m_store.size())
         return QVariant();
 
-    const TodoItem& item = m_todos.at(actualIndex);
-
+    // Read only the column the role needs
     switch (role) {
         case Qt::DisplayRole:
         case TitleRole:
-            return item.getTitle();
+            return m_store.title(actualIndex);
 
         case CompletedRole:
-            return item.isCompleted();
+            return m_store.isCompleted(actualIndex);
 
         case PriorityRole:
-            return item.priorityValue();
+            return static_cast<int>(m_store.priority(actualIndex));
 
         case PriorityStringRole:
-            return item.priorityString();
+            return TodoItem::priorityToString(m_store.priority(actualIndex));
 
         case CreatedAtRole:
-            return item.getCreatedAt();
+            return m_store.createdAt(actualIndex);
 
         case ModifiedAtRole:
-            return item.getModifiedAt();
+            return m_store.modifiedAt(actualIndex);
 
         case CategoryRole:
-            return item.getCategory();
+            return m_store.category(actualIndex);
 
         case IdRole:
-            return item.getId();
+            return m_store.id(actualIndex).toString(QUuid::WithoutBraces);
 
         case Qt::CheckStateRole:
-            return item.isCompleted() ? Qt::Checked : Qt::Unchecked;
+            return m_store.isCompleted(actualIndex) ? Qt::Checked : Qt::Unchecked;
 
         default:
             return QVariant();
@@ -93,47 +158,70 @@ QVariant TodoModel::data(const QModelIndex &index, int role) const
  */
 bool TodoModel::setData(const QModelIndex &index, const QVariant &value, int role)
 {
-    if (!index.isValid() || index.row() >= m_filteredIndices.size())
+    if (!index.isValid() || index.row() >= m_visibleRows.count())
         return false;
 
     int actualIndex = getActualIndex(index.row());
-    if (actualIndex < 0 || actualIndex >= m_todos.size())
+    if (actualIndex < 0 || actualIndex >= m_store.size())
         return false;
 
-    TodoItem& item = m_todos[actualIndex];
+    return setItemData(actualIndex, value, role);
+}
+
+/**
+ * @brief Set data for a given role on the item in a slot of the store
+ */
+bool TodoModel::setItemData(int actualIndex, const QVariant &value, int role)
+{
     bool changed = false;
 
     switch (role) {
         case Qt::EditRole:
         case TitleRole:
             if (value.canConvert<QString>()) {
-                item.setTitle(value.toString());
-                changed = true;
+                const QString oldTitle = m_store.title(actualIndex);
+                unindexSearchSlot(actualIndex);
+                if (m_store.setTitle(actualIndex, value.toString())) {
+                    recordUndo(tr("Edit Title"), UndoOp::setTitle(m_store.id(actualIndex), oldTitle));
+                    changed = true;
+                }
+                indexSearchSlot(actualIndex);
             }
             break;
 
         case CompletedRole:
         case Qt::CheckStateRole:
-            if (value.canConvert<bool>()) {
-                item.setCompleted(value.toBool());
-                changed = true;
-            }
-            break;
+            // Completion can change filter membership, so it takes the batch path
+            if (value.canConvert<bool>())
+                return setCompleted({m_store.id(actualIndex)}, value.toBool()) > 0;
+            return false;
 
         case PriorityRole:
             if (value.canConvert<int>()) {
                 int priorityValue = value.toInt();
                 if (priorityValue >= 0 && priorityValue <= 3) {
-                    item.setPriority(static_cast<TodoItem::Priority>(priorityValue));
-                    changed = true;
+                    const TodoItem::Priority oldPriority = m_store.priority(actualIndex);
+                    m_statistics.remove(actualIndex, m_store);
+                    if (m_store.setPriority(actualIndex, static_cast<TodoItem::Priority>(priorityValue))) {
+                        recordUndo(tr("Change Priority"), UndoOp::setPriority(m_store.id(actualIndex), oldPriority));
+                        changed = true;
+                    }
+                    m_statistics.insert(actualIndex, m_store);
                 }
             }
             break;
 
         case CategoryRole:
             if (value.canConvert<QString>()) {
-                item.setCategory(value.toString());
-                changed = true;
+                const QString oldCategory = m_store.category(actualIndex);
+                unindexSearchSlot(actualIndex);
+                m_categoryIndex.remove(actualIndex, m_store);
+                if (m_store.setCategory(actualIndex, value.toString())) {
+                    recordUndo(tr("Change Category"), UndoOp::setCategory(m_store.id(actualIndex), oldCategory));
+                    changed = true;
+                }
+                m_categoryIndex.insert(actualIndex, m_store);
+                indexSearchSlot(actualIndex);
             }
             break;
 
@@ -142,10 +230,12 @@ bool TodoModel::setData(const QModelIndex &index, const QVariant &value, int rol
     }
 
     if (changed) {
-        emit dataChanged(index, index, {role});
+        const TodoItem item = m_store.item(actualIndex);
+        m_saveScheduler->markDirty(TodoChange::upsert(item));
+        repositionSlots({actualIndex});
+        updateVisibility({actualIndex}, {role});
         emit todoUpdated(item);
         emit countsChanged();
-        saveToStorage();
         return true;
     }
 
@@ -197,21 +287,53 @@ bool TodoModel::addTodo(const QString& title, TodoItem::Priority priority)
  */
 bool TodoModel::addTodo(const TodoItem& item)
 {
-    // Add to the main list
-    m_todos.append(item);
+    return addTodos(QVector<TodoItem>{item}) == 1;
+}
 
-    // Check if the new item passes the current filter
-    if (passesFilter(item)) {
-        int filteredRow = m_filteredIndices.size();
-        beginInsertRows(QModelIndex(), filteredRow, filteredRow);
-        m_filteredIndices.append(m_todos.size() - 1);
-        endInsertRows();
+/**
+ * @brief Add several todo items with one notification and one save
+ */
+int TodoModel::addTodos(QVector<TodoItem>&& items)
+{
+    if (items.isEmpty())
+        return 0;
+
+    const int firstIndex = m_store.size();
+    const int count = items.size();
+
+    // Slots past the end of m_visibleRows are not rows yet, so the store
+    // can take the items before views are told about them
+    TodoChangeList changes;
+    QVector<QUuid> ids;
+    changes.reserve(count);
+    ids.reserve(count);
+    m_store.reserve(firstIndex + count);
+    m_idIndex.reserve(firstIndex + count);
+    for (int i = 0; i < count; ++i) {
+        // Re-importing an export must not produce two items with one id
+        if (m_idIndex.contains(items[i].getUuid()))
+            items[i].setId(QUuid::createUuid());
+        m_idIndex.insert(items[i].getUuid(), firstIndex + i);
+
+        if (items[i].isCompleted())
+            ++m_completedCount;
+        m_store.append(items[i]);
+        // Undo and redo bring items back, they do not create them
+        if (!m_undoCapture)
+            m_statistics.recordCreated(m_store.createdAtMs(firstIndex + i));
+        changes.append(TodoChange::upsert(items[i]));
+        ids.append(items[i].getUuid());
     }
 
-    emit todoAdded(item);
+    appendRows(firstIndex);
+    recordUndo(tr("Add %n Todo(s)", nullptr, count), UndoOp::remove(ids));
+
+    verifyCounts();
+    for (const TodoItem& item : std::as_const(items))
+        emit todoAdded(item);
     emit countsChanged();
-    saveToStorage();
-    return true;
+    m_saveScheduler->markDirty(changes);
+    return count;
 }
 
 /**
@@ -230,49 +352,119 @@ bool TodoModel::removeTodo(const QModelIndex& index)
  */
 bool TodoModel::removeTodo(int row)
 {
-    if (row < 0 || row >= m_filteredIndices.size())
+    int actualIndex = getActualIndex(row);
+    if (actualIndex < 0 || actualIndex >= m_store.size())
+        return false;
+
+    return removeTodos({m_store.id(actualIndex)}) == 1;
+}
+
+/**
+ * @brief Remove a todo by ID
+ */
+bool TodoModel::removeTodoById(const QUuid& id)
+{
+    return removeTodos({id}) == 1;
+}
+
+/**
+ * @brief Toggle completion status by ID
+ */
+bool TodoModel::toggleTodoById(const QUuid& id)
+{
+    const int actualIndex = indexForId(id);
+    if (actualIndex < 0)
         return false;
 
-    int actualIndex = getActualIndex(row);
-    if (actualIndex < 0 || actualIndex >= m_todos.size())
+    return setCompleted({id}, !m_store.isCompleted(actualIndex)) == 1;
+}
+
+/**
+ * @brief Update todo title by ID
+ */
+bool TodoModel::updateTodoTitleById(const QUuid& id, const QString& newTitle)
+{
+    const int actualIndex = indexForId(id);
+    if (actualIndex < 0 || newTitle.trimmed().isEmpty())
         return false;
 
-    QString removedId = m_todos[actualIndex].getId();
+    return setItemData(actualIndex, newTitle.trimmed(), TitleRole);
+}
+
+/**
+ * @brief Update todo priority by ID
+ */
+bool TodoModel::updateTodoPriorityById(const QUuid& id, TodoItem::Priority priority)
+{
+    const int actualIndex = indexForId(id);
+    if (actualIndex < 0)
+        return false;
 
-    // Remove from filtered view
-    beginRemoveRows(QModelIndex(), row, row);
-    m_filteredIndices.removeAt(row);
+    return setItemData(actualIndex, static_cast<int>(priority), PriorityRole);
+}
 
-    // Remove from main list
-    m_todos.removeAt(actualIndex);
+/**
+ * @brief Get todo item by ID
+ */
+TodoItem TodoModel::getTodoItemById(const QUuid& id) const
+{
+    const int actualIndex = indexForId(id);
+    if (actualIndex < 0)
+        return TodoItem();
 
-    // Update filtered indices (all indices >= actualIndex need to be decremented)
-    for (int i = 0; i < m_filteredIndices.size(); ++i) {
-        if (m_filteredIndices[i] > actualIndex) {
-            m_filteredIndices[i]--;
-        }
-    }
+    return m_store.item(actualIndex);
+}
 
-    endRemoveRows();
+/**
+ * @brief Check whether a todo with the given ID exists
+ */
+bool TodoModel::containsTodo(const QUuid& id) const
+{
+    return m_idIndex.contains(id);
+}
 
-    emit todoRemoved(removedId);
-    emit countsChanged();
-    saveToStorage();
-    return true;
+/**
+ * @brief Get the model index of a todo by ID
+ */
+QModelIndex TodoModel::modelIndexForId(const QUuid& id) const
+{
+    const int row = rowForIndex(indexForId(id));
+    return row >= 0 ? index(row, 0) : QModelIndex();
 }
 
 /**
- * @brief Remove a todo by ID
+ * @brief Remove several todos with one notification and one save
  */
-bool TodoModel::removeTodoById(const QString& id)
+int TodoModel::removeTodos(const QVector<QUuid>& ids)
 {
-    for (int i = 0; i < m_filteredIndices.size(); ++i) {
-        int actualIndex = getActualIndex(i);
-        if (actualIndex >= 0 && m_todos[actualIndex].getId() == id) {
-            return removeTodo(i);
-        }
+    if (ids.isEmpty())
+        return 0;
+
+    QVector<int> indices = indicesForIds(ids);
+    if (indices.isEmpty())
+        return 0;
+
+    QVector<QUuid> removedIds;
+    QVector<TodoItem> removedItems;
+    TodoChangeList changes;
+    removedIds.reserve(indices.size());
+    removedItems.reserve(indices.size());
+    changes.reserve(indices.size());
+    for (int index : indices) {
+        removedIds.append(m_store.id(index));
+        removedItems.append(m_store.item(index));
+        changes.append(TodoChange::remove(removedIds.last()));
     }
-    return false;
+
+    recordUndo(tr("Remove %n Todo(s)", nullptr, int(indices.size())), UndoOp::restore(removedItems, indices));
+    eraseIndices(indices);
+    verifyCounts();
+
+    for (const QUuid& id : removedIds)
+        emit todoRemoved(id.toString(QUuid::WithoutBraces));
+    emit countsChanged();
+    m_saveScheduler->markDirty(changes);
+    return indices.size();
 }
 
 /**
@@ -291,31 +483,57 @@ bool TodoModel::toggleTodo(const QModelIndex& index)
  */
 bool TodoModel::toggleTodo(int row)
 {
-    if (row < 0 || row >= m_filteredIndices.size())
-        return false;
-
     int actualIndex = getActualIndex(row);
-    if (actualIndex < 0 || actualIndex >= m_todos.size())
+    if (actualIndex < 0 || actualIndex >= m_store.size())
         return false;
 
-    m_todos[actualIndex].toggleCompleted();
+    return setCompleted({m_store.id(actualIndex)}, !m_store.isCompleted(actualIndex)) == 1;
+}
+
+/**
+ * @brief Set completion status of several todos with one notification and one save
+ */
+int TodoModel::setCompleted(const QVector<QUuid>& ids, bool completed)
+{
+    if (ids.isEmpty())
+        return 0;
+
+    QVector<int> indices = indicesForIds(ids);
+    indices.erase(std::remove_if(indices.begin(), indices.end(),
+                                 [this, completed](int index) {
+                                     return m_store.isCompleted(index) == completed;
+                                 }),
+                  indices.end());
 
-    // Check if item still passes filter after toggle
-    if (!passesFilter(m_todos[actualIndex])) {
-        // Item no longer passes filter, remove it from filtered view
-        beginRemoveRows(QModelIndex(), row, row);
-        m_filteredIndices.removeAt(row);
-        endRemoveRows();
-    } else {
-        // Item still passes filter, just update the data
-        QModelIndex idx = index(row, 0);
-        emit dataChanged(idx, idx);
+    if (indices.isEmpty())
+        return 0;
+
+    TodoChangeList changes;
+    QVector<QUuid> changedIds;
+    changes.reserve(indices.size());
+    changedIds.reserve(indices.size());
+    for (int index : indices) {
+        const qint64 previousModifiedMs = m_store.modifiedAtMs(index);
+        m_store.setCompleted(index, completed);
+        m_categoryIndex.completionChanged(index, m_store);
+        m_statistics.completionChanged(index, m_store, previousModifiedMs);
+        changes.append(TodoChange::upsert(m_store.item(index)));
+        changedIds.append(m_store.id(index));
     }
+    const int changed = static_cast<int>(indices.size());
+    m_completedCount += completed ? changed : -changed;
+    verifyCounts();
+    recordUndo(completed ? tr("Complete %n Todo(s)", nullptr, changed) : tr("Reopen %n Todo(s)", nullptr, changed),
+               UndoOp::setCompleted(changedIds, !completed));
 
-    emit todoUpdated(m_todos[actualIndex]);
+    repositionSlots(indices);
+    updateVisibility(indices, {CompletedRole, Qt::CheckStateRole});
+
+    for (const TodoChange& change : std::as_const(changes))
+        emit todoUpdated(change.item);
     emit countsChanged();
-    saveToStorage();
-    return true;
+    m_saveScheduler->markDirty(changes);
+    return indices.size();
 }
 
 /**
@@ -353,14 +571,14 @@ TodoItem TodoModel::getTodoItem(const QModelIndex& index) const
  */
 TodoItem TodoModel::getTodoItem(int row) const
 {
-    if (row < 0 || row >= m_filteredIndices.size())
+    if (row < 0 || row >= m_visibleRows.count())
         return TodoItem();
 
     int actualIndex = getActualIndex(row);
-    if (actualIndex < 0 || actualIndex >= m_todos.size())
+    if (actualIndex < 0 || actualIndex >= m_store.size())
         return TodoItem();
 
-    return m_todos.at(actualIndex);
+    return m_store.item(actualIndex);
 }
 
 /**
@@ -368,20 +586,16 @@ TodoItem TodoModel::getTodoItem(int row) const
  */
 int TodoModel::clearCompleted()
 {
-    int removedCount = 0;
-
-    // Remove in reverse order to avoid index issues
-    for (int i = m_filteredIndices.size() - 1; i >= 0; --i) {
-        int actualIndex = getActualIndex(i);
-        if (actualIndex >= 0 && actualIndex < m_todos.size()) {
-            if (m_todos[actualIndex].isCompleted()) {
-                removeTodo(i);
-                removedCount++;
-            }
-        }
+    QVector<QUuid> ids;
+    for (int i = 0; i < m_store.size(); ++i) {
+        if (m_store.isLive(i) && m_store.isCompleted(i))
+            ids.append(m_store.id(i));
     }
 
-    return removedCount;
+    beginUndoGroup(tr("Clear Completed"));
+    const int removed = removeTodos(ids);
+    endUndoGroup();
+    return removed;
 }
 
 /**
@@ -389,13 +603,74 @@ int TodoModel::clearCompleted()
  */
 void TodoModel::clearAll()
 {
+    if (totalCount() > 0)
+        recordUndo(tr("Clear All"), UndoOp::restore(m_store.toItems()));
+
+    const bool wasLoading = abortLoad();
+
     beginResetModel();
-    m_todos.clear();
-    m_filteredIndices.clear();
+    m_store.clear();
+    m_idIndex.clear();
+    m_categoryIndex.rebuild(m_store);
+    m_statistics.rebuildCounts(m_store);
+    rebuildSearch();
+    rebuildQueryMatches();
+    m_sorter.sort(m_store);
+    m_visibleRows.clear();
+    m_completedCount = 0;
     endResetModel();
 
+    // Nothing is left in storage that the model does not hold
+    setLoadedScope(QStringList());
+    m_saveScheduler->markDirty(TodoChange::clear());
     emit countsChanged();
-    saveToStorage();
+    if (wasLoading)
+        emit loadFinished(0);
+}
+
+/**
+ * @brief Revert the last action
+ */
+bool TodoModel::undo()
+{
+    if (!m_history.canUndo() || m_history.isGrouping())
+        return false;
+
+    const UndoHistory::Entry entry = m_history.takeUndo();
+    m_history.pushRedo(entry.text, replayUndo(entry.ops));
+    emit undoStackChanged();
+    return true;
+}
+
+/**
+ * @brief Repeat the last undone action
+ */
+bool TodoModel::redo()
+{
+    if (!m_history.canRedo() || m_history.isGrouping())
+        return false;
+
+    const UndoHistory::Entry entry = m_history.takeRedo();
+    m_history.pushUndo(entry.text, replayUndo(entry.ops));
+    emit undoStackChanged();
+    return true;
+}
+
+/**
+ * @brief Make the following edits one undo step
+ */
+void TodoModel::beginUndoGroup(const QString& text)
+{
+    m_history.beginGroup(text);
+}
+
+/**
+ * @brief Close the undo step opened by beginUndoGroup()
+ */
+void TodoModel::endUndoGroup()
+{
+    m_history.endGroup();
+    emit undoStackChanged();
 }
 
 /**
@@ -403,30 +678,186 @@ void TodoModel::clearAll()
  */
 void TodoModel::setFilterMode(FilterMode mode)
 {
-    if (m_filterMode == mode)
+    if (m_filterMode == mode || mode == FilterMode::Custom)
         return;
 
     m_filterMode = mode;
-    updateFilteredIndices();
+    applyQuery(queryForMode(mode));
+
     emit filterModeChanged(mode);
+    emit queryChanged();
+}
+
+/**
+ * @brief Show only the todos matching a query
+ */
+void TodoModel::setQuery(const TodoQuery& query)
+{
+    const TodoQuery compiled = query.compiled();
+    if (m_filterMode == FilterMode::Custom && compiled == m_query)
+        return;
+
+    applyQuery(compiled);
+
+    if (m_filterMode != FilterMode::Custom) {
+        m_filterMode = FilterMode::Custom;
+        emit filterModeChanged(m_filterMode);
+    }
+    emit queryChanged();
+}
+
+/**
+ * @brief Set the category filter
+ */
+void TodoModel::setCategoryFilter(const QString& category)
+{
+    // A null filter shows everything, an empty one the uncategorized items
+    if (category == m_categoryFilter && category.isNull() == m_categoryFilter.isNull())
+        return;
+
+    const QString previous = std::exchange(m_categoryFilter, category);
+
+    if (m_partiallyLoaded) {
+        if (category.isNull()) {
+            QStringList missing;
+            for (const StorageManager::CategorySummary& summary : std::as_const(m_storedSummaries)) {
+                if (!m_loadedCategories.contains(summary.category))
+                    missing.append(summary.category);
+            }
+            loadCategories(missing);
+            setLoadedScope(QStringList());
+        } else if (!m_loadedCategories.contains(category)) {
+            loadCategories({category});
+        }
+    }
+
+    if (previous.isNull() || category.isNull()) {
+        // Every item outside the one category changes membership
+        refilter();
+    } else {
+        // Only the items of the old and the new category can change rows;
+        // items loaded for the new one above may already be shown
+        QVector<int> hidden;
+        for (int index : m_categoryIndex.members(previous, m_store)) {
+            if (isVisible(index))
+                hidden.append(index);
+        }
+        QVector<int> shown;
+        for (int index : m_categoryIndex.members(category, m_store)) {
+            if (!isVisible(index) && passesFilter(index))
+                shown.append(index);
+        }
+        applyVisibility(hidden, shown);
+    }
+    emit categoryFilterChanged(category);
+}
+
+/**
+ * @brief Get per-category counts
+ */
+QVector<StorageManager::CategorySummary> TodoModel::categorySummaries() const
+{
+    QHash<QString, StorageManager::CategorySummary> held;
+    for (const QString& category : m_categoryIndex.categories(m_store)) {
+        const CategoryIndex::Counts counts = m_categoryIndex.counts(category, m_store);
+        StorageManager::CategorySummary& summary = held[category];
+        summary.category = category;
+        summary.count = counts.total();
+        summary.completed = counts.completed;
+    }
+
+    QVector<StorageManager::CategorySummary> summaries;
+    if (m_partiallyLoaded) {
+        // Categories not read yet are counted by the storage index, which
+        // also covers the items the model does not hold
+        for (const StorageManager::CategorySummary& stored : m_storedSummaries) {
+            if (!m_loadedCategories.contains(stored.category)) {
+                summaries.append(stored);
+                held.remove(stored.category);
+            }
+        }
+    }
+    for (const StorageManager::CategorySummary& summary : std::as_const(held))
+        summaries.append(summary);
+
+    std::sort(summaries.begin(), summaries.end(),
+              [](const StorageManager::CategorySummary& a, const StorageManager::CategorySummary& b) {
+                  return a.category < b.category;
+              });
+    return summaries;
 }
 
 /**
- * @brief Get count of active todos
+ * @brief Set the search string
  */
-int TodoModel::activeCount() const
+void TodoModel::setSearchText(const QString& text)
 {
-    return std::count_if(m_todos.begin(), m_todos.end(),
-                         [](const TodoItem& item) { return !item.isCompleted(); });
+    const QString search = text.trimmed();
+    if (search == m_searchText)
+        return;
+
+    const bool wasSearching = !m_searchText.isEmpty();
+    const QVector<int> previous = std::exchange(m_searchSlots, {});
+    for (int index : previous)
+        m_searchMatches.clearBit(index);
+
+    m_searchText = search;
+    if (!m_searchText.isEmpty()) {
+        m_searchSlots = findTextMatches(m_searchText);
+        for (int index : std::as_const(m_searchSlots))
+            m_searchMatches.setBit(index);
+    }
+
+    if (!wasSearching || m_searchText.isEmpty()) {
+        // Starting or ending a search changes every item's membership
+        refilter();
+    } else {
+        // Only items that matched before or match now can change rows;
+        // walk both ascending lists together
+        QVector<int> hidden;
+        QVector<int> shown;
+        auto before = previous.cbegin();
+        auto after = m_searchSlots.cbegin();
+        while (before != previous.cend() || after != m_searchSlots.cend()) {
+            if (after == m_searchSlots.cend() || (before != previous.cend() && *before < *after)) {
+                if (isVisible(*before))
+                    hidden.append(*before);
+                ++before;
+            } else if (before == previous.cend() || *after < *before) {
+                if (passesFilter(*after))
+                    shown.append(*after);
+                ++after;
+            } else {
+                ++before;
+                ++after;
+            }
+        }
+        applyVisibility(hidden, shown);
+    }
+
+    emit searchTextChanged(m_searchText);
 }
 
 /**
- * @brief Get count of completed todos
+ * @brief Re-evaluate the filter for every item
  */
-int TodoModel::completedCount() const
+void TodoModel::refilter()
 {
-    return std::count_if(m_todos.begin(), m_todos.end(),
-                         [](const TodoItem& item) { return item.isCompleted(); });
+    // Diff old and new membership so views keep their scroll position
+    // and selection instead of seeing a reset
+    QVector<int> hidden;
+    QVector<int> shown;
+    for (int i = 0; i < m_store.size(); ++i) {
+        if (!m_store.isLive(i))
+            continue;
+        const bool wasVisible = isVisible(i);
+        const bool visible = passesFilter(i);
+        if (wasVisible && !visible)
+            hidden.append(i);
+        else if (!wasVisible && visible)
+            shown.append(i);
+    }
+    applyVisibility(hidden, shown);
 }
 
 /**
@@ -434,66 +865,1093 @@ int TodoModel::completedCount() const
  */
 bool TodoModel::loadFromStorage()
 {
-    QVector<TodoItem> loadedTodos = m_storage->loadTodos();
+    // Let queued writes land first so the reload sees them
+    m_saveScheduler->flush();
+    m_storage->loadStatistics(m_statistics);
+    const QStringList scope = loadScope();
+    TodoStore loadedStore = m_storage->loadStore(scope);
+    setLoadedScope(scope);
+    if (m_partiallyLoaded)
+        m_storedSummaries = m_storage->categorySummaries();
+    const bool wasLoading = abortLoad();
 
     beginResetModel();
-    m_todos = loadedTodos;
-    updateFilteredIndices();
+    m_store = std::move(loadedStore);
+    rebuildIdIndex();
+    m_categoryIndex.rebuild(m_store);
+    m_statistics.rebuildCounts(m_store);
+    rebuildSearch();
+    rebuildQueryMatches();
+    m_sorter.sort(m_store);
+    rebuildVisibleRows();
+    m_completedCount = m_store.countCompleted();
     endResetModel();
 
     emit countsChanged();
+    if (wasLoading)
+        emit loadFinished(totalCount());
     return true;
 }
 
 /**
- * @brief Save todos to storage
+ * @brief Start loading todos on the storage thread
  */
-bool TodoModel::saveToStorage()
+bool TodoModel::loadFromStorageAsync()
 {
-    return m_storage->saveTodos(m_todos);
+    if (isLoading())
+        return false;
+
+    m_saveScheduler->flush();
+    m_storage->loadStatistics(m_statistics);
+
+    beginResetModel();
+    m_store.clear();
+    m_idIndex.clear();
+    m_categoryIndex.rebuild(m_store);
+    m_statistics.rebuildCounts(m_store);
+    rebuildSearch();
+    rebuildQueryMatches();
+    m_sorter.sort(m_store);
+    m_visibleRows.clear();
+    m_completedCount = 0;
+    endResetModel();
+    emit countsChanged();
+
+    const QStringList scope = loadScope();
+    setLoadedScope(scope);
+    m_awaitingLoad = true;
+    m_saveScheduler->load(scope);
+    return true;
 }
 
 /**
- * @brief Update filtered indices based on current filter
+ * @brief Take over the list read on the storage thread
+ *
+ * The store is adopted as a whole, so by-id edits, counts and saves see
+ * every item right away. Only rows are handed out in chunks: slots not
+ * yet revealed fail the filter and stay hidden from views.
  */
-void TodoModel::updateFilteredIndices()
+void TodoModel::onStoreLoaded(const TodoStore& loaded)
 {
-    beginResetModel();
-    m_filteredIndices.clear();
+    // Superseded by clearAll() or loadFromStorage()
+    if (!m_awaitingLoad)
+        return;
+    m_awaitingLoad = false;
+
+    TodoStore merged = loaded;
+    const int loadedSlots = merged.size();
+    const bool hasNewItems = m_store.liveCount() > 0;
+
+    // Items added while the list was being read go behind the saved
+    // ones; one that reuses a saved id replaces it, as the journal would
+    if (hasNewItems) {
+        QHash<QUuid, int> savedSlots;
+        savedSlots.reserve(loadedSlots);
+        for (int i = 0; i < loadedSlots; ++i) {
+            if (merged.isLive(i))
+                savedSlots.insert(merged.id(i), i);
+        }
 
-    for (int i = 0; i < m_todos.size(); ++i) {
-        if (passesFilter(m_todos[i])) {
-            m_filteredIndices.append(i);
+        for (int i = 0; i < m_store.size(); ++i) {
+            if (!m_store.isLive(i))
+                continue;
+            const int slot = savedSlots.value(m_store.id(i), -1);
+            if (slot >= 0)
+                merged.replace(slot, m_store.item(i));
+            else
+                merged.append(m_store.item(i));
         }
+        beginResetModel();
     }
 
-    endResetModel();
+    m_store = std::move(merged);
+    m_revealedSlots = 0;
+    m_loadedSlots = loadedSlots;
+    rebuildIdIndex();
+    m_categoryIndex.rebuild(m_store);
+    m_statistics.rebuildCounts(m_store);
+    rebuildSearch();
+    rebuildQueryMatches();
+    m_sorter.sort(m_store);
+    rebuildVisibleRows();
+    m_completedCount = m_store.countCompleted();
+
+    if (hasNewItems)
+        endResetModel();
+
+    emit countsChanged();
+
+    // The first chunk goes out in this iteration so rows appear as soon
+    // as the list is read
+    revealLoadedRows();
 }
 
 /**
- * @brief Check if a todo passes the current filter
+ * @brief Turn the next chunk of loaded items into rows
+ *
+ * Revealed rows follow all previously revealed ones and precede items
+ * added during the load, so each chunk is inserted as one row range.
+ * With a sort order the chunk's rows are spread out and may be reported
+ * as a reset instead.
  */
-bool TodoModel::passesFilter(const TodoItem& item) const
+void TodoModel::revealLoadedRows()
 {
-    switch (m_filterMode) {
-        case FilterMode::All:
-            return true;
-        case FilterMode::Active:
-            return !item.isCompleted();
-        case FilterMode::Completed:
-            return item.isCompleted();
-        default:
-            return true;
+    const int begin = m_revealedSlots;
+    m_revealedSlots = std::min(begin + kLoadChunkSize, m_loadedSlots);
+
+    QVector<int> shown;
+    shown.reserve(m_revealedSlots - begin);
+    for (int i = begin; i < m_revealedSlots; ++i) {
+        if (m_store.isLive(i) && passesFilter(i))
+            shown.append(i);
+    }
+    applyVisibility({}, shown);
+
+    emit loadProgress(m_revealedSlots, m_loadedSlots);
+
+    if (m_revealedSlots < m_loadedSlots) {
+        m_revealTimer.start();
+        return;
     }
+
+    m_revealedSlots = 0;
+    m_loadedSlots = 0;
+    emit loadFinished(totalCount());
 }
 
 /**
- * @brief Get actual index from filtered row
+ * @brief Save pending changes to storage
  */
-int TodoModel::getActualIndex(int filteredRow) const
+bool TodoModel::saveToStorage()
 {
-    if (filteredRow < 0 || filteredRow >= m_filteredIndices.size())
-        return -1;
+    return m_saveScheduler->flush();
+}
 
-    return m_filteredIndices[filteredRow];
+/**
+ * @brief Set the save coalescing delay
+ */
+void TodoModel::setSaveDelay(int msec)
+{
+    m_saveScheduler->setDelay(msec);
+}
+
+/**
+ * @brief Get the save coalescing delay
+ */
+int TodoModel::saveDelay() const
+{
+    return m_saveScheduler->delay();
+}
+
+/**
+ * @brief Check for unsaved changes
+ */
+bool TodoModel::hasUnsavedChanges() const
+{
+    return m_saveScheduler->isDirty();
+}
+
+/**
+ * @brief Follow saves made by other instances
+ */
+void TodoModel::setLiveSync(bool enabled)
+{
+    m_saveScheduler->setWatching(enabled);
+}
+
+/**
+ * @brief Check whether saves of other instances are followed
+ */
+bool TodoModel::isLiveSync() const
+{
+    return m_saveScheduler->isWatching();
+}
+
+/**
+ * @brief Save pending changes and merge saves of other instances
+ */
+bool TodoModel::syncWithStorage()
+{
+    return m_saveScheduler->sync();
+}
+
+/**
+ * @brief Apply items other processes saved
+ */
+void TodoModel::mergeExternalChanges(const TodoChangeList& changes)
+{
+    // Only the last change of each item matters
+    QHash<QUuid, int> last;
+    last.reserve(changes.size());
+    for (int i = 0; i < changes.size(); ++i)
+        last.insert(changes[i].id, i);
+
+    QVector<int> updated;
+    QVector<int> removed;
+    QVector<TodoItem> added;
+    for (int i = 0; i < changes.size(); ++i) {
+        const TodoChange& change = changes[i];
+        if (change.type == TodoChange::Type::Clear || last.value(change.id) != i)
+            continue;
+
+        const int index = indexForId(change.id);
+        if (change.type == TodoChange::Type::Remove) {
+            if (index >= 0)
+                removed.append(index);
+        } else if (index < 0) {
+            added.append(change.item);
+        } else if (change.item.modifiedAtMs() >= m_store.modifiedAtMs(index)
+                   && !sameContents(m_store, index, change.item)) {
+            // The later edit wins; an unsaved later edit here is written
+            // back and wins in storage as well
+            unindexSearchSlot(index);
+            m_categoryIndex.remove(index, m_store);
+            m_statistics.remove(index, m_store);
+            if (m_store.isCompleted(index))
+                --m_completedCount;
+            m_store.replace(index, change.item);
+            if (m_store.isCompleted(index))
+                ++m_completedCount;
+            m_statistics.insert(index, m_store);
+            m_categoryIndex.insert(index, m_store);
+            indexSearchSlot(index);
+            updated.append(index);
+        }
+    }
+
+    if (updated.isEmpty() && removed.isEmpty() && added.isEmpty())
+        return;
+
+    if (!updated.isEmpty()) {
+        std::sort(updated.begin(), updated.end());
+        repositionSlots(updated);
+        updateVisibility(updated, {});
+        for (int index : std::as_const(updated))
+            emit todoUpdated(m_store.item(index));
+    }
+
+    if (!removed.isEmpty()) {
+        std::sort(removed.begin(), removed.end());
+        QVector<QUuid> removedIds;
+        removedIds.reserve(removed.size());
+        for (int index : std::as_const(removed))
+            removedIds.append(m_store.id(index));
+        eraseIndices(removed);
+        for (const QUuid& id : std::as_const(removedIds))
+            emit todoRemoved(id.toString(QUuid::WithoutBraces));
+    }
+
+    if (!added.isEmpty()) {
+        const int firstIndex = m_store.size();
+        m_store.reserve(firstIndex + added.size());
+        m_idIndex.reserve(firstIndex + added.size());
+        for (const TodoItem& item : std::as_const(added)) {
+            m_idIndex.insert(item.getUuid(), m_store.size());
+            if (item.isCompleted())
+                ++m_completedCount;
+            m_store.append(item);
+        }
+        appendRows(firstIndex);
+        for (const TodoItem& item : std::as_const(added))
+            emit todoAdded(item);
+    }
+
+    verifyCounts();
+    emit countsChanged();
+    emit externalChangesMerged(int(updated.size() + removed.size() + added.size()));
+}
+
+/**
+ * @brief Keep the stored summaries read on the storage thread
+ *
+ * Summaries read before the list was loaded in full are dropped.
+ */
+void TodoModel::onCategorySummariesRead(const QVector<StorageManager::CategorySummary>& summaries)
+{
+    if (!m_partiallyLoaded)
+        return;
+
+    m_storedSummaries = summaries;
+    emit countsChanged();
+}
+
+/**
+ * @brief Rebuild the visibility bitmap without notifying views
+ */
+void TodoModel::rebuildVisibleRows()
+{
+    QVector<bool> bits(m_store.size());
+    for (int i = 0; i < m_store.size(); ++i) {
+        bits[m_sorter.position(i)] = m_store.isLive(i) && passesFilter(i);
+    }
+    m_visibleRows.assign(bits);
+}
+
+/**
+ * @brief Get the text of an item that search looks at
+ */
+QString TodoModel::searchableText(int index) const
+{
+    return m_store.title(index) + QLatin1Char('\n') + m_store.category(index);
+}
+
+/**
+ * @brief Find every live item whose title or category contains a string
+ */
+QVector<int> TodoModel::findTextMatches(const QString& text)
+{
+    QVector<int> matches;
+    if (!TrigramIndex::canQuery(text)) {
+        // Too short for trigrams
+        for (int i = 0; i < m_store.size(); ++i) {
+            if (m_store.isLive(i) && TodoQuery::containsText(m_store, i, text))
+                matches.append(i);
+        }
+        return matches;
+    }
+
+    if (!m_searchIndexed) {
+        m_searchIndex.clear();
+        for (int i = 0; i < m_store.size(); ++i) {
+            if (m_store.isLive(i))
+                m_searchIndex.insert(i, searchableText(i));
+        }
+        m_searchIndexed = true;
+    }
+
+    // Every trigram being present does not mean they are adjacent
+    matches = m_searchIndex.candidates(text);
+    matches.erase(std::remove_if(matches.begin(), matches.end(),
+                                 [this, &text](int index) {
+                                     return !TodoQuery::containsText(m_store, index, text);
+                                 }),
+                  matches.end());
+    return matches;
+}
+
+/**
+ * @brief Drop the search index and recompute matches for a new store
+ *
+ * Slots change meaning when the store is replaced or compacted, so the
+ * index is rebuilt by the next query that needs it.
+ */
+void TodoModel::rebuildSearch()
+{
+    m_searchIndex.clear();
+    m_searchIndexed = false;
+    m_searchMatches.fill(false, m_store.size());
+    m_searchSlots.clear();
+
+    if (m_searchText.isEmpty())
+        return;
+
+    m_searchSlots = findTextMatches(m_searchText);
+    for (int index : std::as_const(m_searchSlots))
+        m_searchMatches.setBit(index);
+}
+
+/**
+ * @brief Add an item to the search index and match set
+ */
+void TodoModel::indexSearchSlot(int index)
+{
+    if (m_searchIndexed)
+        m_searchIndex.insert(index, searchableText(index));
+
+    if (m_searchText.isEmpty() || !TodoQuery::containsText(m_store, index, m_searchText))
+        return;
+
+    m_searchMatches.setBit(index);
+    auto it = std::lower_bound(m_searchSlots.begin(), m_searchSlots.end(), index);
+    if (it == m_searchSlots.end() || *it != index)
+        m_searchSlots.insert(it, index);
+}
+
+/**
+ * @brief Remove an item from the search index and match set
+ */
+void TodoModel::unindexSearchSlot(int index)
+{
+    if (m_searchIndexed)
+        m_searchIndex.remove(index, searchableText(index));
+
+    if (!m_searchMatches.testBit(index))
+        return;
+
+    m_searchMatches.clearBit(index);
+    auto it = std::lower_bound(m_searchSlots.begin(), m_searchSlots.end(), index);
+    if (it != m_searchSlots.end() && *it == index)
+        m_searchSlots.erase(it);
+}
+
+/**
+ * @brief Replace the query and update which items are shown
+ */
+void TodoModel::applyQuery(const TodoQuery& query)
+{
+    m_query = query;
+    rebuildQueryMatches();
+    refilter();
+}
+
+/**
+ * @brief Evaluate the query over the whole store
+ */
+void TodoModel::rebuildQueryMatches()
+{
+    m_queryMatches = m_query.evaluate(m_store, [this](const QString& text) {
+        QBitArray bits(m_store.size());
+        for (int index : findTextMatches(text))
+            bits.setBit(index);
+        return bits;
+    });
+}
+
+/**
+ * @brief Get the categories a load should read
+ */
+QStringList TodoModel::loadScope() const
+{
+    if (m_categoryFilter.isNull())
+        return QStringList();
+
+    return {m_categoryFilter};
+}
+
+/**
+ * @brief Record which categories a full load read
+ */
+void TodoModel::setLoadedScope(const QStringList& scope)
+{
+    m_partiallyLoaded = m_storage->isSharded() && !scope.isEmpty();
+    m_loadedCategories = m_partiallyLoaded ? QSet<QString>(scope.cbegin(), scope.cend()) : QSet<QString>();
+    if (!m_partiallyLoaded)
+        m_storedSummaries.clear();
+    m_saveScheduler->setReportingSummaries(m_partiallyLoaded);
+}
+
+/**
+ * @brief Read more categories from storage and append their items
+ *
+ * Items the model already holds are skipped: a todo added to a category
+ * that was not loaded is saved into its shard and comes back here.
+ */
+void TodoModel::loadCategories(const QStringList& categories)
+{
+    if (categories.isEmpty())
+        return;
+
+    // The storage manager is shared with the save thread
+    m_saveScheduler->flush();
+    TodoStore loaded = m_storage->loadShards(categories);
+    m_storedSummaries = m_storage->categorySummaries();
+    for (const QString& category : categories)
+        m_loadedCategories.insert(category);
+
+    for (int i = 0; i < loaded.size(); ++i) {
+        if (m_idIndex.contains(loaded.id(i)))
+            loaded.remove(i);
+    }
+    if (loaded.liveCount() == 0)
+        return;
+
+    const int firstIndex = m_store.size();
+    m_store.append(loaded);
+    m_idIndex.reserve(m_store.size());
+    for (int i = firstIndex; i < m_store.size(); ++i) {
+        m_idIndex.insert(m_store.id(i), i);
+        if (m_store.isCompleted(i))
+            ++m_completedCount;
+    }
+    appendRows(firstIndex);
+
+    verifyCounts();
+    emit countsChanged();
+}
+
+/**
+ * @brief Insert rows for the visible items among newly appended slots
+ */
+void TodoModel::appendRows(int firstIndex)
+{
+    m_searchMatches.resize(m_store.size());
+    m_queryMatches.resize(m_store.size());
+    for (int i = firstIndex; i < m_store.size(); ++i) {
+        m_categoryIndex.insert(i, m_store);
+        m_statistics.insert(i, m_store);
+        indexSearchSlot(i);
+        m_queryMatches.setBit(i, m_query.matches(m_store, i));
+    }
+
+    if (m_sorter.isSorted()) {
+        insertIntoOrder(firstIndex);
+        QVector<int> shown;
+        for (int i = firstIndex; i < m_store.size(); ++i) {
+            if (passesFilter(i))
+                shown.append(i);
+        }
+        applyVisibility({}, shown);
+        return;
+    }
+
+    const int count = m_store.size() - firstIndex;
+    QVector<bool> visible(count);
+    int visibleCount = 0;
+    for (int i = 0; i < count; ++i) {
+        visible[i] = passesFilter(firstIndex + i);
+        if (visible[i])
+            ++visibleCount;
+    }
+
+    // New items are appended, so the visible ones form one block of rows
+    const int firstRow = m_visibleRows.count();
+    if (visibleCount > 0)
+        beginInsertRows(QModelIndex(), firstRow, firstRow + visibleCount - 1);
+
+    for (bool bit : std::as_const(visible))
+        m_visibleRows.append(bit);
+
+    if (visibleCount > 0)
+        endInsertRows();
+}
+
+/**
+ * @brief Give newly appended slots a hidden position in the sort order
+ */
+void TodoModel::insertIntoOrder(int firstIndex)
+{
+    const int count = m_store.size() - firstIndex;
+    if (count <= kMaxSortedInserts) {
+        for (int i = firstIndex; i < m_store.size(); ++i)
+            m_visibleRows.insert(m_sorter.insert(i, m_store), false);
+        return;
+    }
+
+    // Every position behind the first new one shifts, so the bitmap is
+    // rebuilt once from the rows' slots
+    QVector<int> visibleSlots;
+    visibleSlots.reserve(m_visibleRows.count());
+    for (int position = 0; position < m_visibleRows.size(); ++position) {
+        if (m_visibleRows.test(position))
+            visibleSlots.append(m_sorter.slot(position));
+    }
+
+    m_sorter.insertRange(firstIndex, m_store);
+    QVector<bool> bits(m_store.size());
+    for (int slot : std::as_const(visibleSlots))
+        bits[m_sorter.position(slot)] = true;
+    m_visibleRows.assign(bits);
+}
+
+/**
+ * @brief Set the sort order
+ */
+void TodoModel::setSortColumns(const QVector<TodoSorter::Column>& columns)
+{
+    if (columns == m_sorter.columns())
+        return;
+
+    resort(columns);
+    emit sortColumnsChanged();
+}
+
+/**
+ * @brief Reorder every row as one layout change
+ */
+void TodoModel::resort(const QVector<TodoSorter::Column>& columns)
+{
+    emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+
+    const QModelIndexList before = persistentIndexList();
+    QVector<int> persistentSlots;
+    persistentSlots.reserve(before.size());
+    for (const QModelIndex& index : before)
+        persistentSlots.append(getActualIndex(index.row()));
+
+    // Rows keep their items; only their order changes
+    QVector<int> visibleSlots;
+    visibleSlots.reserve(m_visibleRows.count());
+    for (int position = 0; position < m_visibleRows.size(); ++position) {
+        if (m_visibleRows.test(position))
+            visibleSlots.append(m_sorter.slot(position));
+    }
+
+    m_sorter.setColumns(columns, m_store);
+    QVector<bool> bits(m_store.size());
+    for (int slot : std::as_const(visibleSlots))
+        bits[m_sorter.position(slot)] = true;
+    m_visibleRows.assign(bits);
+
+    QModelIndexList after;
+    after.reserve(before.size());
+    for (int slot : std::as_const(persistentSlots)) {
+        const int row = slot < 0 ? -1 : rowForIndex(slot);
+        after.append(row < 0 ? QModelIndex() : index(row));
+    }
+    changePersistentIndexList(before, after);
+
+    emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
+
+/**
+ * @brief Move edited items to where the sort order wants them
+ *
+ * Visible items move with one beginMoveRows() each. Many edits at once,
+ * such as completing a whole selection, re-sort as one layout change.
+ */
+void TodoModel::repositionSlots(const QVector<int>& indices)
+{
+    if (!m_sorter.isSorted())
+        return;
+
+    if (indices.size() > kMaxRowRanges) {
+        resort(m_sorter.columns());
+        return;
+    }
+
+    for (int index : indices) {
+        const int from = m_sorter.position(index);
+        const int to = m_sorter.findPosition(index, m_store);
+        if (from == to)
+            continue;
+
+        bool moving = false;
+        if (m_visibleRows.test(from)) {
+            // Row the item lands on once it has left its old one
+            const int fromRow = m_visibleRows.rank(from);
+            const int toRow = to > from ? m_visibleRows.rank(to + 1) - 1 : m_visibleRows.rank(to);
+            moving = toRow != fromRow
+                && beginMoveRows(QModelIndex(), fromRow, fromRow, QModelIndex(),
+                                 toRow > fromRow ? toRow + 1 : toRow);
+        }
+
+        m_sorter.move(from, to);
+        m_visibleRows.move(from, to);
+
+        if (moving)
+            endMoveRows();
+    }
+}
+
+/**
+ * @brief Drop the tombstones of removed items from the store
+ *
+ * Rows are not affected, so views need no notification.
+ */
+void TodoModel::compactSlots()
+{
+    if (m_store.removedCount() == 0)
+        return;
+
+    QVector<int> newSlots(m_store.size());
+    int next = 0;
+    for (int i = 0; i < m_store.size(); ++i)
+        newSlots[i] = m_store.isLive(i) ? next++ : -1;
+
+    // Only items behind the first removed slot move
+    const int first = m_store.compact();
+    for (int i = first; i < m_store.size(); ++i)
+        m_idIndex[m_store.id(i)] = i;
+    m_sorter.remap(newSlots);
+    m_categoryIndex.rebuild(m_store);
+    rebuildSearch();
+    rebuildQueryMatches();
+    rebuildVisibleRows();
+}
+
+/**
+ * @brief Remove items and notify views
+ *
+ * Removed items only become tombstones, so no other item changes its
+ * slot and removing k items costs O(k log n). Their slots are reclaimed
+ * once tombstones outnumber the live items.
+ */
+void TodoModel::eraseIndices(const QVector<int>& indices)
+{
+    QVector<int> visible;
+    for (int index : indices) {
+        if (isVisible(index))
+            visible.append(index);
+    }
+    applyVisibility(visible, {});
+
+    for (int index : indices) {
+        if (m_store.isCompleted(index))
+            --m_completedCount;
+        m_idIndex.remove(m_store.id(index));
+        unindexSearchSlot(index);
+        m_categoryIndex.remove(index, m_store);
+        m_statistics.remove(index, m_store);
+        m_store.remove(index);
+    }
+
+    // Compaction moves slots, so it waits until every loaded row is out
+    const int tombstones = m_store.removedCount();
+    if (tombstones >= kMinTombstonesForCompaction && tombstones > totalCount() && !isLoading())
+        compactSlots();
+}
+
+/**
+ * @brief Record the edit that reverts a change
+ */
+void TodoModel::recordUndo(const QString& text, UndoOp&& op)
+{
+    // Edits made by undo() and redo() become the opposite entry instead
+    if (m_undoCapture) {
+        m_undoCapture->append(std::move(op));
+        return;
+    }
+
+    m_history.record(text, std::move(op));
+    emit undoStackChanged();
+}
+
+/**
+ * @brief Apply inverse edits, last to first
+ */
+QVector<UndoOp> TodoModel::replayUndo(const QVector<UndoOp>& ops)
+{
+    QVector<UndoOp> inverse;
+    inverse.reserve(ops.size());
+    m_undoCapture = &inverse;
+    for (auto it = ops.crbegin(); it != ops.crend(); ++it)
+        applyUndoOp(*it);
+    m_undoCapture = nullptr;
+    return inverse;
+}
+
+/**
+ * @brief Apply one inverse edit through the regular edit paths
+ *
+ * Items are found by id, so edits still apply after compaction or a
+ * reload moved them. Items that no longer exist are skipped.
+ */
+void TodoModel::applyUndoOp(const UndoOp& op)
+{
+    switch (op.type) {
+        case UndoOp::Type::Remove:
+            removeTodos(op.ids);
+            break;
+
+        case UndoOp::Type::Restore:
+            restoreTodos(op.items, op.oldSlots);
+            break;
+
+        case UndoOp::Type::SetCompleted:
+            setCompleted(op.ids, op.value != 0);
+            break;
+
+        case UndoOp::Type::SetTitle:
+        case UndoOp::Type::SetPriority:
+        case UndoOp::Type::SetCategory: {
+            const int actualIndex = indexForId(op.ids.value(0));
+            if (actualIndex < 0)
+                break;
+            if (op.type == UndoOp::Type::SetPriority)
+                setItemData(actualIndex, op.value, PriorityRole);
+            else
+                setItemData(actualIndex, op.text, op.type == UndoOp::Type::SetTitle ? TitleRole : CategoryRole);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Put removed items back, in place where their tombstone remains
+ *
+ * Reviving a tombstone costs what removing it did: the slot keeps its
+ * fields and its position in the sort order, so only the indexes are
+ * updated and the rows are inserted where they were.
+ */
+void TodoModel::restoreTodos(const QVector<TodoItem>& items, const QVector<int>& oldSlots)
+{
+    QVector<int> revived;
+    QVector<TodoItem> appended;
+    for (int i = 0; i < items.size(); ++i) {
+        const QUuid id = items[i].getUuid();
+        if (m_idIndex.contains(id))
+            continue;
+
+        const int slot = oldSlots.value(i, -1);
+        if (slot >= 0 && slot < m_store.size() && !m_store.isLive(slot) && m_store.id(slot) == id)
+            revived.append(slot);
+        else
+            appended.append(items[i]);
+    }
+
+    if (!revived.isEmpty()) {
+        std::sort(revived.begin(), revived.end());
+
+        QVector<QUuid> ids;
+        TodoChangeList changes;
+        ids.reserve(revived.size());
+        changes.reserve(revived.size());
+        for (int index : std::as_const(revived)) {
+            m_store.restore(index);
+            m_idIndex.insert(m_store.id(index), index);
+            if (m_store.isCompleted(index))
+                ++m_completedCount;
+            m_categoryIndex.insert(index, m_store);
+            m_statistics.insert(index, m_store);
+            indexSearchSlot(index);
+            m_queryMatches.setBit(index, m_query.matches(m_store, index));
+            ids.append(m_store.id(index));
+            changes.append(TodoChange::upsert(m_store.item(index)));
+        }
+        verifyCounts();
+
+        QVector<int> shown;
+        for (int index : std::as_const(revived)) {
+            if (passesFilter(index))
+                shown.append(index);
+        }
+        applyVisibility({}, shown);
+        recordUndo(tr("Restore %n Todo(s)", nullptr, int(revived.size())), UndoOp::remove(ids));
+
+        for (const TodoChange& change : std::as_const(changes))
+            emit todoAdded(change.item);
+        emit countsChanged();
+        m_saveScheduler->markDirty(changes);
+    }
+
+    addTodos(std::move(appended));
+}
+
+/**
+ * @brief Notify views about modified items and update filter membership
+ *
+ * The query is tested again for each item. Rows that stay visible get
+ * one dataChanged covering them. Items that leave or enter the view are
+ * removed or inserted in row ranges.
+ */
+void TodoModel::updateVisibility(const QVector<int>& indices, const QVector<int>& roles)
+{
+    QVector<int> changedRows;
+    QVector<int> hidden;
+    QVector<int> shown;
+
+    for (int index : indices) {
+        m_queryMatches.setBit(index, m_query.matches(m_store, index));
+        const bool wasVisible = isVisible(index);
+        const bool visible = passesFilter(index);
+        if (wasVisible && visible)
+            changedRows.append(m_visibleRows.rank(m_sorter.position(index)));
+        else if (wasVisible)
+            hidden.append(index);
+        else if (visible)
+            shown.append(index);
+    }
+
+    // Rows are still valid before membership changes; a sort order can
+    // put them in any order
+    if (!changedRows.isEmpty()) {
+        const auto [first, last] = std::minmax_element(changedRows.cbegin(), changedRows.cend());
+        emit dataChanged(this->index(*first), this->index(*last), roles);
+    }
+
+    applyVisibility(hidden, shown);
+}
+
+/**
+ * @brief Hide and show items with one notification per block of rows
+ *
+ * Falls back to a single reset when the changes are scattered over more
+ * than kMaxRowRanges blocks.
+ */
+void TodoModel::applyVisibility(const QVector<int>& hiddenSlots, const QVector<int>& shownSlots)
+{
+    if (hiddenSlots.isEmpty() && shownSlots.isEmpty())
+        return;
+
+    // Rows follow the sort order, so work on positions from here on
+    const QVector<int> hidden = positionsOf(hiddenSlots);
+    const QVector<int> shown = positionsOf(shownSlots);
+
+    if (countRowRanges(hidden) + countRowRanges(shown) > kMaxRowRanges) {
+        beginResetModel();
+        for (int index : hidden)
+            m_visibleRows.set(index, false);
+        for (int index : shown)
+            m_visibleRows.set(index, true);
+        endResetModel();
+        return;
+    }
+
+    // Remove blocks from the bottom up so the rows of the blocks above
+    // stay valid
+    int end = hidden.size();
+    while (end > 0) {
+        const int lastRow = m_visibleRows.rank(hidden[end - 1]);
+        int begin = end - 1;
+        while (begin > 0 && m_visibleRows.rank(hidden[begin - 1]) == lastRow - (end - begin))
+            --begin;
+
+        beginRemoveRows(QModelIndex(), lastRow - (end - begin) + 1, lastRow);
+        for (int i = begin; i < end; ++i)
+            m_visibleRows.set(hidden[i], false);
+        endRemoveRows();
+        end = begin;
+    }
+
+    // Insert top down; hidden items with no visible item between them
+    // share an insertion row and go in as one block
+    int begin = 0;
+    while (begin < shown.size()) {
+        const int row = m_visibleRows.rank(shown[begin]);
+        int stop = begin + 1;
+        while (stop < shown.size() && m_visibleRows.rank(shown[stop]) == row)
+            ++stop;
+
+        beginInsertRows(QModelIndex(), row, row + (stop - begin) - 1);
+        for (int i = begin; i < stop; ++i)
+            m_visibleRows.set(shown[i], true);
+        endInsertRows();
+        begin = stop;
+    }
+}
+
+/**
+ * @brief Count the blocks of adjacent rows a set of items forms
+ */
+int TodoModel::countRowRanges(const QVector<int>& indices) const
+{
+    int ranges = 0;
+    int previousRank = -1;
+    bool previousVisible = false;
+    for (int index : indices) {
+        const int rank = m_visibleRows.rank(index);
+        // Adjacent when no other visible item sits in between
+        if (ranges == 0 || rank - previousRank != (previousVisible ? 1 : 0))
+            ++ranges;
+        previousRank = rank;
+        previousVisible = m_visibleRows.test(index);
+    }
+    return ranges;
+}
+
+/**
+ * @brief Check the cached counters against a full scan in debug builds
+ */
+void TodoModel::verifyCounts() const
+{
+    // Q_ASSERT_X compiles the scan out of release builds
+    Q_ASSERT_X(m_completedCount == m_store.countCompleted(), "TodoModel",
+               "cached completed count is out of sync");
+}
+
+/**
+ * @brief Forget an asynchronous load
+ */
+bool TodoModel::abortLoad()
+{
+    if (!isLoading())
+        return false;
+
+    m_awaitingLoad = false;
+    m_revealedSlots = 0;
+    m_loadedSlots = 0;
+    m_revealTimer.stop();
+    return true;
+}
+
+/**
+ * @brief Rebuild the id index from scratch
+ */
+void TodoModel::rebuildIdIndex()
+{
+    m_idIndex.clear();
+    m_idIndex.reserve(m_store.size());
+    for (int i = 0; i < m_store.size(); ++i) {
+        if (m_store.isLive(i))
+            m_idIndex.insert(m_store.id(i), i);
+    }
+}
+
+/**
+ * @brief Get the slot of an item by ID
+ */
+int TodoModel::indexForId(const QUuid& id) const
+{
+    return m_idIndex.value(id, -1);
+}
+
+/**
+ * @brief Resolve IDs to ascending slots, skipping unknown ones
+ */
+QVector<int> TodoModel::indicesForIds(const QVector<QUuid>& ids) const
+{
+    QVector<int> indices;
+    indices.reserve(ids.size());
+    for (const QUuid& id : ids) {
+        const int actualIndex = indexForId(id);
+        if (actualIndex >= 0)
+            indices.append(actualIndex);
+    }
+
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    return indices;
+}
+
+/**
+ * @brief Get the filtered row of a slot
+ */
+int TodoModel::rowForIndex(int actualIndex) const
+{
+    const int position = m_sorter.position(actualIndex);
+    if (!m_visibleRows.test(position))
+        return -1;
+
+    return m_visibleRows.rank(position);
+}
+
+/**
+ * @brief Check whether a slot is shown as a row
+ */
+bool TodoModel::isVisible(int actualIndex) const
+{
+    return m_visibleRows.test(m_sorter.position(actualIndex));
+}
+
+/**
+ * @brief Map slots to their positions in the sort order
+ */
+QVector<int> TodoModel::positionsOf(const QVector<int>& indices) const
+{
+    if (!m_sorter.isSorted())
+        return indices;
+
+    QVector<int> positions;
+    positions.reserve(indices.size());
+    for (int index : indices)
+        positions.append(m_sorter.position(index));
+    std::sort(positions.begin(), positions.end());
+    return positions;
+}
+
+/**
+ * @brief Check if a todo passes the current filter
+ */
+bool TodoModel::passesFilter(int actualIndex) const
+{
+    // Loaded items stay hidden until their chunk is revealed
+    if (actualIndex >= m_revealedSlots && actualIndex < m_loadedSlots)
+        return false;
+
+    if (!m_categoryFilter.isNull() && m_store.category(actualIndex) != m_categoryFilter)
+        return false;
+
+    if (!m_searchText.isEmpty() && !m_searchMatches.testBit(actualIndex))
+        return false;
+
+    return m_query.matchesEverything() || m_queryMatches.testBit(actualIndex);
+}
+
+/**
+ * @brief Get actual index from filtered row
+ */
+int TodoModel::getActualIndex(int filteredRow) const
+{
+    const int position = m_visibleRows.select(filteredRow);
+    return position < 0 ? -1 : m_sorter.slot(position);
 }
@@ -11,10 +11,25 @@
 
 #include <QAbstractListModel>
 #include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QUuid>
+#include <QTimer>
+#include <QBitArray>
 #include <memory>
 #include "TodoItem.h"
-
-class StorageManager;
+#include "TodoChange.h"
+#include "TodoStore.h"
+#include "FenwickTree.h"
+#include "TrigramIndex.h"
+#include "TodoSorter.h"
+#include "TodoQuery.h"
+#include "CategoryIndex.h"
+#include "UndoHistory.h"
+#include "TodoStatistics.h"
+#include "StorageManager.h"
+
+class SaveScheduler;
 
 /**
  * @class TodoModel
@@ -22,11 +37,29 @@ class StorageManager;
  *
  * This class provides the data model for todo items, implementing the
  * QAbstractListModel interface. It supports:
- * - CRUD operations on todo items
- * - Filtering (All/Active/Completed)
+ * - CRUD operations on todo items, by row or by ID (O(1) through an id index)
+ * - Filtering (All/Active/Completed), with filter switches and edits
+ *   reported to views as row ranges rather than resets
  * - Custom roles for data access
  * - Signals for data changes
- * - Persistence through StorageManager
+ * - Persistence through StorageManager, debounced and written on a
+ *   background thread by SaveScheduler
+ * - Loading in the background, with saved items revealed to views in
+ *   chunks of rows
+ * - Filtering by category; with sharded storage only the categories
+ *   shown are loaded, the others when the filter first asks for them
+ * - Substring search over titles and categories through a trigram
+ *   index that is kept up to date on every edit
+ * - Sorting by several keys; the order is kept up to date as items are
+ *   added and edited, and edited rows move with beginMoveRows()
+ * - Undo and redo of every edit, kept as inverse edits within a memory
+ *   budget
+ * - Productivity statistics updated by every edit and saved with the list
+ * - Live sync with other instances sharing the storage, merging only
+ *   the items they changed
+ *
+ * Items are kept column by column in a TodoStore; TodoItem values are
+ * built from it only when the API hands an item out.
  *
  * The model follows Qt's Model/View programming paradigm and emits
  * appropriate signals when data changes.
@@ -58,16 +91,31 @@ public:
     enum class FilterMode {
         All,        ///< Show all todos
         Active,     ///< Show only incomplete todos
-        Completed   ///< Show only completed todos
+        Completed,  ///< Show only completed todos
+        Custom      ///< Show the todos matching the query given to setQuery()
     };
     Q_ENUM(FilterMode)
 
+    /// Loaded items turned into rows per event loop iteration
+    static constexpr int kLoadChunkSize = 2000;
+
     /**
-     * @brief Constructor
+     * @brief Constructor using the Journal backend
+     *
+     * The model starts empty; call loadFromStorage() or
+     * loadFromStorageAsync() to read the saved list.
+     *
      * @param parent Parent QObject
      */
     explicit TodoModel(QObject *parent = nullptr);
 
+    /**
+     * @brief Constructor
+     * @param backend Storage backend to persist to
+     * @param parent Parent QObject
+     */
+    explicit TodoModel(StorageManager::StorageBackend backend, QObject *parent = nullptr);
+
     /**
      * @brief Destructor
      */
@@ -95,6 +143,17 @@ public:
      */
     bool addTodo(const TodoItem& item);
 
+    /**
+     * @brief Add several todo items at once
+     *
+     * Emits one row-range insertion, one countsChanged and schedules one
+     * save for the whole batch.
+     *
+     * @param items Items to add
+     * @return Number of items added
+     */
+    int addTodos(QVector<TodoItem>&& items);
+
     /**
      * @brief Remove a todo item by index
      * @param index Model index of the item to remove
@@ -114,7 +173,62 @@ public:
      * @param id Unique identifier of the item to remove
      * @return true if successful
      */
-    bool removeTodoById(const QString& id);
+    bool removeTodoById(const QUuid& id);
+
+    /**
+     * @brief Toggle completion status by ID
+     * @param id Unique identifier of the item, visible or not
+     * @return true if successful
+     */
+    bool toggleTodoById(const QUuid& id);
+
+    /**
+     * @brief Update todo title by ID
+     * @param id Unique identifier of the item, visible or not
+     * @param newTitle New title
+     * @return true if the title changed
+     */
+    bool updateTodoTitleById(const QUuid& id, const QString& newTitle);
+
+    /**
+     * @brief Update todo priority by ID
+     * @param id Unique identifier of the item, visible or not
+     * @param priority New priority
+     * @return true if the priority changed
+     */
+    bool updateTodoPriorityById(const QUuid& id, TodoItem::Priority priority);
+
+    /**
+     * @brief Get a todo item by ID
+     * @param id Unique identifier of the item, visible or not
+     * @return TodoItem if found, default TodoItem otherwise
+     */
+    TodoItem getTodoItemById(const QUuid& id) const;
+
+    /**
+     * @brief Check whether a todo item exists
+     * @param id Unique identifier of the item
+     * @return true if the item exists, regardless of the filter
+     */
+    bool containsTodo(const QUuid& id) const;
+
+    /**
+     * @brief Get the model index of a todo item
+     * @param id Unique identifier of the item
+     * @return Model index, or an invalid index if the item is hidden or unknown
+     */
+    QModelIndex modelIndexForId(const QUuid& id) const;
+
+    /**
+     * @brief Remove several todo items at once
+     *
+     * Emits one row-range removal (or one model reset when the visible rows
+     * are scattered), one countsChanged and schedules one save.
+     *
+     * @param ids Unique identifiers of the items to remove
+     * @return Number of items removed
+     */
+    int removeTodos(const QVector<QUuid>& ids);
 
     /**
      * @brief Toggle completion status of a todo item
@@ -130,11 +244,23 @@ public:
      */
     bool toggleTodo(int row);
 
+    /**
+     * @brief Set completion status of several todo items at once
+     *
+     * Emits one dataChanged range or one row-range change in filter
+     * membership, one countsChanged and schedules one save.
+     *
+     * @param ids Unique identifiers of the items
+     * @param completed New completion status
+     * @return Number of items whose status changed
+     */
+    int setCompleted(const QVector<QUuid>& ids, bool completed);
+
     /**
      * @brief Update todo title
      * @param index Model index of the item
      * @param newTitle New title
-     * @return true if successful
+     * @return true if the title changed
      */
     bool updateTodoTitle(const QModelIndex& index, const QString& newTitle);
 
@@ -142,7 +268,7 @@ public:
      * @brief Update todo priority
      * @param index Model index of the item
      * @param priority New priority
-     * @return true if successful
+     * @return true if the priority changed
      */
     bool updateTodoPriority(const QModelIndex& index, TodoItem::Priority priority);
 
@@ -160,6 +286,17 @@ public:
      */
     TodoItem getTodoItem(int row) const;
 
+    /**
+     * @brief Get every todo, independent of the filter
+     *
+     * The snapshot shares its columns with the model, so taking it is
+     * O(1) and later edits do not affect it. Removed slots may still be
+     * present; check TodoStore::isLive().
+     *
+     * @return Copy of the item store
+     */
+    TodoStore snapshot() const { return m_store; }
+
     /**
      * @brief Clear all completed todos
      * @return Number of items removed
@@ -171,48 +308,306 @@ public:
      */
     void clearAll();
 
+    /**
+     * @brief Revert the last action
+     *
+     * Only the items the action touched are visited, and views are told
+     * through the same row insertions, removals and dataChanged() the
+     * action produced. The reverting edits are saved like any other.
+     *
+     * @return false if there is nothing to undo or an undo group is open
+     */
+    bool undo();
+
+    /**
+     * @brief Repeat the last undone action
+     * @return false if there is nothing to redo or an undo group is open
+     */
+    bool redo();
+
+    /**
+     * @brief Check whether there is an action to undo
+     * @return true if undo() would do something
+     */
+    bool canUndo() const { return m_history.canUndo(); }
+
+    /**
+     * @brief Check whether there is an action to redo
+     * @return true if redo() would do something
+     */
+    bool canRedo() const { return m_history.canRedo(); }
+
+    /**
+     * @brief Get the label of the action undo() would revert
+     * @return Label such as "Remove", empty if there is none
+     */
+    QString undoText() const { return m_history.undoText(); }
+
+    /**
+     * @brief Get the label of the action redo() would repeat
+     * @return Label, empty if there is none
+     */
+    QString redoText() const { return m_history.redoText(); }
+
+    /**
+     * @brief Make the following edits one undo step
+     *
+     * Used for batches that reach the model in several calls, such as an
+     * import. Calls nest and must be balanced with endUndoGroup().
+     *
+     * @param text Label of the action
+     */
+    void beginUndoGroup(const QString& text);
+
+    /**
+     * @brief Close the undo step opened by beginUndoGroup()
+     */
+    void endUndoGroup();
+
+    /**
+     * @brief Set the memory the undo history may use
+     *
+     * The oldest steps are dropped once the history grows past it; the
+     * last one is kept even if it alone is larger.
+     *
+     * @param bytes Limit in bytes
+     */
+    void setUndoMemoryLimit(qsizetype bytes) { m_history.setMemoryLimit(bytes); }
+
+    /**
+     * @brief Get the memory the undo history may use
+     * @return Limit in bytes, UndoHistory::kDefaultMemoryLimit unless set
+     */
+    qsizetype undoMemoryLimit() const { return m_history.memoryLimit(); }
+
+    /**
+     * @brief Get the estimated memory held by the undo history
+     * @return Size in bytes
+     */
+    qsizetype undoMemoryUsage() const { return m_history.memoryUsage(); }
+
+    /**
+     * @brief Get the productivity statistics
+     *
+     * Creation and completion history plus per-priority counts, kept up
+     * to date on every edit. Per-category counts come from
+     * categorySummaries().
+     *
+     * @return Statistics of the loaded list
+     */
+    const TodoStatistics& statistics() const { return m_statistics; }
+
     /**
      * @brief Set filter mode
-     * @param mode Filter mode to apply
+     *
+     * Each mode stands for a preset query: All matches everything, Active
+     * and Completed match on the completion status.
+     *
+     * @param mode Filter mode to apply; Custom is ignored, use setQuery()
      */
     void setFilterMode(FilterMode mode);
 
     /**
      * @brief Get current filter mode
-     * @return Current filter mode
+     * @return Current filter mode, Custom after setQuery()
      */
     FilterMode getFilterMode() const { return m_filterMode; }
 
+    /**
+     * @brief Show only the todos matching a query
+     *
+     * The query is compiled and evaluated over the store's columns once;
+     * afterwards only edited and added items are tested again. It applies
+     * together with the category filter and the search string.
+     *
+     * @param query Query to apply; a default-constructed one shows everything
+     */
+    void setQuery(const TodoQuery& query);
+
+    /**
+     * @brief Get the query items are filtered by
+     * @return Compiled form of the last query or filter mode set
+     */
+    TodoQuery query() const { return m_query; }
+
+    /**
+     * @brief Show only the todos of one category
+     *
+     * With sharded storage a category that was not loaded yet is read
+     * from its shard now, and clearing the filter loads every shard.
+     * Switching from one category to another only visits the items of
+     * the two, taken from the category index.
+     *
+     * @param category Category to show; a null string shows all categories
+     */
+    void setCategoryFilter(const QString& category);
+
+    /**
+     * @brief Get the category filter
+     * @return Category shown, or a null string for all categories
+     */
+    QString categoryFilter() const { return m_categoryFilter; }
+
+    /**
+     * @brief Get per-category counts, including categories not loaded
+     *
+     * Loaded categories are counted by the category index, so unsaved
+     * edits are included and no item is visited; the others come from
+     * a copy of the storage summary index, taken when categories are
+     * loaded and refreshed on the storage thread after every save, so
+     * no call reads the disk.
+     *
+     * @return One entry per category, sorted by name
+     */
+    QVector<StorageManager::CategorySummary> categorySummaries() const;
+
+    /**
+     * @brief Get the active and completed counts of a loaded category
+     * @param category Category name, empty for uncategorized items
+     * @return Counts kept up to date on every edit, read in O(1)
+     */
+    CategoryIndex::Counts categoryCounts(const QString& category) const { return m_categoryIndex.counts(category, m_store); }
+
+    /**
+     * @brief Show only the todos whose title or category contains a string
+     *
+     * Matching ignores case. Queries of TrigramIndex::kGramLength or more
+     * characters are answered from the trigram index, built on first use;
+     * shorter ones scan the list. Narrowing or widening a search only
+     * touches the items that matched before or match now.
+     *
+     * @param text Search string; empty (after trimming) shows every item
+     */
+    void setSearchText(const QString& text);
+
+    /**
+     * @brief Get the search string
+     * @return Current search, empty if none
+     */
+    QString searchText() const { return m_searchText; }
+
+    /**
+     * @brief Get the number of items matching the search
+     * @return Matches regardless of the other filters, or totalCount() without a search
+     */
+    int searchMatchCount() const { return m_searchText.isEmpty() ? totalCount() : m_searchSlots.size(); }
+
+    /**
+     * @brief Sort the rows by one or more fields
+     *
+     * Changing the order is one layout change. Afterwards new items are
+     * placed by binary search and edited ones are moved to their new row.
+     *
+     * @param columns Keys, most significant first; empty for insertion order
+     */
+    void setSortColumns(const QVector<TodoSorter::Column>& columns);
+
+    /**
+     * @brief Get the sort order
+     * @return Keys, most significant first; empty for insertion order
+     */
+    QVector<TodoSorter::Column> sortColumns() const { return m_sorter.columns(); }
+
     /**
      * @brief Get total count of all todos (ignoring filter)
      * @return Total todo count
      */
-    int totalCount() const { return m_todos.size(); }
+    int totalCount() const { return m_store.liveCount(); }
 
     /**
      * @brief Get count of active todos
-     * @return Active todo count
+     * @return Active todo count, O(1)
      */
-    int activeCount() const;
+    int activeCount() const { return totalCount() - m_completedCount; }
 
     /**
      * @brief Get count of completed todos
-     * @return Completed todo count
+     * @return Completed todo count, O(1)
      */
-    int completedCount() const;
+    int completedCount() const { return m_completedCount; }
 
     /**
      * @brief Load todos from storage
+     *
+     * With sharded storage and a category filter set, only that
+     * category is read.
+     *
      * @return true if successful
      */
     bool loadFromStorage();
 
     /**
-     * @brief Save todos to storage
+     * @brief Load todos from storage without blocking
+     *
+     * Clears the model and reads the saved list on the storage thread.
+     * The loaded items then become rows kLoadChunkSize at a time, one
+     * chunk per event loop iteration, so views paint and respond while
+     * a large list is still arriving. Counts cover every loaded item as
+     * soon as the list has been read.
+     *
+     * The model stays fully usable meanwhile. Items added before the
+     * list has been read end up behind the saved ones, the position a
+     * reload gives them.
+     *
+     * @return false if a load is already running
+     */
+    bool loadFromStorageAsync();
+
+    /**
+     * @brief Check whether an asynchronous load is in progress
+     * @return true until loadFinished()
+     */
+    bool isLoading() const { return m_awaitingLoad || m_revealedSlots < m_loadedSlots; }
+
+    /**
+     * @brief Save pending changes to storage and wait for the write
      * @return true if successful
      */
     bool saveToStorage();
 
+    /**
+     * @brief Set how long edits are coalesced before being saved
+     * @param msec Delay in milliseconds
+     */
+    void setSaveDelay(int msec);
+
+    /**
+     * @brief Get the save coalescing delay
+     * @return Delay in milliseconds
+     */
+    int saveDelay() const;
+
+    /**
+     * @brief Check whether edits are waiting to be saved
+     * @return true if there are unsaved changes
+     */
+    bool hasUnsavedChanges() const;
+
+    /**
+     * @brief Follow saves made by other instances sharing the storage
+     *
+     * While enabled, the storage is watched and what other processes
+     * save is merged in as it lands. Only the changed items are read;
+     * they are matched by id and the later modification wins. Merged
+     * changes are neither saved back nor recorded for undo. Only the
+     * Journal and Sharded backends can be shared.
+     *
+     * @param enabled Whether to follow other instances
+     */
+    void setLiveSync(bool enabled);
+
+    /**
+     * @brief Check whether saves of other instances are followed
+     * @return true if live sync is enabled
+     */
+    bool isLiveSync() const;
+
+    /**
+     * @brief Save pending changes and merge saves of other instances now
+     * @return true if the save succeeded
+     */
+    bool syncWithStorage();
+
 signals:
     /**
      * @brief Emitted when a todo is added
@@ -238,33 +633,362 @@ signals:
      */
     void filterModeChanged(FilterMode mode);
 
+    /**
+     * @brief Emitted when the query changes, through setQuery() or setFilterMode()
+     */
+    void queryChanged();
+
+    /**
+     * @brief Emitted when the category filter changes
+     * @param category New category filter, null for all categories
+     */
+    void categoryFilterChanged(const QString& category);
+
+    /**
+     * @brief Emitted when the search string changes
+     * @param text New search, empty if none
+     */
+    void searchTextChanged(const QString& text);
+
+    /**
+     * @brief Emitted when the sort order changes
+     */
+    void sortColumnsChanged();
+
     /**
      * @brief Emitted when todo counts change
      */
     void countsChanged();
 
+    /**
+     * @brief Emitted when what undo() and redo() would do changes
+     */
+    void undoStackChanged();
+
+    /**
+     * @brief Emitted after a background save completes
+     * @param success Whether the save succeeded
+     */
+    void saveFinished(bool success);
+
+    /**
+     * @brief Emitted after each chunk of loaded rows
+     * @param done Loaded items handed to views so far
+     * @param total Items read from storage
+     */
+    void loadProgress(int done, int total);
+
+    /**
+     * @brief Emitted when an asynchronous load ends
+     *
+     * Also emitted if clearAll() or loadFromStorage() cut the load short.
+     *
+     * @param count Number of todos in the model
+     */
+    void loadFinished(int count);
+
+    /**
+     * @brief Emitted after saves of other instances were merged
+     * @param count Items added, changed or removed by the merge
+     */
+    void externalChangesMerged(int count);
+
+private slots:
+    /**
+     * @brief Take over the list read by loadFromStorageAsync()
+     * @param loaded Saved items
+     */
+    void onStoreLoaded(const TodoStore& loaded);
+
+    /**
+     * @brief Turn the next chunk of loaded items into rows
+     */
+    void revealLoadedRows();
+
+    /**
+     * @brief Apply items other processes saved
+     *
+     * Changed items are updated in place and moved if the sort order
+     * requires it, removed ones go in one batch and new ones are
+     * appended, so views get row signals for exactly those items.
+     *
+     * @param changes Stored state of the changed items, without Clear
+     */
+    void mergeExternalChanges(const TodoChangeList& changes);
+
+    /**
+     * @brief Keep the stored summaries read on the storage thread
+     * @param summaries Per-category counts of the storage summary index
+     */
+    void onCategorySummariesRead(const QVector<StorageManager::CategorySummary>& summaries);
+
 private:
-    QVector<TodoItem> m_todos;              ///< All todo items
-    QVector<int> m_filteredIndices;         ///< Indices of filtered items
+    TodoStore m_store;                      ///< Item slots, removed items stay until compaction
+    int m_completedCount = 0;               ///< Live completed items, updated on every edit
+    TodoSorter m_sorter;                    ///< Display order of the slots
+    FenwickTree m_visibleRows;              ///< Positions in m_sorter passing the filter, maps rows to positions
+    QHash<QUuid, int> m_idIndex;            ///< Item id -> slot in m_store
+    CategoryIndex m_categoryIndex;          ///< Live slots and counts per category
     FilterMode m_filterMode;                ///< Current filter mode
+    TodoQuery m_query;                      ///< Compiled query of the filter mode or setQuery()
+    QBitArray m_queryMatches;               ///< Slots matching m_query
+    QString m_categoryFilter;               ///< Category shown, null for all
+    bool m_partiallyLoaded = false;         ///< Only m_loadedCategories were read from storage
+    QSet<QString> m_loadedCategories;       ///< Categories read in full while partially loaded
+    QVector<StorageManager::CategorySummary> m_storedSummaries; ///< Storage summary index while partially loaded
+    QString m_searchText;                   ///< Search string, empty if none
+    TrigramIndex m_searchIndex;             ///< Trigrams of live titles and categories
+    bool m_searchIndexed = false;           ///< m_searchIndex covers the store; built on first use
+    QBitArray m_searchMatches;              ///< Slots matching m_searchText
+    QVector<int> m_searchSlots;             ///< Set bits of m_searchMatches, ascending
     std::unique_ptr<StorageManager> m_storage; ///< Storage manager
+    std::unique_ptr<SaveScheduler> m_saveScheduler; ///< Debounced writer (uses m_storage, m_store and m_statistics; reset first)
+    bool m_awaitingLoad = false;            ///< loadFromStorageAsync() result not taken yet
+    int m_revealedSlots = 0;                ///< Loaded slots below this are rows
+    int m_loadedSlots = 0;                  ///< Slots [m_revealedSlots, m_loadedSlots) wait to become rows
+    QTimer m_revealTimer;                   ///< Schedules the next chunk of loaded rows
+    UndoHistory m_history;                  ///< Inverse edits of past actions
+    QVector<UndoOp> *m_undoCapture = nullptr; ///< Collects inverse edits while undoing or redoing
+    TodoStatistics m_statistics;            ///< History and per-priority counts
+
+    /**
+     * @brief Rebuild the visibility bitmap without notifying views
+     */
+    void rebuildVisibleRows();
+
+    /**
+     * @brief Re-evaluate the filter for every item and notify views
+     */
+    void refilter();
+
+    /**
+     * @brief Get the text of an item that search looks at
+     * @param index Slot in the store
+     * @return Title and category on separate lines
+     */
+    QString searchableText(int index) const;
+
+    /**
+     * @brief Find every live item whose title or category contains a string
+     *
+     * Serves both the search string and text leaves of the query.
+     *
+     * @param text String to find, ignoring case
+     * @return Ascending slots
+     */
+    QVector<int> findTextMatches(const QString& text);
+
+    /**
+     * @brief Drop the search index and recompute matches for a new store
+     */
+    void rebuildSearch();
+
+    /**
+     * @brief Add an item to the search index and match set
+     * @param index Slot in the store
+     */
+    void indexSearchSlot(int index);
+
+    /**
+     * @brief Remove an item from the search index and match set
+     *
+     * Must run before the item's title or category changes.
+     *
+     * @param index Slot in the store
+     */
+    void unindexSearchSlot(int index);
+
+    /**
+     * @brief Replace the query and update which items are shown
+     * @param query New query
+     */
+    void applyQuery(const TodoQuery& query);
+
+    /**
+     * @brief Evaluate the query over the whole store
+     *
+     * Text leaves are answered through findTextMatches(), so the search
+     * must be rebuilt first when the store was replaced.
+     */
+    void rebuildQueryMatches();
+
+    /**
+     * @brief Get the categories a load should read
+     * @return The category filter, or an empty list for all categories
+     */
+    QStringList loadScope() const;
+
+    /**
+     * @brief Record which categories a full load read
+     * @param scope Categories read, empty for all
+     */
+    void setLoadedScope(const QStringList& scope);
+
+    /**
+     * @brief Read more categories from storage and append their items
+     * @param categories Categories not loaded yet
+     */
+    void loadCategories(const QStringList& categories);
+
+    /**
+     * @brief Insert rows for the visible items in slots from @p firstIndex on
+     * @param firstIndex First slot appended to the store
+     */
+    void appendRows(int firstIndex);
+
+    /**
+     * @brief Give newly appended slots a hidden position in the sort order
+     * @param firstIndex First slot appended to the store
+     */
+    void insertIntoOrder(int firstIndex);
+
+    /**
+     * @brief Sort every item and report it as one layout change
+     * @param columns Sort keys to apply
+     */
+    void resort(const QVector<TodoSorter::Column>& columns);
+
+    /**
+     * @brief Move edited items to their place in the sort order
+     * @param indices Ascending slots whose fields changed
+     */
+    void repositionSlots(const QVector<int>& indices);
+
+    /**
+     * @brief Check whether an item is shown as a row
+     * @param actualIndex Slot in the store
+     * @return true if the item has a row
+     */
+    bool isVisible(int actualIndex) const;
+
+    /**
+     * @brief Map slots to positions in the sort order
+     * @param indices Ascending slots
+     * @return Ascending positions
+     */
+    QVector<int> positionsOf(const QVector<int>& indices) const;
+
+    /**
+     * @brief Reclaim the slots of removed items
+     */
+    void compactSlots();
+
+    /**
+     * @brief Check the cached counters against a full scan in debug builds
+     */
+    void verifyCounts() const;
+
+    /**
+     * @brief Forget an asynchronous load before the store is replaced
+     * @return true if a load was in progress
+     */
+    bool abortLoad();
+
+    /**
+     * @brief Rebuild the id index from the store
+     */
+    void rebuildIdIndex();
+
+    /**
+     * @brief Get the slot of an item
+     * @param id Unique identifier of the item
+     * @return Slot in the store, or -1 if unknown
+     */
+    int indexForId(const QUuid& id) const;
+
+    /**
+     * @brief Resolve IDs to slots in the store
+     * @param ids Unique identifiers, unknown ones are skipped
+     * @return Ascending, unique indices
+     */
+    QVector<int> indicesForIds(const QVector<QUuid>& ids) const;
+
+    /**
+     * @brief Set data for a role on an item, wherever it is in the filter
+     * @param actualIndex Slot in the store
+     * @param value New value
+     * @param role Role to set
+     * @return true if the item changed
+     */
+    bool setItemData(int actualIndex, const QVariant &value, int role);
+
+    /**
+     * @brief Remove items and notify views
+     * @param indices Ascending slots in the store
+     */
+    void eraseIndices(const QVector<int>& indices);
+
+    /**
+     * @brief Record the edit that reverts a change
+     * @param text Label of the action
+     * @param op Inverse edit
+     */
+    void recordUndo(const QString& text, UndoOp&& op);
+
+    /**
+     * @brief Apply inverse edits, last to first
+     * @param ops Edits of an undo or redo entry
+     * @return Edits that revert this replay, in the order they were made
+     */
+    QVector<UndoOp> replayUndo(const QVector<UndoOp>& ops);
+
+    /**
+     * @brief Apply one inverse edit through the regular edit paths
+     * @param op Edit to apply
+     */
+    void applyUndoOp(const UndoOp& op);
+
+    /**
+     * @brief Put removed items back
+     *
+     * Items whose slot still holds their tombstone come back in place,
+     * with their old position in the sort order; the others are
+     * appended. Items that exist again are skipped.
+     *
+     * @param items Removed items
+     * @param oldSlots Slots they were removed from, may be empty
+     */
+    void restoreTodos(const QVector<TodoItem>& items, const QVector<int>& oldSlots);
+
+    /**
+     * @brief Notify views about modified items, updating filter membership
+     * @param indices Ascending slots in the store of modified items
+     * @param roles Roles that changed
+     */
+    void updateVisibility(const QVector<int>& indices, const QVector<int>& roles);
+
+    /**
+     * @brief Change filter membership and notify views in row ranges
+     * @param hiddenSlots Ascending slots of visible items to hide
+     * @param shownSlots Ascending slots of hidden items to show
+     */
+    void applyVisibility(const QVector<int>& hiddenSlots, const QVector<int>& shownSlots);
+
+    /**
+     * @brief Count the blocks of adjacent rows that items form
+     * @param indices Ascending positions, all visible or all hidden
+     * @return Number of row ranges needed to insert or remove them
+     */
+    int countRowRanges(const QVector<int>& indices) const;
 
     /**
-     * @brief Update filtered indices based on current filter mode
+     * @brief Get the filtered row of an item
+     * @param actualIndex Slot in the store
+     * @return Row in filtered view, or -1 if the item is hidden
      */
-    void updateFilteredIndices();
+    int rowForIndex(int actualIndex) const;
 
     /**
      * @brief Check if a todo item passes the current filter
-     * @param item Todo item to check
+     * @param actualIndex Slot in the store
      * @return true if item passes filter
      */
-    bool passesFilter(const TodoItem& item) const;
+    bool passesFilter(int actualIndex) const;
 
     /**
-     * @brief Get the actual index in m_todos from filtered row
+     * @brief Get the slot in the store from a filtered row
      * @param filteredRow Row in filtered view
-     * @return Actual index in m_todos vector, or -1 if invalid
+     * @return Slot in the store, or -1 if invalid
      */
     int getActualIndex(int filteredRow) const;
 };
@@ -0,0 +1,417 @@
+/**
+ * @file TodoQuery.cpp
+ * @brief Implementation of TodoQuery class
+ */
+
+#include "TodoQuery.h"
+#include <QByteArray>
+#include <algorithm>
+#include <limits>
+
+/**
+ * @struct TodoQuery::Node
+ * @brief One node of a query tree; which fields are used depends on op
+ */
+struct TodoQuery::Node {
+    Op op = Op::All;                ///< Kind of node
+    bool flag = false;              ///< Completion status for Op::Completed
+    qint64 low = 0;                 ///< Lower bound of a range leaf
+    qint64 high = 0;                ///< Upper bound of a range leaf
+    QString text;                   ///< Category or search string
+    QVector<TodoQuery> operands;    ///< Operands of And, Or and Not
+};
+
+namespace {
+
+/**
+ * @brief Build a bitmap of the slots a column test accepts
+ *
+ * Bits are packed into bytes directly instead of going through
+ * QBitArray::setBit(), which keeps the loop free of branches.
+ */
+template <typename Test>
+QBitArray scanSlots(int size, Test test)
+{
+    QByteArray bits((size + 7) / 8, '\0');
+    char* data = bits.data();
+    for (int i = 0; i < size; ++i)
+        data[i >> 3] |= static_cast<char>(int(test(i)) << (i & 7));
+    return QBitArray::fromBits(bits.constData(), size);
+}
+
+} // namespace
+
+/**
+ * @brief Match items by completion status
+ */
+TodoQuery TodoQuery::completed(bool completed)
+{
+    auto node = QSharedPointer<Node>::create();
+    node->op = Op::Completed;
+    node->flag = completed;
+    return TodoQuery(node);
+}
+
+/**
+ * @brief Match items whose priority lies in a range
+ */
+TodoQuery TodoQuery::priorityBetween(TodoItem::Priority min, TodoItem::Priority max)
+{
+    auto node = QSharedPointer<Node>::create();
+    node->op = Op::Priority;
+    node->low = static_cast<qint64>(min);
+    node->high = static_cast<qint64>(max);
+    return TodoQuery(node);
+}
+
+/**
+ * @brief Match items of one category
+ */
+TodoQuery TodoQuery::category(const QString& category)
+{
+    auto node = QSharedPointer<Node>::create();
+    node->op = Op::Category;
+    node->text = category;
+    return TodoQuery(node);
+}
+
+/**
+ * @brief Match items created in a time range
+ */
+TodoQuery TodoQuery::createdBetween(const QDateTime& from, const QDateTime& to)
+{
+    return timeRange(Op::CreatedAt, from, to);
+}
+
+/**
+ * @brief Match items last modified in a time range
+ */
+TodoQuery TodoQuery::modifiedBetween(const QDateTime& from, const QDateTime& to)
+{
+    return timeRange(Op::ModifiedAt, from, to);
+}
+
+/**
+ * @brief Match items whose title or category contains a string
+ */
+TodoQuery TodoQuery::textContains(const QString& text)
+{
+    if (text.isEmpty())
+        return TodoQuery();
+
+    auto node = QSharedPointer<Node>::create();
+    node->op = Op::Text;
+    node->text = text;
+    return TodoQuery(node);
+}
+
+/**
+ * @brief Match items matching both queries
+ */
+TodoQuery TodoQuery::operator&&(const TodoQuery& other) const
+{
+    return combine(Op::And, *this, other);
+}
+
+/**
+ * @brief Match items matching either query
+ */
+TodoQuery TodoQuery::operator||(const TodoQuery& other) const
+{
+    return combine(Op::Or, *this, other);
+}
+
+/**
+ * @brief Match items not matching this query
+ */
+TodoQuery TodoQuery::operator!() const
+{
+    auto node = QSharedPointer<Node>::create();
+    node->op = Op::Not;
+    node->operands = {*this};
+    return TodoQuery(node);
+}
+
+/**
+ * @brief Compare two query trees
+ */
+bool TodoQuery::operator==(const TodoQuery& other) const
+{
+    if (d == other.d)
+        return true;
+    if (op() != other.op())
+        return false;
+    if (!d || !other.d)
+        return true;
+
+    return d->flag == other.d->flag
+        && d->low == other.d->low
+        && d->high == other.d->high
+        && d->text == other.d->text
+        && d->operands == other.d->operands;
+}
+
+/**
+ * @brief Check whether the query is the match-everything query
+ */
+bool TodoQuery::matchesEverything() const
+{
+    return op() == Op::All;
+}
+
+/**
+ * @brief Rewrite the query into an equivalent one that evaluates faster
+ */
+TodoQuery TodoQuery::compiled() const
+{
+    const Op kind = op();
+
+    if (kind == Op::Not) {
+        const TodoQuery operand = d->operands.first().compiled();
+        if (operand.op() == Op::Not)
+            return operand.d->operands.first();
+        auto node = QSharedPointer<Node>::create(*d);
+        node->operands = {operand};
+        return TodoQuery(node);
+    }
+
+    if (kind != Op::And && kind != Op::Or)
+        return *this;
+
+    QVector<TodoQuery> operands;
+    for (const TodoQuery& operand : d->operands) {
+        const TodoQuery flat = operand.compiled();
+        if (flat.op() == kind)
+            operands += flat.d->operands;
+        else
+            operands.append(flat);
+    }
+
+    // Everything is the identity of AND and absorbs OR
+    if (kind == Op::Or && std::any_of(operands.cbegin(), operands.cend(),
+                                      [](const TodoQuery& q) { return q.matchesEverything(); }))
+        return TodoQuery();
+    operands.erase(std::remove_if(operands.begin(), operands.end(),
+                                  [](const TodoQuery& q) { return q.matchesEverything(); }),
+                   operands.end());
+
+    // Several priority ranges under one AND test the column once
+    if (kind == Op::And) {
+        auto isPriority = [](const TodoQuery& q) { return q.op() == Op::Priority; };
+        auto first = std::find_if(operands.begin(), operands.end(), isPriority);
+        if (first != operands.end() && std::count_if(first, operands.end(), isPriority) > 1) {
+            const int at = static_cast<int>(first - operands.begin());
+            auto merged = QSharedPointer<Node>::create(*first->d);
+            for (auto it = first + 1; it != operands.end(); ++it) {
+                if (isPriority(*it)) {
+                    merged->low = std::max(merged->low, it->d->low);
+                    merged->high = std::min(merged->high, it->d->high);
+                }
+            }
+            operands.erase(std::remove_if(operands.begin() + at + 1, operands.end(), isPriority),
+                           operands.end());
+            operands[at] = TodoQuery(merged);
+        }
+    }
+
+    if (operands.isEmpty())
+        return TodoQuery();
+    if (operands.size() == 1)
+        return operands.first();
+
+    std::stable_sort(operands.begin(), operands.end(),
+                     [](const TodoQuery& a, const TodoQuery& b) { return a.cost() < b.cost(); });
+
+    auto node = QSharedPointer<Node>::create();
+    node->op = kind;
+    node->operands = std::move(operands);
+    return TodoQuery(node);
+}
+
+/**
+ * @brief Evaluate the query for every slot of a store
+ */
+QBitArray TodoQuery::evaluate(const TodoStore& store, const TextMatcher& matchText) const
+{
+    const int size = store.size();
+
+    switch (op()) {
+        case Op::All:
+            return QBitArray(size, true);
+
+        case Op::Completed:
+            return d->flag ? store.completedBits() : ~store.completedBits();
+
+        case Op::Priority: {
+            const char* priorities = store.priorities().constData();
+            const qint64 low = d->low;
+            const qint64 high = d->high;
+            return scanSlots(size, [priorities, low, high](int i) {
+                return priorities[i] >= low && priorities[i] <= high;
+            });
+        }
+
+        case Op::Category: {
+            const int category = store.findCategory(d->text);
+            if (category < 0)
+                return QBitArray(size);
+            return scanSlots(size, [&store, category](int i) { return store.categoryIndex(i) == category; });
+        }
+
+        case Op::CreatedAt: {
+            const qint64 low = d->low;
+            const qint64 high = d->high;
+            return scanSlots(size, [&store, low, high](int i) {
+                const qint64 time = store.createdAtMs(i);
+                return time >= low && time < high;
+            });
+        }
+
+        case Op::ModifiedAt: {
+            const qint64 low = d->low;
+            const qint64 high = d->high;
+            return scanSlots(size, [&store, low, high](int i) {
+                const qint64 time = store.modifiedAtMs(i);
+                return time >= low && time < high;
+            });
+        }
+
+        case Op::Text:
+            if (matchText) {
+                QBitArray bits = matchText(d->text);
+                bits.resize(size);
+                return bits;
+            }
+            return scanSlots(size, [this, &store](int i) {
+                return store.isLive(i) && containsText(store, i, d->text);
+            });
+
+        case Op::And: {
+            // Cheapest operand first; once nothing is left the rest is skipped
+            QBitArray result = d->operands.first().evaluate(store, matchText);
+            for (int i = 1; i < d->operands.size() && result.count(true) > 0; ++i)
+                result &= d->operands[i].evaluate(store, matchText);
+            return result;
+        }
+
+        case Op::Or: {
+            QBitArray result = d->operands.first().evaluate(store, matchText);
+            for (int i = 1; i < d->operands.size() && result.count(true) < size; ++i)
+                result |= d->operands[i].evaluate(store, matchText);
+            return result;
+        }
+
+        case Op::Not:
+            return ~d->operands.first().evaluate(store, matchText);
+    }
+
+    return QBitArray(size, true);
+}
+
+/**
+ * @brief Evaluate the query for one slot
+ */
+bool TodoQuery::matches(const TodoStore& store, int slot) const
+{
+    switch (op()) {
+        case Op::All:
+            return true;
+        case Op::Completed:
+            return store.isCompleted(slot) == d->flag;
+        case Op::Priority: {
+            const qint64 priority = static_cast<qint64>(store.priority(slot));
+            return priority >= d->low && priority <= d->high;
+        }
+        case Op::Category:
+            return store.category(slot) == d->text;
+        case Op::CreatedAt:
+            return store.createdAtMs(slot) >= d->low && store.createdAtMs(slot) < d->high;
+        case Op::ModifiedAt:
+            return store.modifiedAtMs(slot) >= d->low && store.modifiedAtMs(slot) < d->high;
+        case Op::Text:
+            return containsText(store, slot, d->text);
+        case Op::And:
+            return std::all_of(d->operands.cbegin(), d->operands.cend(),
+                               [&store, slot](const TodoQuery& q) { return q.matches(store, slot); });
+        case Op::Or:
+            return std::any_of(d->operands.cbegin(), d->operands.cend(),
+                               [&store, slot](const TodoQuery& q) { return q.matches(store, slot); });
+        case Op::Not:
+            return !d->operands.first().matches(store, slot);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Check whether an item's title or category contains a string
+ */
+bool TodoQuery::containsText(const TodoStore& store, int slot, const QString& text)
+{
+    return store.title(slot).contains(text, Qt::CaseInsensitive)
+        || store.category(slot).contains(text, Qt::CaseInsensitive);
+}
+
+/**
+ * @brief Get the kind of the root node
+ */
+TodoQuery::Op TodoQuery::op() const
+{
+    return d ? d->op : Op::All;
+}
+
+/**
+ * @brief Build an AND or OR of two queries
+ */
+TodoQuery TodoQuery::combine(Op op, const TodoQuery& a, const TodoQuery& b)
+{
+    auto node = QSharedPointer<Node>::create();
+    node->op = op;
+    node->operands = {a, b};
+    return TodoQuery(node);
+}
+
+/**
+ * @brief Build a leaf covering a range of a time column
+ */
+TodoQuery TodoQuery::timeRange(Op op, const QDateTime& from, const QDateTime& to)
+{
+    if (!from.isValid() && !to.isValid())
+        return TodoQuery();
+
+    auto node = QSharedPointer<Node>::create();
+    node->op = op;
+    node->low = from.isValid() ? from.toMSecsSinceEpoch() : std::numeric_limits<qint64>::min();
+    node->high = to.isValid() ? to.toMSecsSinceEpoch() : std::numeric_limits<qint64>::max();
+    return TodoQuery(node);
+}
+
+/**
+ * @brief Estimate the relative cost of evaluating a query
+ */
+int TodoQuery::cost() const
+{
+    switch (op()) {
+        case Op::All:
+            return 0;
+        case Op::Completed:
+            return 1;   // Copies a bitset
+        case Op::Priority:
+        case Op::Category:
+            return 2;   // Scans a byte or int column
+        case Op::CreatedAt:
+        case Op::ModifiedAt:
+            return 3;   // Scans a 64-bit column
+        case Op::Text:
+            return 8;   // Reads titles or an index
+        case Op::And:
+        case Op::Or:
+        case Op::Not:
+            break;
+    }
+
+    int total = 1;
+    for (const TodoQuery& operand : d->operands)
+        total += operand.cost();
+    return total;
+}
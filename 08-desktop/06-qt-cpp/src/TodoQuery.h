@@ -0,0 +1,209 @@
+/**
+ * @file TodoQuery.h
+ * @brief Composable filter over the fields of todo items
+ *
+ * This file defines the TodoQuery class which describes which items the
+ * model shows, built from field predicates joined by AND, OR and NOT.
+ */
+
+#ifndef TODOQUERY_H
+#define TODOQUERY_H
+
+#include <QString>
+#include <QDateTime>
+#include <QBitArray>
+#include <QSharedPointer>
+#include <functional>
+#include "TodoItem.h"
+#include "TodoStore.h"
+
+/**
+ * @class TodoQuery
+ * @brief Immutable predicate tree evaluated over a TodoStore
+ *
+ * A default-constructed query matches every item. Leaves test one field
+ * each; operator&&, operator|| and operator! combine queries. Copies
+ * share their tree, so queries are cheap to pass around.
+ *
+ * evaluate() answers a query for every slot at once: each leaf scans
+ * one column of the store into a bitmap, and the operators combine the
+ * bitmaps a word at a time. No per-item predicate is called, so a
+ * compound query over a million items takes a few milliseconds.
+ * matches() answers it for a single slot, for items edited afterwards.
+ *
+ * compiled() prepares a query for repeated evaluation: nested operators
+ * are flattened, redundant operands dropped, priority ranges under one
+ * AND merged, and operands ordered so cheap columns run first and an
+ * empty AND stops early.
+ */
+class TodoQuery
+{
+public:
+    /**
+     * @brief Finds the slots whose text contains a string
+     *
+     * Lets the caller answer text leaves from an index instead of a scan.
+     * The result has one bit per slot; bits of removed slots are ignored.
+     */
+    using TextMatcher = std::function<QBitArray(const QString& text)>;
+
+    /**
+     * @brief Construct a query matching every item
+     */
+    TodoQuery() = default;
+
+    /**
+     * @brief Match items by completion status
+     * @param completed Status to match
+     * @return Leaf query
+     */
+    static TodoQuery completed(bool completed = true);
+
+    /**
+     * @brief Match items whose priority lies in a range
+     * @param min Lowest priority matched
+     * @param max Highest priority matched
+     * @return Leaf query
+     */
+    static TodoQuery priorityBetween(TodoItem::Priority min, TodoItem::Priority max);
+
+    /**
+     * @brief Match items of one category
+     * @param category Category name; empty matches uncategorized items
+     * @return Leaf query
+     */
+    static TodoQuery category(const QString& category);
+
+    /**
+     * @brief Match items created in a time range
+     * @param from Start, inclusive; invalid for no lower bound
+     * @param to End, exclusive; invalid for no upper bound
+     * @return Leaf query
+     */
+    static TodoQuery createdBetween(const QDateTime& from, const QDateTime& to);
+
+    /**
+     * @brief Match items last modified in a time range
+     * @param from Start, inclusive; invalid for no lower bound
+     * @param to End, exclusive; invalid for no upper bound
+     * @return Leaf query
+     */
+    static TodoQuery modifiedBetween(const QDateTime& from, const QDateTime& to);
+
+    /**
+     * @brief Match items whose title or category contains a string
+     * @param text String to find, ignoring case; empty matches everything
+     * @return Leaf query
+     */
+    static TodoQuery textContains(const QString& text);
+
+    /**
+     * @brief Match items matching both queries
+     */
+    TodoQuery operator&&(const TodoQuery& other) const;
+
+    /**
+     * @brief Match items matching either query
+     */
+    TodoQuery operator||(const TodoQuery& other) const;
+
+    /**
+     * @brief Match items not matching this query
+     */
+    TodoQuery operator!() const;
+
+    /**
+     * @brief Compare two query trees
+     * @return true if both have the same structure and operands
+     */
+    bool operator==(const TodoQuery& other) const;
+    bool operator!=(const TodoQuery& other) const { return !(*this == other); }
+
+    /**
+     * @brief Check whether the query is the match-everything query
+     * @return true if no item can fail it
+     */
+    bool matchesEverything() const;
+
+    /**
+     * @brief Rewrite the query into an equivalent one that evaluates faster
+     * @return Normalized query
+     */
+    TodoQuery compiled() const;
+
+    /**
+     * @brief Evaluate the query for every slot of a store
+     * @param store Store to scan
+     * @param matchText Answers text leaves; without it they scan titles
+     * @return One bit per slot; bits of removed slots are unspecified
+     */
+    QBitArray evaluate(const TodoStore& store, const TextMatcher& matchText = TextMatcher()) const;
+
+    /**
+     * @brief Evaluate the query for one slot
+     * @param store Store holding the slot
+     * @param slot Slot index
+     * @return true if the item matches
+     */
+    bool matches(const TodoStore& store, int slot) const;
+
+    /**
+     * @brief Check whether an item's title or category contains a string
+     * @param store Store holding the slot
+     * @param slot Slot index
+     * @param text String to find, ignoring case
+     * @return true if either field contains it
+     */
+    static bool containsText(const TodoStore& store, int slot, const QString& text);
+
+private:
+    /**
+     * @enum Op
+     * @brief Kind of a query node
+     */
+    enum class Op {
+        All,            ///< Matches everything
+        Completed,      ///< Completion equals flag
+        Priority,       ///< low <= priority <= high
+        Category,       ///< Category equals text
+        CreatedAt,      ///< low <= creation ms < high
+        ModifiedAt,     ///< low <= modification ms < high
+        Text,           ///< Title or category contains text
+        And,            ///< Every operand matches
+        Or,             ///< Some operand matches
+        Not             ///< The single operand does not match
+    };
+
+    struct Node;
+    QSharedPointer<const Node> d;       ///< Query tree; null for Op::All
+
+    /**
+     * @brief Wrap a node
+     * @param node Root of the tree
+     */
+    explicit TodoQuery(QSharedPointer<const Node> node) : d(std::move(node)) {}
+
+    /**
+     * @brief Get the kind of the root node
+     * @return Op::All for a default-constructed query
+     */
+    Op op() const;
+
+    /**
+     * @brief Build an AND or OR of two queries
+     */
+    static TodoQuery combine(Op op, const TodoQuery& a, const TodoQuery& b);
+
+    /**
+     * @brief Build a leaf covering a range of a time column
+     */
+    static TodoQuery timeRange(Op op, const QDateTime& from, const QDateTime& to);
+
+    /**
+     * @brief Estimate the relative cost of evaluating a query
+     * @return Larger for more expensive queries
+     */
+    int cost() const;
+};
+
+#endif // TODOQUERY_H
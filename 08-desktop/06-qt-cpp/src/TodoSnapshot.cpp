@@ -0,0 +1,259 @@
+/**
+ * @file TodoSnapshot.cpp
+ * @brief Implementation of TodoSnapshot class
+ */
+
+#include "TodoSnapshot.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QHash>
+#include <QByteArrayView>
+#include <QtEndian>
+#include <QDebug>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+/// File signature, first eight bytes of every snapshot
+constexpr char kMagic[8] = {'Q', 'T', 'O', 'D', 'O', 'S', 'N', 'P'};
+
+// Header field offsets
+constexpr int kHeaderSize = 32;
+constexpr int kVersionOffset = 8;
+constexpr int kRecordSizeOffset = 12;
+constexpr int kItemCountOffset = 16;
+constexpr int kCategoryCountOffset = 20;
+constexpr int kHeapSizeOffset = 24;
+
+/// Size of one category table entry
+constexpr int kCategoryEntrySize = 8;
+
+// Record field offsets
+constexpr int kRecordSize = 48;
+constexpr int kIdOffset = 0;
+constexpr int kCreatedAtOffset = 16;
+constexpr int kModifiedAtOffset = 24;
+constexpr int kTitleOffsetOffset = 32;
+constexpr int kTitleLengthOffset = 36;
+constexpr int kCategoryOffset = 40;
+constexpr int kCompletedOffset = 44;
+constexpr int kPriorityOffset = 45;
+
+/**
+ * @brief Write a UUID in RFC 4122 byte order
+ */
+void writeUuid(const QUuid& id, uchar* dest)
+{
+    qToBigEndian<quint32>(id.data1, dest);
+    qToBigEndian<quint16>(id.data2, dest + 4);
+    qToBigEndian<quint16>(id.data3, dest + 6);
+    std::memcpy(dest + 8, id.data4, 8);
+}
+
+/**
+ * @brief Append a string to the heap
+ * @return false if the heap outgrew 32-bit offsets
+ */
+bool appendToHeap(QByteArray& heap, const QString& text, quint32& offset, quint32& length)
+{
+    const QByteArray utf8 = text.toUtf8();
+    if (quint64(heap.size()) + utf8.size() > std::numeric_limits<quint32>::max())
+        return false;
+
+    offset = quint32(heap.size());
+    length = quint32(utf8.size());
+    heap.append(utf8);
+    return true;
+}
+
+/**
+ * @brief Parse a mapped snapshot
+ *
+ * Every count, offset and length is checked against the file size before
+ * it is used, so a truncated or corrupt file is rejected rather than read
+ * out of bounds.
+ */
+bool parseSnapshot(const uchar* data, qint64 fileSize, TodoStore& store)
+{
+    if (std::memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+        qWarning() << "Snapshot has an unknown signature";
+        return false;
+    }
+
+    const quint32 version = qFromLittleEndian<quint32>(data + kVersionOffset);
+    const quint32 recordSize = qFromLittleEndian<quint32>(data + kRecordSizeOffset);
+    const quint32 itemCount = qFromLittleEndian<quint32>(data + kItemCountOffset);
+    const quint32 categoryCount = qFromLittleEndian<quint32>(data + kCategoryCountOffset);
+    const quint64 heapSize = qFromLittleEndian<quint64>(data + kHeapSizeOffset);
+
+    // Later versions only append record fields, which are skipped through
+    // the record size of the header
+    if (version == 0 || recordSize < kRecordSize) {
+        qWarning() << "Unsupported snapshot version" << version << "with record size" << recordSize;
+        return false;
+    }
+
+    // Counts are 32-bit, so these products cannot overflow 64 bits
+    const quint64 recordsStart = kHeaderSize + quint64(categoryCount) * kCategoryEntrySize;
+    const quint64 heapStart = recordsStart + quint64(itemCount) * recordSize;
+    if (heapSize > std::numeric_limits<quint32>::max() || itemCount > quint32(std::numeric_limits<int>::max())
+        || heapStart + heapSize != quint64(fileSize)) {
+        qWarning() << "Snapshot size does not match its header";
+        return false;
+    }
+
+    const char* heap = reinterpret_cast<const char*>(data + heapStart);
+    auto inHeap = [heapSize](quint32 offset, quint32 length) {
+        return quint64(offset) + length <= heapSize;
+    };
+
+    TodoStore loaded;
+
+    // Map file category indices to pool indices of the store
+    QVector<int> categories(int(categoryCount));
+    for (quint32 i = 0; i < categoryCount; ++i) {
+        const uchar* entry = data + kHeaderSize + i * kCategoryEntrySize;
+        const quint32 offset = qFromLittleEndian<quint32>(entry);
+        const quint32 length = qFromLittleEndian<quint32>(entry + 4);
+        if (!inHeap(offset, length)) {
+            qWarning() << "Snapshot category" << i << "lies outside the string heap";
+            return false;
+        }
+        categories[int(i)] = loaded.internCategory(QString::fromUtf8(heap + offset, int(length)));
+    }
+
+    loaded.reserve(int(itemCount));
+    for (quint32 i = 0; i < itemCount; ++i) {
+        const uchar* record = data + recordsStart + quint64(i) * recordSize;
+        const quint32 titleOffset = qFromLittleEndian<quint32>(record + kTitleOffsetOffset);
+        const quint32 titleLength = qFromLittleEndian<quint32>(record + kTitleLengthOffset);
+        const quint32 category = qFromLittleEndian<quint32>(record + kCategoryOffset);
+        const quint8 priority = record[kPriorityOffset];
+
+        if (!inHeap(titleOffset, titleLength) || category >= categoryCount
+            || priority > quint8(TodoItem::Priority::Urgent)) {
+            qWarning() << "Snapshot record" << i << "is corrupt";
+            return false;
+        }
+
+        loaded.appendEncoded(
+            QUuid::fromRfc4122(QByteArrayView(record + kIdOffset, 16)),
+            titleOffset, titleLength,
+            record[kCompletedOffset] != 0,
+            static_cast<TodoItem::Priority>(priority),
+            categories[int(category)],
+            qFromLittleEndian<qint64>(record + kCreatedAtOffset),
+            qFromLittleEndian<qint64>(record + kModifiedAtOffset));
+    }
+
+    loaded.setTitleHeap(QByteArray(heap, qsizetype(heapSize)));
+    store = std::move(loaded);
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief Write a snapshot atomically
+ */
+bool TodoSnapshot::write(const QString& path, const QVector<TodoItem>& todos)
+{
+    QByteArray heap;
+    QByteArray categoryTable;
+    QHash<QString, quint32> categoryIndex;
+    QByteArray records(todos.size() * kRecordSize, '\0');
+    uchar* record = reinterpret_cast<uchar*>(records.data());
+
+    for (const TodoItem& todo : todos) {
+        quint32 titleOffset = 0;
+        quint32 titleLength = 0;
+        if (!appendToHeap(heap, todo.getTitle(), titleOffset, titleLength)) {
+            qWarning() << "Snapshot string heap exceeds 4 GiB";
+            return false;
+        }
+
+        auto category = categoryIndex.constFind(todo.getCategory());
+        if (category == categoryIndex.cend()) {
+            quint32 offset = 0;
+            quint32 length = 0;
+            if (!appendToHeap(heap, todo.getCategory(), offset, length)) {
+                qWarning() << "Snapshot string heap exceeds 4 GiB";
+                return false;
+            }
+            uchar entry[kCategoryEntrySize];
+            qToLittleEndian<quint32>(offset, entry);
+            qToLittleEndian<quint32>(length, entry + 4);
+            categoryTable.append(reinterpret_cast<const char*>(entry), kCategoryEntrySize);
+            category = categoryIndex.insert(todo.getCategory(), quint32(categoryIndex.size()));
+        }
+
+        writeUuid(todo.getUuid(), record + kIdOffset);
+        qToLittleEndian<qint64>(todo.createdAtMs(), record + kCreatedAtOffset);
+        qToLittleEndian<qint64>(todo.modifiedAtMs(), record + kModifiedAtOffset);
+        qToLittleEndian<quint32>(titleOffset, record + kTitleOffsetOffset);
+        qToLittleEndian<quint32>(titleLength, record + kTitleLengthOffset);
+        qToLittleEndian<quint32>(category.value(), record + kCategoryOffset);
+        record[kCompletedOffset] = todo.isCompleted() ? 1 : 0;
+        record[kPriorityOffset] = quint8(todo.getPriority());
+        record += kRecordSize;
+    }
+
+    uchar header[kHeaderSize] = {};
+    std::memcpy(header, kMagic, sizeof(kMagic));
+    qToLittleEndian<quint32>(kVersion, header + kVersionOffset);
+    qToLittleEndian<quint32>(kRecordSize, header + kRecordSizeOffset);
+    qToLittleEndian<quint32>(quint32(todos.size()), header + kItemCountOffset);
+    qToLittleEndian<quint32>(quint32(categoryIndex.size()), header + kCategoryCountOffset);
+    qToLittleEndian<quint64>(quint64(heap.size()), header + kHeapSizeOffset);
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to open snapshot:" << file.fileName();
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(header), kHeaderSize);
+    file.write(categoryTable);
+    file.write(records);
+    file.write(heap);
+    if (!file.commit()) {
+        qWarning() << "Failed to write snapshot:" << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Load a snapshot into a store
+ *
+ * The record table is read directly from the mapping, so loading costs
+ * one pass over the file without any parsing. The string heap is copied
+ * out before the file is unmapped: keeping the mapping alive would hold
+ * the file open, and on Windows an open file cannot be replaced by the
+ * QSaveFile rename of the next snapshot.
+ */
+bool TodoSnapshot::read(const QString& path, TodoStore& store)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open snapshot:" << file.fileName();
+        return false;
+    }
+
+    const qint64 fileSize = file.size();
+    if (fileSize < kHeaderSize) {
+        qWarning() << "Snapshot is truncated:" << file.fileName();
+        return false;
+    }
+
+    uchar* data = file.map(0, fileSize);
+    if (!data) {
+        qWarning() << "Failed to map snapshot:" << file.errorString();
+        return false;
+    }
+
+    const bool ok = parseSnapshot(data, fileSize, store);
+    file.unmap(data);
+    return ok;
+}
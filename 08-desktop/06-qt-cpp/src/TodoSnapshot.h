@@ -0,0 +1,60 @@
+/**
+ * @file TodoSnapshot.h
+ * @brief Binary snapshot format for todo lists
+ *
+ * This file defines the TodoSnapshot class which writes a todo list as a
+ * fixed-size record table plus a string heap, and loads it back through
+ * a memory mapping.
+ */
+
+#ifndef TODOSNAPSHOT_H
+#define TODOSNAPSHOT_H
+
+#include <QString>
+#include <QVector>
+#include "TodoItem.h"
+#include "TodoStore.h"
+
+/**
+ * @class TodoSnapshot
+ * @brief Reads and writes the versioned binary snapshot format
+ *
+ * Layout, all integers little-endian:
+ * - Header (32 bytes): magic "QTODOSNP", u32 version, u32 record size,
+ *   u32 item count, u32 category count, u64 heap size
+ * - Category table: u32 heap offset and u32 length per distinct category
+ * - Record table: one fixed-size record per item holding the RFC 4122 id,
+ *   i64 creation and modification times in ms since the epoch, u32 title
+ *   offset and length, u32 category index, u8 completed, u8 priority
+ * - String heap: UTF-8 titles and category names
+ *
+ * Loading reads the records straight out of the mapping and does not
+ * decode titles; TodoStore decodes each one on first access. Readers
+ * accept any version whose records are at least as long as the ones
+ * they know and skip the rest of each record, so later versions can
+ * append fields without breaking older builds.
+ */
+class TodoSnapshot
+{
+public:
+    /// Format version written by this build
+    static constexpr quint32 kVersion = 1;
+
+    /**
+     * @brief Write a snapshot atomically
+     * @param path Snapshot file path
+     * @param todos Items to write
+     * @return true if successful
+     */
+    static bool write(const QString& path, const QVector<TodoItem>& todos);
+
+    /**
+     * @brief Load a snapshot into a store
+     * @param path Snapshot file path
+     * @param store Receives the items; left untouched on failure
+     * @return true if the file exists and is a valid snapshot
+     */
+    static bool read(const QString& path, TodoStore& store);
+};
+
+#endif // TODOSNAPSHOT_H
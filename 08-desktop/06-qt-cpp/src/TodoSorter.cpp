@@ -0,0 +1,245 @@
+/**
+ * @file TodoSorter.cpp
+ * @brief Implementation of TodoSorter class
+ */
+
+#include "TodoSorter.h"
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+/**
+ * @brief Three-way comparison of two ordered values
+ */
+template <typename T>
+int compareValues(const T& a, const T& b)
+{
+    return a < b ? -1 : (b < a ? 1 : 0);
+}
+
+} // namespace
+
+/**
+ * @brief Construct a sorter keeping slot order
+ */
+TodoSorter::TodoSorter()
+{
+    m_collator.setCaseSensitivity(Qt::CaseInsensitive);
+    m_collator.setNumericMode(true);
+}
+
+/**
+ * @brief Set the sort columns and sort every slot
+ */
+void TodoSorter::setColumns(const QVector<Column>& columns, const TodoStore& store)
+{
+    m_columns = columns;
+    sort(store);
+}
+
+/**
+ * @brief Check whether a field takes part in the order
+ */
+bool TodoSorter::dependsOn(Key key) const
+{
+    return std::any_of(m_columns.cbegin(), m_columns.cend(),
+                       [key](const Column& column) { return column.key == key; });
+}
+
+/**
+ * @brief Order every slot of a store from scratch
+ */
+void TodoSorter::sort(const TodoStore& store)
+{
+    m_titleKeys.clear();
+    if (!isSorted()) {
+        m_order.clear();
+        m_positions.clear();
+        return;
+    }
+
+    if (dependsOn(Key::Title)) {
+        m_titleKeys.resize(store.size());
+        for (int i = 0; i < store.size(); ++i)
+            updateTitleKey(i, store);
+    }
+
+    m_order.resize(store.size());
+    std::iota(m_order.begin(), m_order.end(), 0);
+    std::sort(m_order.begin(), m_order.end(),
+              [this, &store](int a, int b) { return less(a, b, store); });
+
+    m_positions.resize(store.size());
+    updatePositions(0, m_order.size());
+}
+
+/**
+ * @brief Place a slot just appended to the store
+ */
+int TodoSorter::insert(int slot, const TodoStore& store)
+{
+    if (!isSorted())
+        return slot;
+
+    if (dependsOn(Key::Title)) {
+        m_titleKeys.resize(store.size());
+        updateTitleKey(slot, store);
+    }
+
+    auto it = std::lower_bound(m_order.begin(), m_order.end(), slot,
+                               [this, &store](int a, int b) { return less(a, b, store); });
+    const int position = static_cast<int>(it - m_order.begin());
+    m_order.insert(it, slot);
+    m_positions.resize(store.size());
+    updatePositions(position, m_order.size());
+    return position;
+}
+
+/**
+ * @brief Place every slot from firstSlot on, appended in one batch
+ */
+void TodoSorter::insertRange(int firstSlot, const TodoStore& store)
+{
+    if (!isSorted())
+        return;
+
+    if (dependsOn(Key::Title)) {
+        m_titleKeys.resize(store.size());
+        for (int i = firstSlot; i < store.size(); ++i)
+            updateTitleKey(i, store);
+    }
+
+    auto less = [this, &store](int a, int b) { return this->less(a, b, store); };
+    QVector<int> added(store.size() - firstSlot);
+    std::iota(added.begin(), added.end(), firstSlot);
+    std::sort(added.begin(), added.end(), less);
+
+    QVector<int> merged(m_order.size() + added.size());
+    std::merge(m_order.cbegin(), m_order.cend(), added.cbegin(), added.cend(), merged.begin(), less);
+    m_order = std::move(merged);
+
+    m_positions.resize(store.size());
+    updatePositions(0, m_order.size());
+}
+
+/**
+ * @brief Find where an edited slot belongs
+ */
+int TodoSorter::findPosition(int slot, const TodoStore& store)
+{
+    if (!isSorted())
+        return slot;
+
+    if (dependsOn(Key::Title))
+        updateTitleKey(slot, store);
+
+    // Search the order as if the slot were not in it; only its own entry
+    // can be out of place
+    const int from = m_positions[slot];
+    int lo = 0;
+    int hi = m_order.size() - 1;
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        const int other = m_order[mid < from ? mid : mid + 1];
+        if (less(other, slot, store))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * @brief Move the slot at one position to another
+ */
+void TodoSorter::move(int from, int to)
+{
+    if (!isSorted() || from == to)
+        return;
+
+    if (from < to)
+        std::rotate(m_order.begin() + from, m_order.begin() + from + 1, m_order.begin() + to + 1);
+    else
+        std::rotate(m_order.begin() + to, m_order.begin() + from, m_order.begin() + from + 1);
+    updatePositions(qMin(from, to), qMax(from, to) + 1);
+}
+
+/**
+ * @brief Follow a compaction of the store
+ */
+void TodoSorter::remap(const QVector<int>& newSlots)
+{
+    if (!isSorted())
+        return;
+
+    // Kept slots keep their relative order, so both passes run in place
+    int write = 0;
+    for (int old = 0; old < newSlots.size(); ++old) {
+        if (newSlots[old] >= 0 && !m_titleKeys.isEmpty())
+            m_titleKeys[newSlots[old]] = std::move(m_titleKeys[old]);
+        if (newSlots[old] >= 0)
+            ++write;
+    }
+    if (!m_titleKeys.isEmpty())
+        m_titleKeys.resize(write);
+
+    int position = 0;
+    for (int i = 0; i < m_order.size(); ++i) {
+        const int slot = newSlots[m_order[i]];
+        if (slot >= 0)
+            m_order[position++] = slot;
+    }
+    m_order.resize(position);
+    m_positions.resize(position);
+    updatePositions(0, position);
+}
+
+/**
+ * @brief Compare two slots
+ */
+bool TodoSorter::less(int a, int b, const TodoStore& store) const
+{
+    for (const Column& column : m_columns) {
+        int result = 0;
+        switch (column.key) {
+            case Key::Priority:
+                result = compareValues(store.priority(a), store.priority(b));
+                break;
+            case Key::CreatedAt:
+                result = compareValues(store.createdAtMs(a), store.createdAtMs(b));
+                break;
+            case Key::ModifiedAt:
+                result = compareValues(store.modifiedAtMs(a), store.modifiedAtMs(b));
+                break;
+            case Key::Title:
+                result = m_titleKeys[a]->compare(*m_titleKeys[b]);
+                break;
+            case Key::Completed:
+                result = compareValues(store.isCompleted(a), store.isCompleted(b));
+                break;
+        }
+        if (result != 0)
+            return column.order == Qt::AscendingOrder ? result < 0 : result > 0;
+    }
+
+    // Equal items keep their insertion order
+    return a < b;
+}
+
+/**
+ * @brief Compute the cached title key of a slot
+ */
+void TodoSorter::updateTitleKey(int slot, const TodoStore& store)
+{
+    m_titleKeys[slot] = m_collator.sortKey(store.title(slot));
+}
+
+/**
+ * @brief Recompute the positions of a range of the order
+ */
+void TodoSorter::updatePositions(int from, int to)
+{
+    for (int position = from; position < to; ++position)
+        m_positions[m_order[position]] = position;
+}
@@ -0,0 +1,191 @@
+/**
+ * @file TodoSorter.h
+ * @brief Sort permutation over the slots of a TodoStore
+ *
+ * This file defines the TodoSorter class which the model uses to show
+ * its items ordered by one or more fields, keeping the order up to date
+ * as items are added and edited instead of sorting again.
+ */
+
+#ifndef TODOSORTER_H
+#define TODOSORTER_H
+
+#include <QVector>
+#include <QCollator>
+#include <optional>
+#include "TodoStore.h"
+
+/**
+ * @class TodoSorter
+ * @brief Maps display positions to store slots and back
+ *
+ * Items are compared column by column; ties fall back to the slot, which
+ * is the insertion order, so every item has exactly one position. With
+ * no columns the order is the slot order and no permutation is stored.
+ *
+ * Titles compare through QCollator sort keys, computed once per item and
+ * cached, with numeric ordering so "Todo 9" sorts before "Todo 10".
+ *
+ * Removed slots keep their position until remap() drops them, so the
+ * order can be kept while the store holds tombstones.
+ */
+class TodoSorter
+{
+public:
+    /**
+     * @enum Key
+     * @brief Fields items can be sorted by
+     */
+    enum class Key {
+        Priority,       ///< Low to Urgent
+        CreatedAt,      ///< Oldest first
+        ModifiedAt,     ///< Least recently modified first
+        Title,          ///< Locale-aware, case-insensitive
+        Completed       ///< Active before completed
+    };
+
+    /**
+     * @struct Column
+     * @brief One sort key and its direction
+     */
+    struct Column {
+        Key key = Key::Title;                       ///< Field compared
+        Qt::SortOrder order = Qt::AscendingOrder;   ///< Direction
+
+        bool operator==(const Column& other) const { return key == other.key && order == other.order; }
+        bool operator!=(const Column& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @brief Construct a sorter keeping slot order
+     */
+    TodoSorter();
+
+    /**
+     * @brief Set the sort columns and sort every slot
+     * @param columns Keys, most significant first; empty for slot order
+     * @param store Store whose slots are ordered
+     */
+    void setColumns(const QVector<Column>& columns, const TodoStore& store);
+
+    /**
+     * @brief Get the sort columns
+     * @return Keys, most significant first
+     */
+    const QVector<Column>& columns() const { return m_columns; }
+
+    /**
+     * @brief Check whether the order differs from slot order
+     * @return true if any column is set
+     */
+    bool isSorted() const { return !m_columns.isEmpty(); }
+
+    /**
+     * @brief Check whether a field takes part in the order
+     * @param key Field to check
+     * @return true if one of the columns compares it
+     */
+    bool dependsOn(Key key) const;
+
+    /**
+     * @brief Get the position of a slot
+     * @param slot Slot in the store
+     * @return Position in the order
+     */
+    int position(int slot) const { return isSorted() ? m_positions[slot] : slot; }
+
+    /**
+     * @brief Get the slot at a position
+     * @param position Position in the order
+     * @return Slot in the store
+     */
+    int slot(int position) const { return isSorted() ? m_order[position] : position; }
+
+    /**
+     * @brief Order every slot of a store from scratch
+     * @param store Store whose slots are ordered
+     */
+    void sort(const TodoStore& store);
+
+    /**
+     * @brief Place a slot just appended to the store, by binary search
+     *
+     * Costs O(log n) comparisons plus O(n) to shift later positions.
+     *
+     * @param slot New slot, the last one of @p store
+     * @param store Store holding the slot
+     * @return Position of the slot
+     */
+    int insert(int slot, const TodoStore& store);
+
+    /**
+     * @brief Place every slot from @p firstSlot on, appended in one batch
+     *
+     * The new slots are sorted among themselves and merged in, so the
+     * cost is O(n + k log k) for k new slots.
+     *
+     * @param firstSlot First new slot
+     * @param store Store holding the slots
+     */
+    void insertRange(int firstSlot, const TodoStore& store);
+
+    /**
+     * @brief Find where an edited slot belongs
+     *
+     * Refreshes the slot's cached title key; the order itself is left
+     * alone so callers can announce the move first.
+     *
+     * @param slot Edited slot
+     * @param store Store holding the new values
+     * @return Position the slot should move to
+     */
+    int findPosition(int slot, const TodoStore& store);
+
+    /**
+     * @brief Move the slot at one position to another
+     *
+     * Only the positions between the two change, in O(|to - from|).
+     *
+     * @param from Current position
+     * @param to New position, from findPosition()
+     */
+    void move(int from, int to);
+
+    /**
+     * @brief Follow a compaction of the store
+     * @param newSlots New slot of every old slot, -1 for dropped ones
+     */
+    void remap(const QVector<int>& newSlots);
+
+private:
+    QVector<Column> m_columns;          ///< Sort keys, most significant first
+    QCollator m_collator;               ///< Compares titles for the current locale
+    QVector<int> m_order;               ///< Position -> slot; empty if not sorted
+    QVector<int> m_positions;           ///< Slot -> position; empty if not sorted
+    QVector<std::optional<QCollatorSortKey>> m_titleKeys; ///< Per slot; empty unless sorting by title
+
+    /**
+     * @brief Compare two slots
+     * @param a First slot
+     * @param b Second slot
+     * @param store Store holding the slots
+     * @return true if @p a goes before @p b
+     */
+    bool less(int a, int b, const TodoStore& store) const;
+
+    /**
+     * @brief Compute the cached title key of a slot if titles are sorted
+     * @param slot Slot in the store
+     * @param store Store holding the slot
+     */
+    void updateTitleKey(int slot, const TodoStore& store);
+
+    /**
+     * @brief Recompute the positions of a range of the order
+     * @param from First position
+     * @param to One past the last position
+     */
+    void updatePositions(int from, int to);
+};
+
+#endif // TODOSORTER_H
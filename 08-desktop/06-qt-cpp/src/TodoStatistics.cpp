@@ -0,0 +1,328 @@
+/**
+ * @file TodoStatistics.cpp
+ * @brief Implementation of TodoStatistics class
+ */
+
+#include "TodoStatistics.h"
+#include "Timestamp.h"
+#include <algorithm>
+
+namespace {
+
+/// Julian day of 1970-01-01; earlier days are not recorded
+constexpr qint64 kFirstDay = 2440588;
+
+/// Days after kFirstDay that are recorded, a guard against corrupt
+/// timestamps blowing up the arrays
+constexpr qint64 kMaxDays = 200 * 366;
+
+/// Most empty days added in front of the history at once; older events
+/// then need no further growth for about a year
+constexpr qint64 kMaxFrontSlack = 366;
+
+/**
+ * @brief Check whether a day may be recorded
+ */
+bool isRecordedDay(qint64 day)
+{
+    return day >= kFirstDay && day < kFirstDay + kMaxDays;
+}
+
+} // namespace
+
+/**
+ * @brief Get a bucket, growing the series to cover it
+ *
+ * Appending is amortized O(1). Days before the first bucket are added
+ * with some slack, so back-filling older history also stays cheap.
+ */
+TodoStatistics::Bucket& TodoStatistics::Series::at(qint64 index)
+{
+    if (buckets.isEmpty()) {
+        first = index;
+        buckets.resize(1);
+        return buckets[0];
+    }
+
+    if (index < first) {
+        const qint64 slack = std::min<qint64>(buckets.size(), kMaxFrontSlack);
+        const qint64 grow = std::max(first - index, slack);
+        buckets.insert(0, grow, Bucket());
+        first -= grow;
+    } else if (index - first >= buckets.size()) {
+        buckets.resize(index - first + 1);
+    }
+    return buckets[index - first];
+}
+
+/**
+ * @brief Get a bucket without growing the series
+ */
+const TodoStatistics::Bucket* TodoStatistics::Series::find(qint64 index) const
+{
+    if (index < first || index - first >= buckets.size())
+        return nullptr;
+    return &buckets[index - first];
+}
+
+/**
+ * @brief Get a writable bucket without growing the series
+ */
+TodoStatistics::Bucket* TodoStatistics::Series::find(qint64 index)
+{
+    if (index < first || index - first >= buckets.size())
+        return nullptr;
+    return &buckets[index - first];
+}
+
+/**
+ * @brief Count every live slot of a store by priority
+ */
+void TodoStatistics::rebuildCounts(const TodoStore& store)
+{
+    m_priorities = {};
+    for (int i = 0; i < store.size(); ++i) {
+        if (store.isLive(i))
+            insert(i, store);
+    }
+}
+
+/**
+ * @brief Add a live slot to the priority counts
+ */
+void TodoStatistics::insert(int slot, const TodoStore& store)
+{
+    if (Counts* counts = countsOf(slot, store)) {
+        if (store.isCompleted(slot))
+            ++counts->completed;
+        else
+            ++counts->active;
+    }
+}
+
+/**
+ * @brief Remove a slot from the priority counts
+ */
+void TodoStatistics::remove(int slot, const TodoStore& store)
+{
+    if (Counts* counts = countsOf(slot, store)) {
+        if (store.isCompleted(slot))
+            --counts->completed;
+        else
+            --counts->active;
+    }
+}
+
+/**
+ * @brief Count a completion or take one back
+ */
+void TodoStatistics::completionChanged(int slot, const TodoStore& store, qint64 previousModifiedMs)
+{
+    const bool completed = store.isCompleted(slot);
+    if (Counts* counts = countsOf(slot, store)) {
+        const int delta = completed ? 1 : -1;
+        counts->completed += delta;
+        counts->active -= delta;
+    }
+
+    // Completing touched the modification time, so it is the completion time
+    if (completed) {
+        const qint64 day = dayOf(store.modifiedAtMs(slot));
+        if (isRecordedDay(day)) {
+            ++m_days.at(day).completed;
+            ++m_weeks.at(day / 7).completed;
+        }
+        return;
+    }
+
+    const qint64 day = dayOf(previousModifiedMs);
+    Bucket* dayBucket = m_days.find(day);
+    Bucket* weekBucket = m_weeks.find(day / 7);
+    if (dayBucket && weekBucket && dayBucket->completed > 0) {
+        --dayBucket->completed;
+        --weekBucket->completed;
+    }
+}
+
+/**
+ * @brief Count a newly created item
+ */
+void TodoStatistics::recordCreated(qint64 createdAtMs)
+{
+    const qint64 day = dayOf(createdAtMs);
+    if (!isRecordedDay(day))
+        return;
+
+    ++m_days.at(day).created;
+    ++m_weeks.at(day / 7).created;
+}
+
+/**
+ * @brief Get the live item counts of a priority
+ */
+TodoStatistics::Counts TodoStatistics::priorityCounts(TodoItem::Priority priority) const
+{
+    const int index = static_cast<int>(priority);
+    return index >= 0 && index < int(m_priorities.size()) ? m_priorities[index] : Counts();
+}
+
+/**
+ * @brief Get the events of consecutive days
+ */
+QVector<TodoStatistics::Bucket> TodoStatistics::days(const QDate& first, int count) const
+{
+    QVector<Bucket> result(qMax(0, count));
+    const qint64 day = first.toJulianDay();
+    for (int i = 0; i < result.size(); ++i) {
+        if (const Bucket* bucket = m_days.find(day + i))
+            result[i] = *bucket;
+    }
+    return result;
+}
+
+/**
+ * @brief Get the events of consecutive weeks
+ */
+QVector<TodoStatistics::Bucket> TodoStatistics::weeks(const QDate& first, int count) const
+{
+    QVector<Bucket> result(qMax(0, count));
+    const qint64 week = first.toJulianDay() / 7;
+    for (int i = 0; i < result.size(); ++i) {
+        if (const Bucket* bucket = m_weeks.find(week + i))
+            result[i] = *bucket;
+    }
+    return result;
+}
+
+/**
+ * @brief Sum the events of the days up to and including a day
+ */
+TodoStatistics::Bucket TodoStatistics::window(const QDate& last, int count) const
+{
+    Bucket total;
+    for (const Bucket& bucket : days(last.addDays(1 - count), count))
+        total += bucket;
+    return total;
+}
+
+/**
+ * @brief Get the average number of completions per day
+ */
+double TodoStatistics::completionRate(const QDate& last, int count) const
+{
+    if (count <= 0)
+        return 0.0;
+    return double(window(last, count).completed) / count;
+}
+
+/**
+ * @brief Get the first day with a recorded event
+ */
+QDate TodoStatistics::firstDay() const
+{
+    // Front slack leaves empty days before the first event
+    for (int i = 0; i < m_days.buckets.size(); ++i) {
+        const Bucket& bucket = m_days.buckets[i];
+        if (bucket.created > 0 || bucket.completed > 0)
+            return QDate::fromJulianDay(m_days.first + i);
+    }
+    return QDate();
+}
+
+/**
+ * @brief Forget the history, keeping the priority counts
+ */
+void TodoStatistics::clearHistory()
+{
+    m_days = Series();
+    m_weeks = Series();
+}
+
+/**
+ * @brief Write the history
+ *
+ * Only days are written, without the empty ones at either end; weeks
+ * are summed again on reading.
+ */
+void TodoStatistics::writeHistory(QDataStream& stream) const
+{
+    const auto isEmpty = [](const Bucket& bucket) {
+        return bucket.created == 0 && bucket.completed == 0;
+    };
+
+    qsizetype begin = 0;
+    qsizetype end = m_days.buckets.size();
+    while (begin < end && isEmpty(m_days.buckets[begin]))
+        ++begin;
+    while (end > begin && isEmpty(m_days.buckets[end - 1]))
+        --end;
+
+    stream << qint64(begin < end ? m_days.first + begin : 0) << qint32(end - begin);
+    for (qsizetype i = begin; i < end; ++i)
+        stream << qint32(m_days.buckets[i].created) << qint32(m_days.buckets[i].completed);
+}
+
+/**
+ * @brief Read a history written by writeHistory()
+ */
+bool TodoStatistics::readHistory(QDataStream& stream)
+{
+    clearHistory();
+
+    qint64 first = 0;
+    qint32 count = 0;
+    stream >> first >> count;
+    if (stream.status() != QDataStream::Ok || count < 0 || count > kMaxDays
+        || (count > 0 && (!isRecordedDay(first) || !isRecordedDay(first + count - 1))))
+        return false;
+
+    Series days;
+    days.first = first;
+    days.buckets.resize(count);
+    Series weeks;
+    for (int i = 0; i < count; ++i) {
+        qint32 created = 0;
+        qint32 completed = 0;
+        stream >> created >> completed;
+        if (created < 0 || completed < 0)
+            return false;
+        days.buckets[i] = {created, completed};
+        if (created > 0 || completed > 0)
+            weeks.at((first + i) / 7) += days.buckets[i];
+    }
+    if (stream.status() != QDataStream::Ok)
+        return false;
+
+    m_days = std::move(days);
+    m_weeks = std::move(weeks);
+    return true;
+}
+
+/**
+ * @brief Get the local Julian day of a time
+ */
+qint64 TodoStatistics::dayOf(qint64 msecs) const
+{
+    if (msecs == Timestamp::kInvalid)
+        return -1;
+    if (msecs >= m_cachedDayStart && msecs < m_cachedDayEnd)
+        return m_cachedDay;
+
+    const QDate date = Timestamp::toDateTime(msecs).date();
+    if (!date.isValid())
+        return -1;
+
+    m_cachedDay = date.toJulianDay();
+    m_cachedDayStart = date.startOfDay().toMSecsSinceEpoch();
+    m_cachedDayEnd = date.addDays(1).startOfDay().toMSecsSinceEpoch();
+    return m_cachedDay;
+}
+
+/**
+ * @brief Get the counts of a slot's priority
+ */
+TodoStatistics::Counts* TodoStatistics::countsOf(int slot, const TodoStore& store)
+{
+    const int index = static_cast<int>(store.priority(slot));
+    return index >= 0 && index < int(m_priorities.size()) ? &m_priorities[index] : nullptr;
+}
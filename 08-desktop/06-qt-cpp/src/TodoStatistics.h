@@ -0,0 +1,215 @@
+/**
+ * @file TodoStatistics.h
+ * @brief Productivity statistics kept up to date by the model
+ *
+ * This file defines the TodoStatistics class which counts created and
+ * completed items per day and per week, and live items per priority.
+ */
+
+#ifndef TODOSTATISTICS_H
+#define TODOSTATISTICS_H
+
+#include <QVector>
+#include <QDate>
+#include <QDataStream>
+#include <array>
+#include "TodoStore.h"
+
+/**
+ * @class TodoStatistics
+ * @brief Time-bucketed history and per-priority counts of a todo list
+ *
+ * The history counts events: items created on a day (by their creation
+ * time) and completions made on a day. It outlives the items, so it is
+ * persisted on its own instead of being derived from the list. Days and
+ * weeks are dense arrays starting at the earliest bucket used, so
+ * recording an event is an index computation; weeks start on Monday.
+ *
+ * Reopening an item takes its completion back from the day it was last
+ * modified, which is the day it was completed unless it was edited
+ * since.
+ *
+ * The priority counts describe the current list like CategoryIndex
+ * does for categories: callers insert a slot once it is live, remove it
+ * before its priority changes or it is removed, and report completion
+ * changes. rebuildCounts() starts over for a new store and keeps the
+ * history.
+ *
+ * Converting a time to a local day needs a time zone lookup; the
+ * boundaries of the last day looked up are cached, so the edits of one
+ * day only compare integers.
+ */
+class TodoStatistics
+{
+public:
+    /**
+     * @struct Counts
+     * @brief Live items of one priority
+     */
+    struct Counts {
+        int active = 0;         ///< Items not completed
+        int completed = 0;      ///< Completed items
+
+        int total() const { return active + completed; }
+    };
+
+    /**
+     * @struct Bucket
+     * @brief Events of one day or week
+     */
+    struct Bucket {
+        int created = 0;        ///< Items created
+        int completed = 0;      ///< Items completed
+
+        Bucket& operator+=(const Bucket& other)
+        {
+            created += other.created;
+            completed += other.completed;
+            return *this;
+        }
+    };
+
+    /**
+     * @brief Count every live slot of a store by priority
+     * @param store Store to count
+     */
+    void rebuildCounts(const TodoStore& store);
+
+    /**
+     * @brief Add a live slot to the priority counts
+     * @param slot Slot in the store
+     * @param store Store holding the slot
+     */
+    void insert(int slot, const TodoStore& store);
+
+    /**
+     * @brief Remove a slot from the priority counts
+     * @param slot Slot in the store, still holding its counted priority
+     * @param store Store holding the slot
+     */
+    void remove(int slot, const TodoStore& store);
+
+    /**
+     * @brief Count a completion or take one back
+     * @param slot Slot whose completion status just changed in the store
+     * @param store Store holding the slot
+     * @param previousModifiedMs Modification time of the slot before the change
+     */
+    void completionChanged(int slot, const TodoStore& store, qint64 previousModifiedMs);
+
+    /**
+     * @brief Count a newly created item
+     * @param createdAtMs Creation time in ms since epoch
+     */
+    void recordCreated(qint64 createdAtMs);
+
+    /**
+     * @brief Get the live item counts of a priority
+     * @param priority Priority level
+     * @return Active and completed counts
+     */
+    Counts priorityCounts(TodoItem::Priority priority) const;
+
+    /**
+     * @brief Get the events of consecutive days
+     * @param first First day
+     * @param count Number of days
+     * @return One bucket per day, empty buckets outside the history
+     */
+    QVector<Bucket> days(const QDate& first, int count) const;
+
+    /**
+     * @brief Get the events of consecutive weeks
+     * @param first Any day of the first week
+     * @param count Number of weeks
+     * @return One bucket per week
+     */
+    QVector<Bucket> weeks(const QDate& first, int count) const;
+
+    /**
+     * @brief Sum the events of the days up to and including a day
+     * @param last Last day of the window, usually today
+     * @param count Number of days in the window
+     * @return Totals of the window
+     */
+    Bucket window(const QDate& last, int count) const;
+
+    /**
+     * @brief Get the average number of completions per day
+     * @param last Last day of the window, usually today
+     * @param count Number of days in the window
+     * @return Completions divided by @p count
+     */
+    double completionRate(const QDate& last, int count) const;
+
+    /**
+     * @brief Get the first day with a recorded event
+     * @return Day, invalid if the history is empty
+     */
+    QDate firstDay() const;
+
+    /**
+     * @brief Forget the history, keeping the priority counts
+     */
+    void clearHistory();
+
+    /**
+     * @brief Write the history
+     * @param stream Stream to write to
+     */
+    void writeHistory(QDataStream& stream) const;
+
+    /**
+     * @brief Read a history written by writeHistory()
+     * @param stream Stream to read from
+     * @return false if the data is damaged; the history is then left empty
+     */
+    bool readHistory(QDataStream& stream);
+
+private:
+    /**
+     * @struct Series
+     * @brief Buckets of consecutive days or weeks
+     */
+    struct Series {
+        qint64 first = 0;       ///< Day or week number of buckets[0]
+        QVector<Bucket> buckets; ///< Events, dense from first on
+
+        /**
+         * @brief Get a bucket, growing the series to cover it
+         * @param index Day or week number
+         * @return Bucket
+         */
+        Bucket& at(qint64 index);
+
+        /**
+         * @brief Get a bucket without growing the series
+         * @param index Day or week number
+         * @return Bucket, or nullptr outside the series
+         */
+        const Bucket* find(qint64 index) const;
+        Bucket* find(qint64 index);
+    };
+
+    Series m_days;              ///< Buckets by Julian day
+    Series m_weeks;             ///< Buckets by Julian day / 7
+    std::array<Counts, 4> m_priorities; ///< Indexed by TodoItem::Priority
+    mutable qint64 m_cachedDayStart = 0; ///< Start of the last day looked up, ms since epoch
+    mutable qint64 m_cachedDayEnd = 0;   ///< End of that day, exclusive
+    mutable qint64 m_cachedDay = 0;      ///< Julian day of that day
+
+    /**
+     * @brief Get the local Julian day of a time
+     * @param msecs Milliseconds since the epoch
+     * @return Julian day, or -1 for an invalid time
+     */
+    qint64 dayOf(qint64 msecs) const;
+
+    /**
+     * @brief Get the counts of a slot's priority
+     * @return Counts, or nullptr if the priority is out of range
+     */
+    Counts* countsOf(int slot, const TodoStore& store);
+};
+
+#endif // TODOSTATISTICS_H
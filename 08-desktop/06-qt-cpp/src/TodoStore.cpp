@@ -0,0 +1,363 @@
+/**
+ * @file TodoStore.cpp
+ * @brief Implementation of TodoStore class
+ */
+
+#include "TodoStore.h"
+#include <limits>
+
+namespace {
+
+/// Title reference of a slot whose title lives in m_titles
+constexpr quint64 kDecodedTitle = ~quint64(0);
+
+/**
+ * @brief Append one bit to a bit array
+ */
+void appendBit(QBitArray& bits, bool value)
+{
+    const int index = bits.size();
+    bits.resize(index + 1);
+    if (value)
+        bits.setBit(index);
+}
+
+} // namespace
+
+/**
+ * @brief Construct a store holding the given items
+ */
+TodoStore::TodoStore(const QVector<TodoItem>& items)
+{
+    reserve(items.size());
+    for (const TodoItem& item : items) {
+        append(item);
+    }
+}
+
+/**
+ * @brief Reserve space for a number of slots
+ */
+void TodoStore::reserve(int size)
+{
+    m_ids.reserve(size);
+    m_titles.reserve(size);
+    m_priorities.reserve(size);
+    m_createdAt.reserve(size);
+    m_modifiedAt.reserve(size);
+    m_categories.reserve(size);
+}
+
+/**
+ * @brief Remove every slot
+ */
+void TodoStore::clear()
+{
+    *this = TodoStore();
+}
+
+/**
+ * @brief Append an item in a new slot
+ */
+void TodoStore::append(const TodoItem& item)
+{
+    m_ids.append(item.getUuid());
+    m_titles.append(item.getTitle());
+    if (!m_titleRefs.isEmpty())
+        m_titleRefs.append(kDecodedTitle);
+    appendBit(m_completed, item.isCompleted());
+    m_priorities.append(static_cast<char>(item.getPriority()));
+    m_createdAt.append(item.createdAtMs());
+    m_modifiedAt.append(item.modifiedAtMs());
+    m_categories.append(internCategory(item.getCategory()));
+    appendBit(m_removed, false);
+}
+
+/**
+ * @brief Append an item whose title is still encoded in the title heap
+ */
+void TodoStore::appendEncoded(const QUuid& id, quint32 titleOffset, quint32 titleLength,
+                              bool completed, TodoItem::Priority priority, int category,
+                              qint64 createdAtMs, qint64 modifiedAtMs)
+{
+    // Slots appended before the first encoded one hold decoded titles
+    if (m_titleRefs.isEmpty())
+        m_titleRefs.fill(kDecodedTitle, size());
+
+    m_ids.append(id);
+    m_titles.append(QString());
+    m_titleRefs.append(quint64(titleOffset) << 32 | titleLength);
+    appendBit(m_completed, completed);
+    m_priorities.append(static_cast<char>(priority));
+    m_createdAt.append(createdAtMs);
+    m_modifiedAt.append(modifiedAtMs);
+    m_categories.append(category);
+    appendBit(m_removed, false);
+}
+
+/**
+ * @brief Append the live items of another store
+ */
+void TodoStore::append(const TodoStore& other)
+{
+    // Encoded titles move over as references into the combined heap
+    const quint64 base = quint64(m_titleHeap.size());
+    const bool shareHeap = !other.m_titleRefs.isEmpty()
+                           && base + quint64(other.m_titleHeap.size()) <= std::numeric_limits<quint32>::max();
+    if (shareHeap)
+        m_titleHeap.append(other.m_titleHeap);
+
+    reserve(size() + other.liveCount());
+    for (int i = 0; i < other.size(); ++i) {
+        if (!other.isLive(i))
+            continue;
+
+        const quint64 ref = other.m_titleRefs.isEmpty() ? kDecodedTitle : other.m_titleRefs.at(i);
+        m_ids.append(other.m_ids.at(i));
+        if (shareHeap && ref != kDecodedTitle) {
+            // Slots appended before the first encoded one hold decoded titles
+            if (m_titleRefs.isEmpty())
+                m_titleRefs.fill(kDecodedTitle, m_titles.size());
+            m_titles.append(QString());
+            m_titleRefs.append(ref + (base << 32));
+        } else {
+            m_titles.append(other.titleValue(i));
+            if (!m_titleRefs.isEmpty())
+                m_titleRefs.append(kDecodedTitle);
+        }
+        appendBit(m_completed, other.isCompleted(i));
+        m_priorities.append(other.m_priorities.at(i));
+        m_createdAt.append(other.m_createdAt.at(i));
+        m_modifiedAt.append(other.m_modifiedAt.at(i));
+        m_categories.append(internCategory(other.category(i)));
+        appendBit(m_removed, false);
+    }
+}
+
+/**
+ * @brief Overwrite every field of a slot
+ */
+void TodoStore::replace(int index, const TodoItem& item)
+{
+    m_ids[index] = item.getUuid();
+    m_titles[index] = item.getTitle();
+    if (!m_titleRefs.isEmpty())
+        m_titleRefs[index] = kDecodedTitle;
+    m_completed.setBit(index, item.isCompleted());
+    m_priorities[index] = static_cast<char>(item.getPriority());
+    m_createdAt[index] = item.createdAtMs();
+    m_modifiedAt[index] = item.modifiedAtMs();
+    m_categories[index] = internCategory(item.getCategory());
+}
+
+/**
+ * @brief Mark a slot as removed
+ */
+void TodoStore::remove(int index)
+{
+    if (m_removed.testBit(index))
+        return;
+
+    m_removed.setBit(index);
+    ++m_removedCount;
+}
+
+/**
+ * @brief Bring back a removed slot
+ */
+void TodoStore::restore(int index)
+{
+    if (!m_removed.testBit(index))
+        return;
+
+    m_removed.clearBit(index);
+    --m_removedCount;
+}
+
+/**
+ * @brief Drop removed slots, moving later items down
+ */
+int TodoStore::compact()
+{
+    const int count = size();
+    int first = 0;
+    while (first < count && isLive(first))
+        ++first;
+
+    if (first == count)
+        return count;
+
+    int write = first;
+    for (int read = first; read < count; ++read) {
+        if (!isLive(read))
+            continue;
+        m_ids[write] = m_ids[read];
+        m_titles[write] = std::move(m_titles[read]);
+        if (!m_titleRefs.isEmpty())
+            m_titleRefs[write] = m_titleRefs[read];
+        m_completed.setBit(write, m_completed.testBit(read));
+        m_priorities[write] = m_priorities[read];
+        m_createdAt[write] = m_createdAt[read];
+        m_modifiedAt[write] = m_modifiedAt[read];
+        m_categories[write] = m_categories[read];
+        ++write;
+    }
+
+    m_ids.resize(write);
+    m_titles.resize(write);
+    if (!m_titleRefs.isEmpty())
+        m_titleRefs.resize(write);
+    m_completed.resize(write);
+    m_priorities.resize(write);
+    m_createdAt.resize(write);
+    m_modifiedAt.resize(write);
+    m_categories.resize(write);
+    m_removed = QBitArray(write);
+    m_removedCount = 0;
+    return first;
+}
+
+/**
+ * @brief Build a TodoItem from a slot
+ */
+TodoItem TodoStore::item(int index) const
+{
+    return TodoItem(m_ids[index], titleValue(index), isCompleted(index), priority(index),
+                    category(index), m_createdAt[index], m_modifiedAt[index]);
+}
+
+/**
+ * @brief Build TodoItems for every live slot
+ */
+QVector<TodoItem> TodoStore::toItems() const
+{
+    QVector<TodoItem> items;
+    items.reserve(liveCount());
+    for (int i = 0; i < size(); ++i) {
+        if (isLive(i))
+            items.append(item(i));
+    }
+    return items;
+}
+
+/**
+ * @brief Get the title of a slot, decoding it on first access
+ *
+ * Decoding writes to the title columns, which detaches them if the store
+ * is shared with a copy; the copy keeps its own state.
+ */
+const QString& TodoStore::title(int index) const
+{
+    if (!m_titleRefs.isEmpty() && m_titleRefs.at(index) != kDecodedTitle) {
+        m_titles[index] = titleValue(index);
+        m_titleRefs[index] = kDecodedTitle;
+    }
+    return m_titles.at(index);
+}
+
+/**
+ * @brief Get a title without caching it
+ *
+ * Used when building TodoItems, so that saving a loaded list on a worker
+ * thread does not decode every title into the shared columns.
+ */
+QString TodoStore::titleValue(int index) const
+{
+    if (m_titleRefs.isEmpty() || m_titleRefs.at(index) == kDecodedTitle)
+        return m_titles.at(index);
+
+    const quint64 ref = m_titleRefs.at(index);
+    return QString::fromUtf8(m_titleHeap.constData() + (ref >> 32), qsizetype(ref & 0xffffffffu));
+}
+
+/**
+ * @brief Get the creation time of a slot
+ */
+QDateTime TodoStore::createdAt(int index) const
+{
+    return Timestamp::toDateTime(m_createdAt[index]);
+}
+
+/**
+ * @brief Get the modification time of a slot
+ */
+QDateTime TodoStore::modifiedAt(int index) const
+{
+    return Timestamp::toDateTime(m_modifiedAt[index]);
+}
+
+/**
+ * @brief Set the title of a slot
+ */
+bool TodoStore::setTitle(int index, const QString& title)
+{
+    if (this->title(index) == title)
+        return false;
+
+    m_titles[index] = title;
+    m_modifiedAt[index] = Timestamp::now();
+    return true;
+}
+
+/**
+ * @brief Set the completion status of a slot
+ */
+bool TodoStore::setCompleted(int index, bool completed)
+{
+    if (isCompleted(index) == completed)
+        return false;
+
+    m_completed.setBit(index, completed);
+    m_modifiedAt[index] = Timestamp::now();
+    return true;
+}
+
+/**
+ * @brief Set the priority of a slot
+ */
+bool TodoStore::setPriority(int index, TodoItem::Priority priority)
+{
+    if (this->priority(index) == priority)
+        return false;
+
+    m_priorities[index] = static_cast<char>(priority);
+    m_modifiedAt[index] = Timestamp::now();
+    return true;
+}
+
+/**
+ * @brief Set the category of a slot
+ */
+bool TodoStore::setCategory(int index, const QString& category)
+{
+    const int poolIndex = internCategory(category);
+    if (m_categories[index] == poolIndex)
+        return false;
+
+    m_categories[index] = poolIndex;
+    m_modifiedAt[index] = Timestamp::now();
+    return true;
+}
+
+/**
+ * @brief Count live completed items
+ */
+int TodoStore::countCompleted() const
+{
+    return (m_completed & ~m_removed).count(true);
+}
+
+/**
+ * @brief Get the pool index of a category, adding it if new
+ */
+int TodoStore::internCategory(const QString& category)
+{
+    auto it = m_categoryLookup.constFind(category);
+    if (it != m_categoryLookup.cend())
+        return it.value();
+
+    const int poolIndex = m_categoryPool.size();
+    m_categoryPool.append(category);
+    m_categoryLookup.insert(category, poolIndex);
+    return poolIndex;
+}
@@ -0,0 +1,258 @@
+/**
+ * @file TodoStore.h
+ * @brief Column-oriented storage for todo items
+ *
+ * This file defines the TodoStore class which holds every field of the
+ * todo list in its own dense array. The model keeps its items here and
+ * hands copies of the store to the storage layer.
+ */
+
+#ifndef TODOSTORE_H
+#define TODOSTORE_H
+
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QUuid>
+#include <QBitArray>
+#include <QByteArray>
+#include <QDateTime>
+#include "TodoItem.h"
+
+/**
+ * @class TodoStore
+ * @brief Structure-of-arrays container for todo items
+ *
+ * Each field lives in its own array: completion as a bitset, priority as
+ * one byte per item, timestamps as milliseconds since the epoch and
+ * categories as indices into a pool of distinct names. Filtering and
+ * counting therefore scan only the columns they need.
+ *
+ * Items are addressed by slot. remove() leaves a tombstone so the other
+ * slots stay put; compact() reclaims them. Copies share their columns
+ * implicitly, so copying a store is O(1) and safe to hand to a worker
+ * thread.
+ *
+ * TodoItem remains the value type at API boundaries: item() builds one
+ * from a slot and append() takes one apart.
+ *
+ * Titles loaded from a binary snapshot stay encoded in a shared UTF-8
+ * heap until title() first asks for them, so loading a large list does
+ * not build a QString per item.
+ */
+class TodoStore
+{
+public:
+    /**
+     * @brief Construct an empty store
+     */
+    TodoStore() = default;
+
+    /**
+     * @brief Construct a store holding the given items
+     * @param items Items in slot order
+     */
+    explicit TodoStore(const QVector<TodoItem>& items);
+
+    /**
+     * @brief Get the number of slots, including removed ones
+     * @return Slot count
+     */
+    int size() const { return m_ids.size(); }
+
+    /**
+     * @brief Get the number of items that were not removed
+     * @return Live item count
+     */
+    int liveCount() const { return size() - m_removedCount; }
+
+    /**
+     * @brief Get the number of removed slots awaiting compaction
+     * @return Tombstone count
+     */
+    int removedCount() const { return m_removedCount; }
+
+    /**
+     * @brief Reserve space for a number of slots
+     * @param size Expected slot count
+     */
+    void reserve(int size);
+
+    /**
+     * @brief Remove every slot
+     */
+    void clear();
+
+    /**
+     * @brief Append an item in a new slot
+     * @param item Item to store
+     */
+    void append(const TodoItem& item);
+
+    /**
+     * @brief Append the live items of another store
+     *
+     * Titles still encoded in @p other stay encoded: its heap is appended
+     * to this one unless the result would outgrow 32-bit offsets.
+     *
+     * @param other Store to copy items from; must not be this store
+     */
+    void append(const TodoStore& other);
+
+    /**
+     * @brief Append an item whose title is still encoded in the title heap
+     * @param id Item id
+     * @param titleOffset Byte offset of the UTF-8 title in the heap
+     * @param titleLength Byte length of the title
+     * @param completed Completion status
+     * @param priority Priority level
+     * @param category Pool index returned by internCategory()
+     * @param createdAtMs Creation time in ms since epoch
+     * @param modifiedAtMs Modification time in ms since epoch
+     */
+    void appendEncoded(const QUuid& id, quint32 titleOffset, quint32 titleLength,
+                       bool completed, TodoItem::Priority priority, int category,
+                       qint64 createdAtMs, qint64 modifiedAtMs);
+
+    /**
+     * @brief Set the UTF-8 heap encoded titles point into
+     * @param heap String heap of a binary snapshot
+     */
+    void setTitleHeap(const QByteArray& heap) { m_titleHeap = heap; }
+
+    /**
+     * @brief Overwrite every field of a slot
+     * @param index Slot index
+     * @param item New value
+     */
+    void replace(int index, const TodoItem& item);
+
+    /**
+     * @brief Mark a slot as removed
+     * @param index Slot index
+     */
+    void remove(int index);
+
+    /**
+     * @brief Bring back a removed slot
+     *
+     * A removed slot keeps its fields until compact(), so the item
+     * returns exactly as it was removed.
+     *
+     * @param index Slot index
+     */
+    void restore(int index);
+
+    /**
+     * @brief Check whether a slot holds an item
+     * @param index Slot index
+     * @return false if the slot was removed
+     */
+    bool isLive(int index) const { return !m_removed.testBit(index); }
+
+    /**
+     * @brief Drop removed slots, moving later items down
+     * @return First slot whose item changed, or size() if none moved
+     */
+    int compact();
+
+    /**
+     * @brief Build a TodoItem from a slot
+     *
+     * Unlike title(), this never writes to the store, so several threads
+     * may call it on one store at the same time.
+     *
+     * @param index Slot index
+     * @return Item value
+     */
+    TodoItem item(int index) const;
+
+    /**
+     * @brief Build TodoItems for every live slot
+     * @return Items in slot order
+     */
+    QVector<TodoItem> toItems() const;
+
+    // Column getters
+    const QUuid& id(int index) const { return m_ids[index]; }
+    const QString& title(int index) const;
+    bool isCompleted(int index) const { return m_completed.testBit(index); }
+    TodoItem::Priority priority(int index) const { return static_cast<TodoItem::Priority>(m_priorities[index]); }
+    const QString& category(int index) const { return m_categoryPool[m_categories[index]]; }
+    int categoryIndex(int index) const { return m_categories[index]; }
+    qint64 createdAtMs(int index) const { return m_createdAt[index]; }
+    qint64 modifiedAtMs(int index) const { return m_modifiedAt[index]; }
+    QDateTime createdAt(int index) const;
+    QDateTime modifiedAt(int index) const;
+
+    // Column setters; each returns true and touches the modification
+    // time if the value changed
+    bool setTitle(int index, const QString& title);
+    bool setCompleted(int index, bool completed);
+    bool setPriority(int index, TodoItem::Priority priority);
+    bool setCategory(int index, const QString& category);
+
+    /**
+     * @brief Count live completed items with a scan of the bitsets
+     * @return Completed item count
+     */
+    int countCompleted() const;
+
+    /**
+     * @brief Get the completion column
+     * @return One bit per slot
+     */
+    const QBitArray& completedBits() const { return m_completed; }
+
+    /**
+     * @brief Get the priority column
+     * @return One byte per slot holding TodoItem::Priority
+     */
+    const QByteArray& priorities() const { return m_priorities; }
+
+    /**
+     * @brief Get the pool index of a category, adding it if new
+     * @param category Category name
+     * @return Index into the category pool
+     */
+    int internCategory(const QString& category);
+
+    /**
+     * @brief Get the pool index of a category without adding it
+     * @param category Category name
+     * @return Index into the category pool, or -1 if no slot ever used it
+     */
+    int findCategory(const QString& category) const { return m_categoryLookup.value(category, -1); }
+
+    /**
+     * @brief Get a category by its pool index
+     * @param poolIndex Index from internCategory() or findCategory()
+     * @return Category name
+     */
+    const QString& categoryName(int poolIndex) const { return m_categoryPool[poolIndex]; }
+
+private:
+    QVector<QUuid> m_ids;               ///< Item ids
+    mutable QVector<QString> m_titles;  ///< Item titles, null until decoded
+    mutable QVector<quint64> m_titleRefs; ///< Heap offset << 32 | length per slot; empty if all decoded
+    QByteArray m_titleHeap;             ///< UTF-8 titles of a loaded snapshot
+    QBitArray m_completed;              ///< Completion flags
+    QByteArray m_priorities;            ///< Priority levels
+    QVector<qint64> m_createdAt;        ///< Creation times, ms since epoch
+    QVector<qint64> m_modifiedAt;       ///< Modification times, ms since epoch
+    QVector<int> m_categories;          ///< Index into m_categoryPool
+    QStringList m_categoryPool;         ///< Distinct category names
+    QHash<QString, int> m_categoryLookup; ///< Category name -> pool index
+    QBitArray m_removed;                ///< Tombstones of removed slots
+    int m_removedCount = 0;             ///< Number of set bits in m_removed
+
+    /**
+     * @brief Get a title without caching it
+     * @param index Slot index
+     * @return Title, decoded from the heap if necessary
+     */
+    QString titleValue(int index) const;
+};
+
+#endif // TODOSTORE_H
@@ -0,0 +1,118 @@
+/**
+ * @file TrigramIndex.cpp
+ * @brief Implementation of TrigramIndex class
+ */
+
+#include "TrigramIndex.h"
+#include <algorithm>
+
+/**
+ * @brief Remove every posting
+ */
+void TrigramIndex::clear()
+{
+    m_postings.clear();
+}
+
+/**
+ * @brief Index the text of a slot
+ */
+void TrigramIndex::insert(int slot, const QString& text)
+{
+    for (quint64 gram : grams(text)) {
+        QVector<int>& list = m_postings[gram];
+        if (list.isEmpty() || list.last() < slot) {
+            list.append(slot);
+            continue;
+        }
+        // Edited items go back to their place in the list
+        auto it = std::lower_bound(list.begin(), list.end(), slot);
+        if (*it != slot)
+            list.insert(it, slot);
+    }
+}
+
+/**
+ * @brief Remove a slot's postings
+ */
+void TrigramIndex::remove(int slot, const QString& text)
+{
+    for (quint64 gram : grams(text)) {
+        auto posting = m_postings.find(gram);
+        if (posting == m_postings.end())
+            continue;
+
+        QVector<int>& list = posting.value();
+        auto it = std::lower_bound(list.begin(), list.end(), slot);
+        if (it != list.end() && *it == slot)
+            list.erase(it);
+        if (list.isEmpty())
+            m_postings.erase(posting);
+    }
+}
+
+/**
+ * @brief Find the slots whose text holds every trigram of a query
+ */
+QVector<int> TrigramIndex::candidates(const QString& query) const
+{
+    QVector<const QVector<int>*> lists;
+    for (quint64 gram : grams(query)) {
+        auto posting = m_postings.constFind(gram);
+        if (posting == m_postings.cend())
+            return {};
+        lists.append(&posting.value());
+    }
+    if (lists.isEmpty())
+        return {};
+
+    std::sort(lists.begin(), lists.end(),
+              [](const QVector<int>* a, const QVector<int>* b) { return a->size() < b->size(); });
+
+    // Narrow the shortest list by binary searches into the longer ones;
+    // each search starts where the previous one ended
+    QVector<int> result = *lists.first();
+    for (int i = 1; i < lists.size() && !result.isEmpty(); ++i) {
+        const QVector<int>& list = *lists[i];
+        auto from = list.cbegin();
+        int kept = 0;
+        for (int j = 0; j < result.size(); ++j) {
+            const int slot = result[j];
+            from = std::lower_bound(from, list.cend(), slot);
+            if (from == list.cend())
+                break;
+            if (*from == slot)
+                result[kept++] = slot;
+        }
+        result.resize(kept);
+    }
+    return result;
+}
+
+/**
+ * @brief Get the distinct trigram keys of a text
+ */
+QVector<quint64> TrigramIndex::grams(const QString& text)
+{
+    const QString folded = text.toCaseFolded();
+    QVector<quint64> keys;
+    keys.reserve(folded.size());
+
+    // Three UTF-16 units packed into one key; '\n' separates fields
+    int lineStart = 0;
+    for (int i = 0; i < folded.size(); ++i) {
+        if (folded[i] == QLatin1Char('\n')) {
+            lineStart = i + 1;
+            continue;
+        }
+        if (i - lineStart + 1 < kGramLength)
+            continue;
+        keys.append(quint64(folded[i - 2].unicode()) << 32
+                    | quint64(folded[i - 1].unicode()) << 16
+                    | folded[i].unicode());
+    }
+
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
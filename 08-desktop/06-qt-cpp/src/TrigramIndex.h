@@ -0,0 +1,89 @@
+/**
+ * @file TrigramIndex.h
+ * @brief Inverted index of three-character substrings
+ *
+ * This file defines the TrigramIndex class which the model uses to find
+ * the items containing a search string without scanning every title.
+ */
+
+#ifndef TRIGRAMINDEX_H
+#define TRIGRAMINDEX_H
+
+#include <QVector>
+#include <QHash>
+#include <QString>
+
+/**
+ * @class TrigramIndex
+ * @brief Maps every trigram of a text to the slots whose text holds it
+ *
+ * Texts are case folded and each line is indexed on its own, so a text
+ * made of several fields joined by '\n' never matches across them. Each
+ * posting list is kept sorted; slots are usually added in increasing
+ * order, which makes an insert an append.
+ *
+ * A query returns the slots holding every trigram of the search string.
+ * That is a superset of the slots containing the string, so callers
+ * confirm each candidate against the text itself.
+ */
+class TrigramIndex
+{
+public:
+    /// Length of an indexed substring; shorter queries cannot use the index
+    static constexpr int kGramLength = 3;
+
+    /**
+     * @brief Remove every posting
+     */
+    void clear();
+
+    /**
+     * @brief Index the text of a slot
+     * @param slot Slot the text belongs to
+     * @param text Text to index
+     */
+    void insert(int slot, const QString& text);
+
+    /**
+     * @brief Remove a slot's postings
+     * @param slot Slot the text belongs to
+     * @param text Text that was indexed for the slot
+     */
+    void remove(int slot, const QString& text);
+
+    /**
+     * @brief Check whether a query can be answered from the index
+     * @param query Search string
+     * @return true if the query is at least kGramLength characters long
+     */
+    static bool canQuery(const QString& query) { return query.size() >= kGramLength; }
+
+    /**
+     * @brief Find the slots whose text holds every trigram of a query
+     *
+     * Posting lists are intersected from the shortest up, so the cost
+     * follows the rarest trigram rather than the number of slots.
+     *
+     * @param query Search string; canQuery() must be true
+     * @return Candidate slots in increasing order
+     */
+    QVector<int> candidates(const QString& query) const;
+
+    /**
+     * @brief Get the number of distinct trigrams
+     * @return Posting list count
+     */
+    int gramCount() const { return m_postings.size(); }
+
+private:
+    QHash<quint64, QVector<int>> m_postings;   ///< Trigram key -> sorted slots
+
+    /**
+     * @brief Get the distinct trigram keys of a text
+     * @param text Text to split
+     * @return Keys, each once
+     */
+    static QVector<quint64> grams(const QString& text);
+};
+
+#endif // TRIGRAMINDEX_H
@@ -0,0 +1,180 @@
+/**
+ * @file UndoHistory.cpp
+ * @brief Implementation of UndoHistory class
+ */
+
+#include "UndoHistory.h"
+#include <QDebug>
+#include <utility>
+
+/**
+ * @brief Estimate the memory the record holds
+ */
+qsizetype UndoOp::cost() const
+{
+    qsizetype bytes = qsizetype(sizeof(UndoOp))
+                    + ids.size() * qsizetype(sizeof(QUuid))
+                    + oldSlots.size() * qsizetype(sizeof(int))
+                    + text.size() * qsizetype(sizeof(QChar));
+    for (const TodoItem& item : items) {
+        bytes += qsizetype(sizeof(TodoItem))
+               + (item.getTitle().size() + item.getCategory().size()) * qsizetype(sizeof(QChar));
+    }
+    return bytes;
+}
+
+/**
+ * @brief Record the inverse of a new edit
+ */
+void UndoHistory::record(const QString& text, UndoOp&& op)
+{
+    // A new edit starts another branch; what was undone stays undone
+    for (const Entry& entry : std::as_const(m_redo))
+        m_memoryUsage -= entry.cost;
+    m_redo.clear();
+
+    const qsizetype cost = op.cost();
+    if (isGrouping()) {
+        m_group.ops.append(std::move(op));
+        m_group.cost += cost;
+        return;
+    }
+
+    Entry entry;
+    entry.text = text;
+    entry.ops.append(std::move(op));
+    entry.cost = cost;
+    push(m_undo, std::move(entry));
+}
+
+/**
+ * @brief Collect the following edits into one entry
+ */
+void UndoHistory::beginGroup(const QString& text)
+{
+    if (m_groupDepth++ > 0)
+        return;
+
+    m_group = Entry();
+    m_group.text = text;
+}
+
+/**
+ * @brief Close the group opened by beginGroup()
+ */
+void UndoHistory::endGroup()
+{
+    if (m_groupDepth == 0) {
+        qWarning() << "UndoHistory::endGroup() without beginGroup()";
+        return;
+    }
+    if (--m_groupDepth > 0)
+        return;
+
+    Entry group = std::exchange(m_group, Entry());
+    if (!group.ops.isEmpty())
+        push(m_undo, std::move(group));
+}
+
+/**
+ * @brief Take the newest entry off the undo stack
+ */
+UndoHistory::Entry UndoHistory::takeUndo()
+{
+    return take(m_undo);
+}
+
+/**
+ * @brief Take the newest entry off the redo stack
+ */
+UndoHistory::Entry UndoHistory::takeRedo()
+{
+    return take(m_redo);
+}
+
+/**
+ * @brief Put an entry on the undo stack
+ */
+void UndoHistory::pushUndo(const QString& text, QVector<UndoOp>&& ops)
+{
+    if (ops.isEmpty())
+        return;
+
+    Entry entry;
+    entry.text = text;
+    entry.ops = std::move(ops);
+    for (const UndoOp& op : std::as_const(entry.ops))
+        entry.cost += op.cost();
+    push(m_undo, std::move(entry));
+}
+
+/**
+ * @brief Put an entry on the redo stack
+ */
+void UndoHistory::pushRedo(const QString& text, QVector<UndoOp>&& ops)
+{
+    if (ops.isEmpty())
+        return;
+
+    Entry entry;
+    entry.text = text;
+    entry.ops = std::move(ops);
+    for (const UndoOp& op : std::as_const(entry.ops))
+        entry.cost += op.cost();
+    push(m_redo, std::move(entry));
+}
+
+/**
+ * @brief Drop every entry and any open group
+ */
+void UndoHistory::clear()
+{
+    m_undo.clear();
+    m_redo.clear();
+    m_group = Entry();
+    m_groupDepth = 0;
+    m_memoryUsage = 0;
+}
+
+/**
+ * @brief Set the memory the history may use
+ */
+void UndoHistory::setMemoryLimit(qsizetype bytes)
+{
+    m_memoryLimit = qMax<qsizetype>(0, bytes);
+    trim();
+}
+
+/**
+ * @brief Put an entry on a stack and enforce the memory limit
+ */
+void UndoHistory::push(QList<Entry>& stack, Entry&& entry)
+{
+    m_memoryUsage += entry.cost;
+    stack.append(std::move(entry));
+    trim();
+}
+
+/**
+ * @brief Take the newest entry off a stack
+ */
+UndoHistory::Entry UndoHistory::take(QList<Entry>& stack)
+{
+    Entry entry = stack.takeLast();
+    m_memoryUsage -= entry.cost;
+    return entry;
+}
+
+/**
+ * @brief Drop the oldest entries until the history fits its limit
+ *
+ * Undo entries go first, oldest first, then the redo entries furthest
+ * from the present. The newest entry of each stack always stays.
+ */
+void UndoHistory::trim()
+{
+    while (m_memoryUsage > m_memoryLimit && m_undo.size() > 1)
+        m_memoryUsage -= m_undo.takeFirst().cost;
+    while (m_memoryUsage > m_memoryLimit && m_redo.size() > 1)
+        m_memoryUsage -= m_redo.takeFirst().cost;
+}
@@ -0,0 +1,291 @@
+/**
+ * @file UndoHistory.h
+ * @brief Undo and redo stacks of inverse edits
+ *
+ * This file defines the UndoOp structure which describes how to revert
+ * one edit of the todo list, and the UndoHistory class which keeps
+ * those records within a memory budget.
+ */
+
+#ifndef UNDOHISTORY_H
+#define UNDOHISTORY_H
+
+#include <QList>
+#include <QVector>
+#include <QString>
+#include <QUuid>
+#include "TodoItem.h"
+
+/**
+ * @struct UndoOp
+ * @brief The edit that reverts one change of the todo list
+ *
+ * Only what the change overwrote is kept: ids of added items, the old
+ * value of an edited field, or the items that were removed.
+ *
+ * - Remove:       remove the items in ids again
+ * - Restore:      put the removed items back
+ * - SetCompleted: give the items in ids the completion status in value
+ * - SetTitle:     give the item in ids the title in text
+ * - SetPriority:  give the item in ids the priority in value
+ * - SetCategory:  give the item in ids the category in text
+ */
+struct UndoOp
+{
+    /**
+     * @enum Type
+     * @brief Kind of inverse edit
+     */
+    enum class Type {
+        Remove,
+        Restore,
+        SetCompleted,
+        SetTitle,
+        SetPriority,
+        SetCategory
+    };
+
+    Type type = Type::Remove;   ///< Kind of inverse edit
+    QVector<QUuid> ids;         ///< Affected items (not used by Restore)
+    QVector<TodoItem> items;    ///< Removed items (Restore only)
+    QVector<int> oldSlots;      ///< Slots the items were removed from, may be empty (Restore only)
+    QString text;               ///< Old title or category
+    int value = 0;              ///< Old completion status or priority
+
+    static UndoOp remove(const QVector<QUuid>& ids)
+    {
+        UndoOp op;
+        op.type = Type::Remove;
+        op.ids = ids;
+        return op;
+    }
+
+    static UndoOp restore(const QVector<TodoItem>& items, const QVector<int>& oldSlots = {})
+    {
+        UndoOp op;
+        op.type = Type::Restore;
+        op.items = items;
+        op.oldSlots = oldSlots;
+        return op;
+    }
+
+    static UndoOp setCompleted(const QVector<QUuid>& ids, bool completed)
+    {
+        UndoOp op;
+        op.type = Type::SetCompleted;
+        op.ids = ids;
+        op.value = completed;
+        return op;
+    }
+
+    static UndoOp setTitle(const QUuid& id, const QString& title)
+    {
+        UndoOp op;
+        op.type = Type::SetTitle;
+        op.ids = {id};
+        op.text = title;
+        return op;
+    }
+
+    static UndoOp setPriority(const QUuid& id, TodoItem::Priority priority)
+    {
+        UndoOp op;
+        op.type = Type::SetPriority;
+        op.ids = {id};
+        op.value = static_cast<int>(priority);
+        return op;
+    }
+
+    static UndoOp setCategory(const QUuid& id, const QString& category)
+    {
+        UndoOp op;
+        op.type = Type::SetCategory;
+        op.ids = {id};
+        op.text = category;
+        return op;
+    }
+
+    /**
+     * @brief Estimate the memory the record holds
+     * @return Approximate size in bytes
+     */
+    qsizetype cost() const;
+};
+
+/**
+ * @class UndoHistory
+ * @brief Undo and redo stacks with a memory limit
+ *
+ * Each entry is one user action: a label and the inverse edits that
+ * revert it, applied last to first. Undoing an entry yields the edits
+ * that revert the undo, which become the redo entry, and the other way
+ * round; only one direction is stored at any time.
+ *
+ * Edits recorded between beginGroup() and endGroup() form one entry, so
+ * a batch such as an import is undone in one step.
+ *
+ * When the entries together exceed memoryLimit() the oldest ones are
+ * dropped. The newest entry of each stack is kept even if it alone is
+ * over the limit, so the last action can always be undone.
+ */
+class UndoHistory
+{
+public:
+    /// Memory limit of a new history, in bytes
+    static constexpr qsizetype kDefaultMemoryLimit = 32 * 1024 * 1024;
+
+    /**
+     * @struct Entry
+     * @brief One undoable action
+     */
+    struct Entry {
+        QString text;           ///< Label for menus, e.g. "Remove"
+        QVector<UndoOp> ops;    ///< Inverse edits in the order they were recorded
+        qsizetype cost = 0;     ///< Sum of the ops' cost()
+    };
+
+    /**
+     * @brief Record the inverse of a new edit
+     *
+     * Starts a new entry unless a group is open, and drops the redo
+     * stack since it no longer applies.
+     *
+     * @param text Label of the action, ignored inside a group
+     * @param op Edit that reverts the change
+     */
+    void record(const QString& text, UndoOp&& op);
+
+    /**
+     * @brief Collect the following edits into one entry
+     *
+     * Groups nest; only the outermost one's label is used.
+     *
+     * @param text Label of the action
+     */
+    void beginGroup(const QString& text);
+
+    /**
+     * @brief Close the group opened by beginGroup()
+     */
+    void endGroup();
+
+    /**
+     * @brief Check whether a group is open
+     * @return true between beginGroup() and the matching endGroup()
+     */
+    bool isGrouping() const { return m_groupDepth > 0; }
+
+    /**
+     * @brief Check whether there is an action to undo
+     * @return true if the undo stack is not empty
+     */
+    bool canUndo() const { return !m_undo.isEmpty(); }
+
+    /**
+     * @brief Check whether there is an action to redo
+     * @return true if the redo stack is not empty
+     */
+    bool canRedo() const { return !m_redo.isEmpty(); }
+
+    /**
+     * @brief Get the label of the action undo() would revert
+     * @return Label, empty if there is none
+     */
+    QString undoText() const { return canUndo() ? m_undo.last().text : QString(); }
+
+    /**
+     * @brief Get the label of the action redo() would repeat
+     * @return Label, empty if there is none
+     */
+    QString redoText() const { return canRedo() ? m_redo.last().text : QString(); }
+
+    /**
+     * @brief Take the newest entry off the undo stack
+     * @return Entry; must only be called if canUndo()
+     */
+    Entry takeUndo();
+
+    /**
+     * @brief Take the newest entry off the redo stack
+     * @return Entry; must only be called if canRedo()
+     */
+    Entry takeRedo();
+
+    /**
+     * @brief Put an entry on the undo stack, keeping the redo stack
+     * @param text Label of the action
+     * @param ops Inverse edits; nothing is pushed if empty
+     */
+    void pushUndo(const QString& text, QVector<UndoOp>&& ops);
+
+    /**
+     * @brief Put an entry on the redo stack
+     * @param text Label of the action
+     * @param ops Inverse edits; nothing is pushed if empty
+     */
+    void pushRedo(const QString& text, QVector<UndoOp>&& ops);
+
+    /**
+     * @brief Drop every entry and any open group
+     */
+    void clear();
+
+    /**
+     * @brief Set the memory the history may use
+     * @param bytes Limit in bytes; older entries are dropped at once if over it
+     */
+    void setMemoryLimit(qsizetype bytes);
+
+    /**
+     * @brief Get the memory the history may use
+     * @return Limit in bytes
+     */
+    qsizetype memoryLimit() const { return m_memoryLimit; }
+
+    /**
+     * @brief Get the estimated memory held by both stacks
+     * @return Size in bytes
+     */
+    qsizetype memoryUsage() const { return m_memoryUsage; }
+
+    /**
+     * @brief Get the number of entries that can be undone
+     * @return Undo stack size
+     */
+    int undoCount() const { return static_cast<int>(m_undo.size()); }
+
+    /**
+     * @brief Get the number of entries that can be redone
+     * @return Redo stack size
+     */
+    int redoCount() const { return static_cast<int>(m_redo.size()); }
+
+private:
+    QList<Entry> m_undo;        ///< Oldest first
+    QList<Entry> m_redo;        ///< Furthest from the present first
+    Entry m_group;              ///< Entry being collected by an open group
+    int m_groupDepth = 0;       ///< Nesting level of beginGroup()
+    qsizetype m_memoryLimit = kDefaultMemoryLimit; ///< Budget in bytes
+    qsizetype m_memoryUsage = 0; ///< Sum of every entry's cost
+
+    /**
+     * @brief Put an entry on a stack and enforce the memory limit
+     * @param stack Stack to push to
+     * @param entry Entry with its cost filled in
+     */
+    void push(QList<Entry>& stack, Entry&& entry);
+
+    /**
+     * @brief Take the newest entry off a stack
+     * @param stack Non-empty stack
+     * @return Entry
+     */
+    Entry take(QList<Entry>& stack);
+
+    /**
+     * @brief Drop the oldest entries until the history fits its limit
+     */
+    void trim();
+};
+
+#endif // UNDOHISTORY_H
@@ -0,0 +1,535 @@
+/**
+ * @file bench_todomodel.cpp
+ * @brief Performance benchmarks for the Qt todo core using Google Benchmark
+ *
+ * Every benchmark runs for list sizes from 1k to 1M items. Record results
+ * as JSON to compare releases:
+ *
+ *     ./bench_todomodel --benchmark_out=bench.json --benchmark_out_format=json
+ *
+ * Storage goes to the QStandardPaths test locations, so the benchmarks
+ * never touch real user data.
+ */
+
+#include <benchmark/benchmark.h>
+#include <QCoreApplication>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QDirIterator>
+#include <QJsonObject>
+#include <algorithm>
+#include <memory>
+#include "../src/TodoModel.h"
+#include "../src/TodoItem.h"
+#include "../src/StorageManager.h"
+#include "../src/TodoSnapshot.h"
+#include "../src/TodoQuery.h"
+
+namespace {
+
+/// Operations timed per iteration by the single-item benchmarks
+constexpr int kBatchSize = 1000;
+
+/**
+ * @brief Register the 1k..1M size range on a benchmark
+ */
+void sizeRange(benchmark::internal::Benchmark* bench)
+{
+    bench->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+}
+
+/**
+ * @brief Register the size range for every storage backend
+ */
+void backendRange(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgsProduct({benchmark::CreateRange(1000, 1000000, 10), {0, 1, 2}})
+        ->ArgNames({"items", "backend"})
+        ->Unit(benchmark::kMillisecond);
+}
+
+/**
+ * @brief Build a list with a realistic mix of fields
+ *
+ * Every third item is completed; priorities and categories cycle.
+ */
+QVector<TodoItem> makeTodos(int count)
+{
+    static const QStringList categories = {"Work", "Home", "Errands", "Health",
+                                           "Finance", "Study", "Travel", ""};
+    QVector<TodoItem> todos;
+    todos.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        TodoItem item(QString("Todo item number %1").arg(i), i % 3 == 0,
+                      static_cast<TodoItem::Priority>(i % 4));
+        item.setCategory(categories[i % categories.size()]);
+        todos.append(item);
+    }
+    return todos;
+}
+
+/**
+ * @brief Register the size range for both QSettingsJson compressions
+ */
+void compressionRange(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgsProduct({benchmark::CreateRange(1000, 1000000, 10), {0, 1}})
+        ->ArgNames({"items", "zlib"})
+        ->Unit(benchmark::kMillisecond);
+}
+
+/**
+ * @brief Remove every file in the app data directory
+ *
+ * Run before a backend writes, so storageBytes() sees only its files and
+ * not those of other backends, the statistics or the lock directory.
+ * Test mode keeps the directory apart from the application's own.
+ */
+void clearAppData()
+{
+    QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).removeRecursively();
+}
+
+/**
+ * @brief Total size of the files in the app data directory
+ *
+ * The QSettings metadata file lives elsewhere and is not counted.
+ */
+qint64 storageBytes()
+{
+    qint64 bytes = 0;
+    QDirIterator it(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation),
+                    QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        bytes += it.fileInfo().size();
+    }
+    return bytes;
+}
+
+/**
+ * @brief Remove everything the model's storage backend has written
+ */
+void clearModelStorage()
+{
+    StorageManager(StorageManager::StorageBackend::Journal).clearStorage();
+}
+
+/**
+ * @brief Create a model holding the given number of items
+ *
+ * The save delay is long enough that no write lands inside a timed
+ * region; benchmarks flush explicitly while timing is paused.
+ */
+std::unique_ptr<TodoModel> makeModel(int count)
+{
+    clearModelStorage();
+    auto model = std::make_unique<TodoModel>();
+    model->setSaveDelay(60 * 60 * 1000);
+    model->addTodos(makeTodos(count));
+    model->saveToStorage();
+    return model;
+}
+
+} // namespace
+
+static void BM_AddTodo(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    auto model = makeModel(count);
+
+    for (auto _ : state) {
+        for (int i = 0; i < kBatchSize; ++i)
+            model->addTodo(QString("Added %1").arg(i));
+
+        state.PauseTiming();
+        model->saveToStorage();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+BENCHMARK(BM_AddTodo)->Apply(sizeRange);
+
+static void BM_ToggleTodo(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    auto model = makeModel(count);
+    const int stride = qMax(1, count / kBatchSize);
+
+    for (auto _ : state) {
+        for (int i = 0; i < kBatchSize; ++i)
+            model->toggleTodo((i * stride) % count);
+
+        state.PauseTiming();
+        model->saveToStorage();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+BENCHMARK(BM_ToggleTodo)->Apply(sizeRange);
+
+static void BM_ToggleTodoSorted(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    auto model = makeModel(count);
+    model->setSortColumns({{TodoSorter::Key::Completed, Qt::AscendingOrder},
+                           {TodoSorter::Key::Title, Qt::AscendingOrder}});
+    const int stride = qMax(1, count / kBatchSize);
+
+    // Every toggle moves its row to the other half of the list
+    for (auto _ : state) {
+        for (int i = 0; i < kBatchSize; ++i)
+            model->toggleTodo((i * stride) % count);
+
+        state.PauseTiming();
+        model->saveToStorage();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+BENCHMARK(BM_ToggleTodoSorted)->Apply(sizeRange);
+
+static void BM_SetFilterMode(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    auto model = makeModel(count);
+    const TodoModel::FilterMode modes[] = {TodoModel::FilterMode::Active,
+                                           TodoModel::FilterMode::Completed,
+                                           TodoModel::FilterMode::All};
+    int next = 0;
+
+    for (auto _ : state) {
+        model->setFilterMode(modes[next]);
+        next = (next + 1) % 3;
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_SetFilterMode)->Apply(sizeRange);
+
+static void BM_SetQuery(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    auto model = makeModel(count);
+    using Priority = TodoItem::Priority;
+    const TodoQuery queries[] = {
+        !TodoQuery::completed() && TodoQuery::priorityBetween(Priority::High, Priority::Urgent)
+            && (TodoQuery::category("Work") || TodoQuery::category("Home")),
+        TodoQuery::completed() || (!TodoQuery::category("Errands")
+            && TodoQuery::createdBetween(QDateTime::currentDateTimeUtc().addDays(-1), QDateTime()))};
+    int next = 0;
+
+    for (auto _ : state) {
+        model->setQuery(queries[next]);
+        next = (next + 1) % 2;
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_SetQuery)->Apply(sizeRange);
+
+static void BM_SwitchCategory(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    auto model = makeModel(count);
+    const QString categories[] = {QStringLiteral("Work"), QStringLiteral("Home")};
+    int next = 0;
+
+    model->setCategoryFilter(categories[1]);
+
+    for (auto _ : state) {
+        model->setCategoryFilter(categories[next]);
+        next = (next + 1) % 2;
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_SwitchCategory)->Apply(sizeRange);
+
+static void BM_UndoRemove(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    auto model = makeModel(count);
+    QVector<QUuid> ids;
+    for (int row = 0; row < count; row += count / 100)
+        ids.append(model->getTodoItem(row).getUuid());
+
+    // Undo revives the tombstones, so every round starts from the same list
+    for (auto _ : state) {
+        model->removeTodos(ids);
+        model->undo();
+    }
+    state.SetItemsProcessed(state.iterations() * ids.size());
+}
+BENCHMARK(BM_UndoRemove)->Apply(sizeRange);
+
+static void BM_StatisticsDashboard(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    auto model = makeModel(count);
+    const QDate today = QDate::currentDate();
+
+    // What the dashboard reads on every change; none of it visits items
+    for (auto _ : state) {
+        const TodoStatistics& statistics = model->statistics();
+        benchmark::DoNotOptimize(statistics.days(today.addDays(-29), 30));
+        benchmark::DoNotOptimize(statistics.weeks(today.addDays(-77), 12));
+        benchmark::DoNotOptimize(statistics.completionRate(today, 7));
+        benchmark::DoNotOptimize(statistics.priorityCounts(TodoItem::Priority::High));
+        benchmark::DoNotOptimize(model->categorySummaries());
+    }
+}
+BENCHMARK(BM_StatisticsDashboard)->Apply(sizeRange);
+
+static void BM_SyncExternalEdits(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    auto writer = makeModel(count);
+    TodoModel reader;
+    reader.loadFromStorage();
+    const int stride = qMax(1, count / kBatchSize);
+
+    // Another instance saves a batch of edits; the timed merge reads and
+    // applies only those
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (int i = 0; i < kBatchSize; ++i)
+            writer->toggleTodo((i * stride) % count);
+        writer->saveToStorage();
+        state.ResumeTiming();
+
+        reader.syncWithStorage();
+    }
+    state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+BENCHMARK(BM_SyncExternalEdits)->Apply(sizeRange);
+
+static void BM_SetSearchText(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    auto model = makeModel(count);
+    const QString queries[] = {QStringLiteral("number 4217"), QStringLiteral("number 42178"),
+                               QStringLiteral("er 4217")};
+    int next = 0;
+
+    // The first query builds the index
+    model->setSearchText(queries[2]);
+
+    for (auto _ : state) {
+        model->setSearchText(queries[next]);
+        next = (next + 1) % 3;
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_SetSearchText)->Apply(sizeRange)->Unit(benchmark::kMicrosecond);
+
+static void BM_ClearCompleted(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    auto model = makeModel(count);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(model->clearCompleted());
+
+        // Put the same number of completed items back for the next round
+        state.PauseTiming();
+        QVector<TodoItem> refill = makeTodos(count);
+        refill.erase(std::remove_if(refill.begin(), refill.end(),
+                                    [](const TodoItem& item) { return !item.isCompleted(); }),
+                     refill.end());
+        model->addTodos(std::move(refill));
+        model->saveToStorage();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ClearCompleted)->Apply(sizeRange);
+
+static void BM_RemoveTodoById(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    auto model = makeModel(count);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        const int stride = qMax(1, model->totalCount() / kBatchSize);
+        QVector<TodoItem> removed;
+        for (int i = 0; i < kBatchSize; ++i)
+            removed.append(model->getTodoItem((i * stride) % model->rowCount()));
+        state.ResumeTiming();
+
+        for (const TodoItem& item : std::as_const(removed))
+            model->removeTodoById(item.getUuid());
+
+        state.PauseTiming();
+        model->addTodos(std::move(removed));
+        model->saveToStorage();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+BENCHMARK(BM_RemoveTodoById)->Apply(sizeRange);
+
+static void BM_StorageSave(benchmark::State& state)
+{
+    const QVector<TodoItem> todos = makeTodos(static_cast<int>(state.range(0)));
+    clearAppData();
+    StorageManager storage(static_cast<StorageManager::StorageBackend>(state.range(1)));
+
+    for (auto _ : state) {
+        if (!storage.saveTodos(todos))
+            state.SkipWithError("saveTodos failed");
+    }
+    state.counters["bytes"] = static_cast<double>(storageBytes());
+    storage.clearStorage();
+    state.SetItemsProcessed(state.iterations() * todos.size());
+}
+BENCHMARK(BM_StorageSave)->Apply(backendRange);
+
+static void BM_QSettingsSave(benchmark::State& state)
+{
+    const QVector<TodoItem> todos = makeTodos(static_cast<int>(state.range(0)));
+    clearAppData();
+    StorageManager storage(StorageManager::StorageBackend::QSettingsJson);
+    storage.setCompression(state.range(1) ? StorageManager::Compression::Zlib
+                                          : StorageManager::Compression::None);
+
+    for (auto _ : state) {
+        if (!storage.saveTodos(todos))
+            state.SkipWithError("saveTodos failed");
+    }
+    state.counters["bytes"] = static_cast<double>(storageBytes());
+    storage.clearStorage();
+    state.SetItemsProcessed(state.iterations() * todos.size());
+}
+BENCHMARK(BM_QSettingsSave)->Apply(compressionRange);
+
+static void BM_QSettingsLoad(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    StorageManager storage(StorageManager::StorageBackend::QSettingsJson);
+    storage.setCompression(state.range(1) ? StorageManager::Compression::Zlib
+                                          : StorageManager::Compression::None);
+    storage.saveTodos(makeTodos(count));
+
+    for (auto _ : state) {
+        QVector<TodoItem> todos = storage.loadTodos();
+        if (todos.size() != count)
+            state.SkipWithError("loadTodos returned the wrong number of items");
+        benchmark::DoNotOptimize(todos.data());
+    }
+    storage.clearStorage();
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_QSettingsLoad)->Apply(compressionRange);
+
+static void BM_StorageLoad(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    StorageManager storage(static_cast<StorageManager::StorageBackend>(state.range(1)));
+    storage.saveTodos(makeTodos(count));
+
+    for (auto _ : state) {
+        QVector<TodoItem> todos = storage.loadTodos();
+        if (todos.size() != count)
+            state.SkipWithError("loadTodos returned the wrong number of items");
+        benchmark::DoNotOptimize(todos.data());
+    }
+    storage.clearStorage();
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_StorageLoad)->Apply(backendRange);
+
+static void BM_SnapshotRead(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    QTemporaryDir dir;
+    const QString path = dir.filePath("todos.snapshot");
+    TodoSnapshot::write(path, makeTodos(count));
+
+    for (auto _ : state) {
+        TodoStore store;
+        if (!TodoSnapshot::read(path, store) || store.size() != count)
+            state.SkipWithError("TodoSnapshot::read failed");
+        benchmark::DoNotOptimize(store);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_SnapshotRead)->Apply(sizeRange);
+
+static void BM_TodoItemToJson(benchmark::State& state)
+{
+    const QVector<TodoItem> todos = makeTodos(static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        for (const TodoItem& item : todos) {
+            QJsonObject json = item.toJson();
+            benchmark::DoNotOptimize(json);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * todos.size());
+}
+BENCHMARK(BM_TodoItemToJson)->Apply(sizeRange);
+
+static void BM_TodoItemFromJson(benchmark::State& state)
+{
+    QVector<QJsonObject> objects;
+    for (const TodoItem& item : makeTodos(static_cast<int>(state.range(0))))
+        objects.append(item.toJson());
+
+    for (auto _ : state) {
+        for (const QJsonObject& json : std::as_const(objects)) {
+            TodoItem item = TodoItem::fromJson(json);
+            benchmark::DoNotOptimize(item);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * objects.size());
+}
+BENCHMARK(BM_TodoItemFromJson)->Apply(sizeRange);
+
+static void BM_ExportToJson(benchmark::State& state)
+{
+    const QVector<TodoItem> todos = makeTodos(static_cast<int>(state.range(0)));
+    QTemporaryDir dir;
+    const QString path = dir.filePath("export.json");
+
+    for (auto _ : state) {
+        if (!StorageManager::exportToJson(path, todos))
+            state.SkipWithError("exportToJson failed");
+    }
+    state.SetItemsProcessed(state.iterations() * todos.size());
+}
+BENCHMARK(BM_ExportToJson)->Apply(sizeRange);
+
+static void BM_ImportFromJson(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    QTemporaryDir dir;
+    const QString path = dir.filePath("import.json");
+    StorageManager::exportToJson(path, makeTodos(count));
+
+    for (auto _ : state) {
+        QVector<TodoItem> todos = StorageManager::importFromJson(path);
+        if (todos.size() != count)
+            state.SkipWithError("importFromJson returned the wrong number of items");
+        benchmark::DoNotOptimize(todos.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ImportFromJson)->Apply(sizeRange);
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setOrganizationName("TodoListDemo");
+    QCoreApplication::setApplicationName("QtTodoListBench");
+    QStandardPaths::setTestModeEnabled(true);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    clearModelStorage();
+    return 0;
+}
@@ -4,8 +4,18 @@
  */
 
 #include <QtTest>
+#include <QSqlDatabase>
 #include "../src/TodoModel.h"
 #include "../src/TodoItem.h"
+#include "../src/TodoStore.h"
+#include "../src/TrigramIndex.h"
+#include "../src/TodoSorter.h"
+#include "../src/TodoQuery.h"
+#include "../src/TodoSnapshot.h"
+#include "../src/TodoImporter.h"
+#include "../src/TodoExporter.h"
+#include "../src/TodoStatistics.h"
+#include "../src/StorageManager.h"
 
 /**
  * @class TestTodoModel
@@ -29,6 +39,11 @@ private slots:
     void testTodoItemCreation();
     void testTodoItemToggle();
     void testTodoItemSerialization();
+    void testTimestampCodec();
+
+    // TodoStore tests
+    void testTodoStoreColumns();
+    void testBinarySnapshot();
 
     // TodoModel tests
     void testModelInitialization();
@@ -42,6 +57,26 @@ private slots:
     void testFilterCompleted();
     void testCounts();
     void testSignals();
+    void testBatchOperations();
+    void testByIdOperations();
+    void testIncrementalFilter();
+    void testSearch();
+    void testSorting();
+    void testQuery();
+    void testCategoryIndex();
+    void testUndoRedo();
+    void testStatistics();
+
+    // Persistence tests
+    void testJournalPersistence();
+    void testSQLiteIncrementalSave();
+    void testQSettingsDataFile();
+    void testCoalescedSave();
+    void testAsyncLoad();
+    void testShardedStorage();
+    void testStreamingImport();
+    void testParallelExport();
+    void testLiveSync();
 
 private:
     TodoModel *model;
@@ -53,6 +88,9 @@ private:
 void TestTodoModel::initTestCase()
 {
     qDebug() << "Starting TodoModel tests";
+
+    // Keep test data out of the user's real storage
+    QStandardPaths::setTestModeEnabled(true);
 }
 
 /**
@@ -68,6 +106,7 @@ void TestTodoModel::cleanupTestCase()
  */
 void TestTodoModel::init()
 {
+    StorageManager(StorageManager::StorageBackend::Journal).clearStorage();
     model = new TodoModel();
 }
 
@@ -122,10 +161,154 @@ void TestTodoModel::testTodoItemSerialization()
     QJsonObject json = original.toJson();
     TodoItem deserialized = TodoItem::fromJson(json);
 
+    QCOMPARE(deserialized.getUuid(), original.getUuid());
     QCOMPARE(deserialized.getTitle(), original.getTitle());
     QCOMPARE(deserialized.isCompleted(), original.isCompleted());
     QCOMPARE(deserialized.getPriority(), original.getPriority());
     QCOMPARE(deserialized.getCategory(), original.getCategory());
+    QCOMPARE(deserialized.createdAtMs(), original.createdAtMs());
+    QCOMPARE(deserialized.modifiedAtMs(), original.modifiedAtMs());
+}
+
+/**
+ * @brief Test the ISO-8601 codec against QDateTime
+ */
+void TestTodoModel::testTimestampCodec()
+{
+    const QVector<qint64> samples = {0, -1, 951782400000, 1709210096789, -2208988800001, 253402300799999};
+    for (qint64 msecs : samples) {
+        const QString iso = Timestamp::toIso(msecs);
+        QCOMPARE(iso, QDateTime::fromMSecsSinceEpoch(msecs).toUTC().toString(Qt::ISODateWithMs));
+        QCOMPARE(Timestamp::fromIso(iso), msecs);
+    }
+
+    // Offsets, fractions and local times without an offset
+    for (const QString& text : {QString("2024-02-29T12:34:56.789+02:00"), QString("2024-02-29T12:34:56-0530"),
+                                QString("2024-02-29T12:34:56.1Z"), QString("2024-01-01T10:00:00")}) {
+        QCOMPARE(Timestamp::fromIso(text), QDateTime::fromString(text, Qt::ISODate).toMSecsSinceEpoch());
+    }
+
+    // Digits of other scripts are left to QDateTime
+    const QString wide = QString("2024-02-29T12:34:56.") + QChar(0xFF11) + QChar(0xFF12) + QChar(0xFF13) + u'Z';
+    QCOMPARE(Timestamp::fromIso(wide), Timestamp::fromDateTime(QDateTime::fromString(wide, Qt::ISODate)));
+
+    QCOMPARE(Timestamp::fromIso(QString("2023-02-29T00:00:00Z")), Timestamp::kInvalid);
+    QCOMPARE(Timestamp::fromIso(QString("not a date")), Timestamp::kInvalid);
+    QVERIFY(Timestamp::toIso(Timestamp::kInvalid).isEmpty());
+    QVERIFY(!Timestamp::toDateTime(Timestamp::kInvalid).isValid());
+}
+
+/**
+ * @brief Test that items survive the round trip through the columns
+ */
+void TestTodoModel::testTodoStoreColumns()
+{
+    TodoItem first("First", true, TodoItem::Priority::Urgent);
+    first.setCategory("Work");
+    TodoItem second("Second");
+    TodoItem third("Third", true, TodoItem::Priority::Low);
+    third.setCategory("Work");
+
+    TodoStore store(QVector<TodoItem>{first, second, third});
+    QCOMPARE(store.size(), 3);
+    QCOMPARE(store.countCompleted(), 2);
+
+    const TodoItem restored = store.item(0);
+    QCOMPARE(restored.getUuid(), first.getUuid());
+    QCOMPARE(restored.getTitle(), first.getTitle());
+    QCOMPARE(restored.getPriority(), TodoItem::Priority::Urgent);
+    QCOMPARE(restored.getCategory(), QString("Work"));
+    QCOMPARE(restored.getCreatedAt(), first.getCreatedAt());
+
+    QVERIFY(store.setPriority(1, TodoItem::Priority::High));
+    QVERIFY(!store.setPriority(1, TodoItem::Priority::High));
+    QVERIFY(store.setCategory(1, "Work"));
+    QCOMPARE(store.category(1), store.category(2));
+
+    store.remove(0);
+    QCOMPARE(store.liveCount(), 2);
+    QCOMPARE(store.countCompleted(), 1);
+    QCOMPARE(store.toItems().first().getTitle(), QString("Second"));
+
+    QCOMPARE(store.compact(), 0);
+    QCOMPARE(store.size(), 2);
+    QCOMPARE(store.id(1), third.getUuid());
+    QCOMPARE(store.isCompleted(1), true);
+    QCOMPARE(store.priority(0), TodoItem::Priority::High);
+}
+
+/**
+ * @brief Test the binary snapshot round trip and its validation
+ */
+void TestTodoModel::testBinarySnapshot()
+{
+    TodoItem first("First", true, TodoItem::Priority::Urgent);
+    first.setCategory("Work");
+    TodoItem second(QString::fromUtf8("Zweite Aufgabe \xc3\xbc"));
+    TodoItem third("Third", false, TodoItem::Priority::High);
+    third.setCategory("Work");
+
+    QTemporaryDir dir;
+    const QString path = dir.filePath("todos.snapshot");
+    QVERIFY(TodoSnapshot::write(path, {first, second, third}));
+
+    TodoStore store;
+    QVERIFY(TodoSnapshot::read(path, store));
+    QCOMPARE(store.size(), 3);
+    QCOMPARE(store.countCompleted(), 1);
+    QCOMPARE(store.id(1), second.getUuid());
+    QCOMPARE(store.title(1), second.getTitle());
+    QCOMPARE(store.category(2), QString("Work"));
+    QCOMPARE(store.priority(2), TodoItem::Priority::High);
+    QCOMPARE(store.createdAt(0), first.getCreatedAt());
+
+    // Encoded titles survive compaction and materialization
+    store.remove(1);
+    store.compact();
+    QCOMPARE(store.item(1).getTitle(), QString("Third"));
+    QVERIFY(store.setTitle(0, "Renamed"));
+    QCOMPARE(store.toItems().first().getTitle(), QString("Renamed"));
+
+    // A later version with wider records is read by skipping the new fields
+    QFile written(path);
+    QVERIFY(written.open(QIODevice::ReadOnly));
+    const QByteArray current = written.readAll();
+    written.close();
+    const uchar* header = reinterpret_cast<const uchar*>(current.constData());
+    const quint32 recordSize = qFromLittleEndian<quint32>(header + 12);
+    const quint32 itemCount = qFromLittleEndian<quint32>(header + 16);
+    const quint32 categoryCount = qFromLittleEndian<quint32>(header + 20);
+    const int recordsStart = 32 + int(categoryCount) * 8;
+    QByteArray newer = current.left(recordsStart);
+    for (quint32 i = 0; i < itemCount; ++i) {
+        newer.append(current.mid(recordsStart + int(i * recordSize), int(recordSize)));
+        newer.append(8, '\x7f');
+    }
+    newer.append(current.mid(recordsStart + int(itemCount * recordSize)));
+    qToLittleEndian<quint32>(TodoSnapshot::kVersion + 1, newer.data() + 8);
+    qToLittleEndian<quint32>(recordSize + 8, newer.data() + 12);
+
+    const QString newerPath = dir.filePath("newer.snapshot");
+    QFile newerFile(newerPath);
+    QVERIFY(newerFile.open(QIODevice::WriteOnly));
+    QCOMPARE(newerFile.write(newer), qint64(newer.size()));
+    newerFile.close();
+
+    TodoStore newerStore;
+    QVERIFY(TodoSnapshot::read(newerPath, newerStore));
+    QCOMPARE(newerStore.size(), 3);
+    QCOMPARE(newerStore.title(1), second.getTitle());
+    QCOMPARE(newerStore.category(2), QString("Work"));
+    QCOMPARE(newerStore.priority(2), TodoItem::Priority::High);
+    QCOMPARE(newerStore.modifiedAtMs(0), first.modifiedAtMs());
+
+    // A truncated file is rejected and leaves the store untouched
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() - 1));
+    file.close();
+    QVERIFY(!TodoSnapshot::read(path, store));
+    QCOMPARE(store.size(), 2);
 }
 
 /**
@@ -213,6 +396,13 @@ void TestTodoModel::testUpdateTodo()
     TodoItem item = model->getTodoItem(index);
     QCOMPARE(item.getTitle(), QString("Updated Title"));
 
+    // Setting the current value changes nothing and saves nothing
+    QSignalSpy changedSpy(model, &QAbstractItemModel::dataChanged);
+    QVERIFY(!model->updateTodoTitle(index, "Updated Title"));
+    QVERIFY(!model->updateTodoPriority(index, item.getPriority()));
+    QVERIFY(!model->setData(index, false, TodoModel::CompletedRole));
+    QCOMPARE(changedSpy.count(), 0);
+
     // Test empty update
     QVERIFY(!model->updateTodoTitle(index, ""));
     QVERIFY(!model->updateTodoTitle(index, "   "));
@@ -305,6 +495,20 @@ void TestTodoModel::testCounts()
     QCOMPARE(model->totalCount(), 3);
     QCOMPARE(model->activeCount(), 1);
     QCOMPARE(model->completedCount(), 2);
+
+    // Cached counters follow removals, additions and reloads
+    model->removeTodo(0);
+    QVERIFY(model->addTodo(TodoItem("Todo 4", true, TodoItem::Priority::Normal)));
+    QCOMPARE(model->activeCount(), 1);
+    QCOMPARE(model->completedCount(), 2);
+
+    QVERIFY(model->loadFromStorage());
+    QCOMPARE(model->activeCount(), 1);
+    QCOMPARE(model->completedCount(), 2);
+
+    model->clearAll();
+    QCOMPARE(model->activeCount(), 0);
+    QCOMPARE(model->completedCount(), 0);
 }
 
 /**
@@ -328,6 +532,969 @@ void TestTodoModel::testSignals()
     QVERIFY(countsChangedSpy.count() >= 2);
 }
 
+/**
+ * @brief Test batch add/remove/complete with single notifications
+ */
+void TestTodoModel::testBatchOperations()
+{
+    QSignalSpy insertedSpy(model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removedSpy(model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy countsChangedSpy(model, &TodoModel::countsChanged);
+
+    QVector<TodoItem> items;
+    QVector<QUuid> ids;
+    for (int i = 0; i < 10; ++i) {
+        items.append(TodoItem(QString("Todo %1").arg(i)));
+        ids.append(items.last().getUuid());
+    }
+
+    QCOMPARE(model->addTodos(std::move(items)), 10);
+    QCOMPARE(model->rowCount(), 10);
+    QCOMPARE(insertedSpy.count(), 1);
+    QCOMPARE(countsChangedSpy.count(), 1);
+
+    // Complete rows 2..5; under the Active filter they leave as one range
+    model->setFilterMode(TodoModel::FilterMode::Active);
+    QCOMPARE(model->setCompleted(ids.mid(2, 4), true), 4);
+    QCOMPARE(model->rowCount(), 6);
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(model->completedCount(), 4);
+
+    // Hidden items can be un-completed and come back as one range
+    QCOMPARE(model->setCompleted(ids.mid(2, 2), false), 2);
+    QCOMPARE(model->rowCount(), 8);
+    QCOMPARE(insertedSpy.count(), 2);
+    QCOMPARE(model->getTodoItem(2).getTitle(), QString("Todo 2"));
+
+    QCOMPARE(model->removeTodos(ids.mid(0, 3)), 3);
+    QCOMPARE(model->totalCount(), 7);
+    QCOMPARE(removedSpy.count(), 2);
+    QCOMPARE(model->getTodoItem(0).getTitle(), QString("Todo 3"));
+}
+
+/**
+ * @brief Test by-ID operations on items hidden by the filter
+ */
+void TestTodoModel::testByIdOperations()
+{
+    model->addTodo("Todo 1");
+    model->addTodo("Todo 2");
+    model->addTodo("Todo 3");
+    const QUuid firstId = model->getTodoItem(0).getUuid();
+    const QUuid thirdId = model->getTodoItem(2).getUuid();
+
+    model->setFilterMode(TodoModel::FilterMode::Completed);
+    QCOMPARE(model->rowCount(), 0);
+    QVERIFY(!model->modelIndexForId(firstId).isValid());
+
+    QVERIFY(model->updateTodoTitleById(thirdId, "Renamed"));
+    QVERIFY(model->updateTodoPriorityById(thirdId, TodoItem::Priority::Urgent));
+    QCOMPARE(model->getTodoItemById(thirdId).getTitle(), QString("Renamed"));
+    QCOMPARE(model->getTodoItemById(thirdId).getPriority(), TodoItem::Priority::Urgent);
+
+    QVERIFY(model->toggleTodoById(thirdId));
+    QCOMPARE(model->rowCount(), 1);
+    QCOMPARE(model->modelIndexForId(thirdId).row(), 0);
+
+    QVERIFY(model->removeTodoById(firstId));
+    QVERIFY(!model->containsTodo(firstId));
+    QVERIFY(!model->removeTodoById(firstId));
+    QCOMPARE(model->totalCount(), 2);
+    QCOMPARE(model->modelIndexForId(thirdId).row(), 0);
+    QCOMPARE(model->getTodoItemById(thirdId).isCompleted(), true);
+
+    // Re-adding an existing item keeps ids unique
+    QVERIFY(model->addTodo(model->getTodoItemById(thirdId)));
+    QCOMPARE(model->totalCount(), 3);
+    QVERIFY(model->getTodoItem(1).getUuid() != thirdId);
+}
+
+/**
+ * @brief Test that filter switches and removals notify views in row ranges
+ */
+void TestTodoModel::testIncrementalFilter()
+{
+    QVector<TodoItem> items;
+    QVector<QUuid> ids;
+    for (int i = 0; i < 6; ++i) {
+        items.append(TodoItem(QString("Todo %1").arg(i), i == 1 || i == 3 || i == 4,
+                              TodoItem::Priority::Normal));
+        ids.append(items.last().getUuid());
+    }
+    model->addTodos(std::move(items));
+
+    QSignalSpy resetSpy(model, &QAbstractItemModel::modelReset);
+    QSignalSpy insertedSpy(model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removedSpy(model, &QAbstractItemModel::rowsRemoved);
+
+    // Completed items sit at rows 1 and 3-4
+    model->setFilterMode(TodoModel::FilterMode::Active);
+    QCOMPARE(model->rowCount(), 3);
+    QCOMPARE(removedSpy.count(), 2);
+    QCOMPARE(model->getTodoItem(1).getTitle(), QString("Todo 2"));
+
+    model->setFilterMode(TodoModel::FilterMode::Completed);
+    QCOMPARE(model->rowCount(), 3);
+    QCOMPARE(removedSpy.count(), 3);
+    QCOMPARE(insertedSpy.count(), 1);
+    QCOMPARE(model->getTodoItem(2).getTitle(), QString("Todo 4"));
+
+    QCOMPARE(model->removeTodos({ids[1], ids[4]}), 2);
+    QCOMPARE(removedSpy.count(), 5);
+    QCOMPARE(model->totalCount(), 4);
+    QCOMPARE(model->getTodoItem(0).getTitle(), QString("Todo 3"));
+    QCOMPARE(model->modelIndexForId(ids[3]).row(), 0);
+
+    model->setFilterMode(TodoModel::FilterMode::All);
+    QCOMPARE(model->rowCount(), 4);
+    QCOMPARE(insertedSpy.count(), 3);
+    QCOMPARE(model->getTodoItem(0).getTitle(), QString("Todo 0"));
+    QCOMPARE(model->getTodoItem(3).getTitle(), QString("Todo 5"));
+    QCOMPARE(model->modelIndexForId(ids[5]).row(), 3);
+    QCOMPARE(resetSpy.count(), 0);
+}
+
+/**
+ * @brief Test substring search through the trigram index
+ */
+void TestTodoModel::testSearch()
+{
+    TrigramIndex index;
+    index.insert(0, "Milk\nShop");
+    index.insert(2, "Silk");
+    index.insert(1, "Milkshake");
+    QCOMPARE(index.candidates("ilk"), (QVector<int>{0, 1, 2}));
+    QCOMPARE(index.candidates("MILK"), (QVector<int>{0, 1}));
+    QVERIFY(index.candidates("silky").isEmpty());
+    index.remove(1, "Milkshake");
+    QCOMPARE(index.candidates("milk"), (QVector<int>{0}));
+
+    QVector<TodoItem> items = {TodoItem("Buy milk"), TodoItem("Call Mom", true),
+                               TodoItem("buy bread"), TodoItem("Book flights"),
+                               TodoItem("Milkshake recipe", true)};
+    items[3].setCategory("Travel");
+    model->addTodos(std::move(items));
+
+    QSignalSpy resetSpy(model, &QAbstractItemModel::modelReset);
+    QSignalSpy removedSpy(model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy searchSpy(model, &TodoModel::searchTextChanged);
+
+    model->setSearchText("BUY");
+    QCOMPARE(model->rowCount(), 2);
+    QCOMPARE(model->searchMatchCount(), 2);
+    QCOMPARE(model->getTodoItem(1).getTitle(), QString("buy bread"));
+
+    // Narrowing only removes the rows that stop matching
+    const int removedBefore = removedSpy.count();
+    model->setSearchText("buy m");
+    QCOMPARE(model->rowCount(), 1);
+    QCOMPARE(removedSpy.count(), removedBefore + 1);
+    QCOMPARE(model->getTodoItem(0).getTitle(), QString("Buy milk"));
+
+    model->setSearchText("milk");
+    QCOMPARE(model->rowCount(), 2);
+    model->setSearchText("trav");                   // matches the category
+    QCOMPARE(model->rowCount(), 1);
+    QCOMPARE(model->getTodoItem(0).getTitle(), QString("Book flights"));
+    model->setSearchText("mo");                     // too short for the index
+    QCOMPARE(model->rowCount(), 1);
+    QCOMPARE(model->getTodoItem(0).getTitle(), QString("Call Mom"));
+
+    // Edits keep the index current
+    model->setSearchText("milk");
+    QVERIFY(model->addTodo("Almond milk"));
+    QCOMPARE(model->rowCount(), 3);
+    const QUuid almondId = model->getTodoItem(2).getUuid();
+    QVERIFY(model->updateTodoTitleById(almondId, "Oat drink"));
+    QCOMPARE(model->rowCount(), 2);
+    QVERIFY(model->updateTodoTitleById(almondId, "Oat milk"));
+    QCOMPARE(model->rowCount(), 3);
+    QVERIFY(model->removeTodoById(almondId));
+    QCOMPARE(model->rowCount(), 2);
+    QCOMPARE(model->searchMatchCount(), 2);
+
+    // Search combines with the other filters
+    model->setFilterMode(TodoModel::FilterMode::Active);
+    QCOMPARE(model->rowCount(), 1);
+    model->setSearchText("  ");
+    QCOMPARE(model->searchText(), QString());
+    QCOMPARE(model->rowCount(), 3);
+    QCOMPARE(searchSpy.count(), 7);
+    QCOMPARE(resetSpy.count(), 0);
+}
+
+/**
+ * @brief Test that sorted rows stay in order as items are added and edited
+ */
+void TestTodoModel::testSorting()
+{
+    using Key = TodoSorter::Key;
+    model->addTodos({TodoItem("Banana", false, TodoItem::Priority::Low),
+                     TodoItem("Apple", false, TodoItem::Priority::High),
+                     TodoItem("Cherry"), TodoItem("Elderberry"), TodoItem("Date")});
+
+    QSignalSpy layoutSpy(model, &QAbstractItemModel::layoutChanged);
+    QSignalSpy movedSpy(model, &QAbstractItemModel::rowsMoved);
+    QSignalSpy insertedSpy(model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy resetSpy(model, &QAbstractItemModel::modelReset);
+
+    model->setSortColumns({{Key::Title, Qt::AscendingOrder}});
+    QCOMPARE(layoutSpy.count(), 1);
+    QCOMPARE(model->getTodoItem(0).getTitle(), QString("Apple"));
+    QCOMPARE(model->getTodoItem(4).getTitle(), QString("Elderberry"));
+
+    // New items go straight to their row, edited ones move there
+    QVERIFY(model->addTodo("Avocado"));
+    QCOMPARE(insertedSpy.count(), 1);
+    QCOMPARE(insertedSpy.first().at(1).toInt(), 1);
+
+    const QUuid cherryId = model->getTodoItem(3).getUuid();
+    QVERIFY(model->updateTodoTitleById(cherryId, "Aardvark"));
+    QCOMPARE(movedSpy.count(), 1);
+    QCOMPARE(model->getTodoItem(0).getUuid(), cherryId);
+
+    model->setSortColumns({{Key::Priority, Qt::DescendingOrder}, {Key::Title, Qt::AscendingOrder}});
+    QCOMPARE(model->getTodoItem(0).getTitle(), QString("Apple"));
+    QCOMPARE(model->getTodoItem(1).getTitle(), QString("Aardvark"));
+    QCOMPARE(model->getTodoItem(5).getTitle(), QString("Banana"));
+    QVERIFY(model->updateTodoPriorityById(model->getTodoItem(5).getUuid(), TodoItem::Priority::Urgent));
+    QCOMPARE(movedSpy.count(), 2);
+    QCOMPARE(model->getTodoItem(0).getTitle(), QString("Banana"));
+
+    // Persistent indexes follow their items through a re-sort
+    QPersistentModelIndex banana(model->index(0));
+    model->setSortColumns({{Key::Completed, Qt::AscendingOrder}, {Key::Title, Qt::AscendingOrder}});
+    QCOMPARE(banana.row(), 3);
+    QCOMPARE(banana.data(TodoModel::TitleRole).toString(), QString("Banana"));
+
+    QVERIFY(model->toggleTodo(0));
+    QCOMPARE(movedSpy.count(), 3);
+    QCOMPARE(model->getTodoItem(5).getTitle(), QString("Aardvark"));
+    QCOMPARE(banana.row(), 2);
+
+    model->setFilterMode(TodoModel::FilterMode::Active);
+    model->setSortColumns({});
+    QCOMPARE(model->rowCount(), 5);
+    QCOMPARE(model->getTodoItem(0).getTitle(), QString("Banana"));
+    QCOMPARE(model->getTodoItem(4).getTitle(), QString("Avocado"));
+
+    // A large batch is merged into the order at once
+    model->setSortColumns({{Key::Title, Qt::AscendingOrder}});
+    QVector<TodoItem> batch;
+    for (int i = 19; i >= 0; --i)
+        batch.append(TodoItem(QString("Item %1").arg(i, 2, 10, QChar('0'))));
+    QCOMPARE(model->addTodos(std::move(batch)), 20);
+    QCOMPARE(model->rowCount(), 25);
+    QCOMPARE(model->getTodoItem(4).getTitle(), QString("Elderberry"));
+    QCOMPARE(model->getTodoItem(5).getTitle(), QString("Item 00"));
+    QCOMPARE(model->getTodoItem(24).getTitle(), QString("Item 19"));
+
+    QCOMPARE(layoutSpy.count(), 5);
+    QCOMPARE(resetSpy.count(), 0);
+}
+
+/**
+ * @brief Test compound queries, their compilation and incremental upkeep
+ */
+void TestTodoModel::testQuery()
+{
+    using Priority = TodoItem::Priority;
+    const qint64 day = 24 * 60 * 60 * 1000;
+    const qint64 base = QDateTime(QDate(2024, 1, 1), QTime(0, 0), Qt::UTC).toMSecsSinceEpoch();
+    const QDateTime start = QDateTime::fromMSecsSinceEpoch(base, Qt::UTC);
+
+    QVector<TodoItem> items = {
+        TodoItem(QUuid::createUuid(), "Write report", false, Priority::Urgent, "Work", base, base),
+        TodoItem(QUuid::createUuid(), "Pay rent", true, Priority::High, "Finance", base + day, base + day),
+        TodoItem(QUuid::createUuid(), "Water plants", false, Priority::Low, "Home", base + 2 * day, base + 5 * day),
+        TodoItem(QUuid::createUuid(), "Review report", false, Priority::Normal, "Work", base + 3 * day, base + 3 * day),
+        TodoItem(QUuid::createUuid(), "File taxes", true, Priority::Urgent, "Finance", base + 4 * day, base + 4 * day)};
+    const QUuid writeId = items[0].getUuid();
+    const QUuid reviewId = items[3].getUuid();
+
+    // Column-wise evaluation agrees with testing one slot at a time
+    const TodoStore store(items);
+    const TodoQuery mixed = (TodoQuery::category("Work") || TodoQuery::completed())
+                         && !TodoQuery::textContains("rent");
+    const QBitArray bits = mixed.compiled().evaluate(store);
+    for (int i = 0; i < store.size(); ++i)
+        QCOMPARE(bits.testBit(i), mixed.matches(store, i));
+
+    model->addTodos(std::move(items));
+
+    QSignalSpy resetSpy(model, &QAbstractItemModel::modelReset);
+    QSignalSpy modeSpy(model, &TodoModel::filterModeChanged);
+    QSignalSpy querySpy(model, &TodoModel::queryChanged);
+
+    const TodoQuery urgentOpen = !TodoQuery::completed() && TodoQuery::priorityBetween(Priority::High, Priority::Urgent);
+    model->setQuery(urgentOpen);
+    QCOMPARE(model->getFilterMode(), TodoModel::FilterMode::Custom);
+    QCOMPARE(model->rowCount(), 1);
+    QCOMPARE(model->getTodoItem(0).getTitle(), QString("Write report"));
+
+    model->setQuery(TodoQuery::category("Work") || TodoQuery::category("Finance"));
+    QCOMPARE(model->rowCount(), 4);
+    model->setQuery(!TodoQuery::category("Work")
+                    && TodoQuery::createdBetween(start.addDays(1), start.addDays(3)));
+    QCOMPARE(model->rowCount(), 2);
+    QCOMPARE(model->getTodoItem(1).getTitle(), QString("Water plants"));
+    model->setQuery(TodoQuery::textContains("REPORT") && !TodoQuery::completed());
+    QCOMPARE(model->rowCount(), 2);
+    model->setQuery(TodoQuery::modifiedBetween(start.addDays(5), QDateTime()));
+    QCOMPARE(model->rowCount(), 1);
+    QCOMPARE(model->getTodoItem(0).getTitle(), QString("Water plants"));
+    QCOMPARE(modeSpy.count(), 1);
+    QCOMPARE(querySpy.count(), 5);
+
+    // Edits and new items are tested against the query as they happen
+    model->setQuery(urgentOpen);
+    QVERIFY(model->updateTodoPriorityById(reviewId, Priority::High));
+    QCOMPARE(model->rowCount(), 2);
+    QVERIFY(model->toggleTodoById(writeId));
+    QCOMPARE(model->rowCount(), 1);
+    QVERIFY(model->addTodo("Call plumber", Priority::Urgent));
+    QCOMPARE(model->rowCount(), 2);
+
+    // Filter modes are preset queries
+    model->setFilterMode(TodoModel::FilterMode::Completed);
+    QVERIFY(model->query() == TodoQuery::completed(true));
+    QCOMPARE(model->rowCount(), 3);
+    model->setFilterMode(TodoModel::FilterMode::All);
+    QVERIFY(model->query().matchesEverything());
+    QCOMPARE(model->rowCount(), 6);
+    QCOMPARE(resetSpy.count(), 0);
+
+    // Compilation flattens and simplifies without changing the result
+    const TodoQuery ranges = TodoQuery::priorityBetween(Priority::Normal, Priority::Urgent)
+                          && TodoQuery::priorityBetween(Priority::Low, Priority::High);
+    QVERIFY(ranges.compiled() == TodoQuery::priorityBetween(Priority::Normal, Priority::High));
+    QVERIFY((!!TodoQuery::completed()).compiled() == TodoQuery::completed());
+    QVERIFY((TodoQuery() || TodoQuery::completed()).compiled().matchesEverything());
+    QVERIFY((TodoQuery() && TodoQuery::completed()).compiled() == TodoQuery::completed());
+}
+
+/**
+ * @brief Test per-category counts and switching between categories
+ */
+void TestTodoModel::testCategoryIndex()
+{
+    QVector<TodoItem> items;
+    const QStringList categories = {"Work", "Home", "Work", "", "Home", "Work"};
+    for (int i = 0; i < categories.size(); ++i) {
+        TodoItem item(QString("Todo %1").arg(i), i % 2 == 1);
+        item.setCategory(categories[i]);
+        items.append(item);
+    }
+    model->addTodos(std::move(items));
+
+    QCOMPARE(model->categoryCounts("Work").active, 2);
+    QCOMPARE(model->categoryCounts("Work").completed, 1);
+    QCOMPARE(model->categoryCounts("Home").total(), 2);
+    QCOMPARE(model->categoryCounts("").total(), 1);
+    QCOMPARE(model->categoryCounts("Garden").total(), 0);
+
+    // Counts follow completion, category edits, additions and removals
+    QVERIFY(model->toggleTodo(0));
+    QCOMPARE(model->categoryCounts("Work").completed, 2);
+    QVERIFY(model->setData(model->index(2), QString("Home"), TodoModel::CategoryRole));
+    QCOMPARE(model->categoryCounts("Work").total(), 2);
+    QCOMPARE(model->categoryCounts("Home").active, 2);
+    QCOMPARE(model->categoryCounts("Home").total(), 3);
+    TodoItem garden("Plant roses");
+    garden.setCategory("Garden");
+    QVERIFY(model->addTodo(garden));
+    QCOMPARE(model->categoryCounts("Garden").active, 1);
+    QVERIFY(model->removeTodo(model->index(5)));
+    QCOMPARE(model->categoryCounts("Work").total(), 1);
+
+    const QVector<StorageManager::CategorySummary> summaries = model->categorySummaries();
+    QCOMPARE(summaries.size(), 4);
+    QCOMPARE(summaries[2].category, QString("Home"));
+    QCOMPARE(summaries[2].count, 3);
+    QCOMPARE(summaries[2].completed, 1);
+
+    // Switching categories touches only the rows of the two
+    QSignalSpy resetSpy(model, &QAbstractItemModel::modelReset);
+    model->setCategoryFilter("Home");
+    QCOMPARE(model->rowCount(), 3);
+    model->setCategoryFilter("Work");
+    QCOMPARE(model->rowCount(), 1);
+    QCOMPARE(model->getTodoItem(0).getTitle(), QString("Todo 0"));
+    model->setFilterMode(TodoModel::FilterMode::Active);
+    model->setCategoryFilter("Home");
+    QCOMPARE(model->rowCount(), 2);
+    QCOMPARE(model->getTodoItem(0).getTitle(), QString("Todo 2"));
+    model->setCategoryFilter(QString());
+    QCOMPARE(model->rowCount(), 3);
+    QCOMPARE(resetSpy.count(), 0);
+}
+
+/**
+ * @brief Test undo and redo of edits, batches and the memory limit
+ */
+void TestTodoModel::testUndoRedo()
+{
+    QVERIFY(!model->canUndo());
+    QVERIFY(model->addTodo("Buy milk"));
+    QVERIFY(model->addTodo("Walk dog", TodoItem::Priority::High));
+    QVERIFY(model->addTodo("Read book"));
+    const QUuid milk = model->getTodoItem(0).getUuid();
+    const QUuid dog = model->getTodoItem(1).getUuid();
+    QVERIFY(model->updateTodoTitleById(milk, "Buy oat milk"));
+    QVERIFY(model->toggleTodo(1));
+
+    // Field edits go back to their old values
+    QVERIFY(model->undo());
+    QCOMPARE(model->completedCount(), 0);
+    QVERIFY(model->undo());
+    QCOMPARE(model->getTodoItemById(milk).getTitle(), QString("Buy milk"));
+    QVERIFY(model->redo());
+    QCOMPARE(model->getTodoItemById(milk).getTitle(), QString("Buy oat milk"));
+
+    // A removed item comes back in its old row through one row insertion
+    QSignalSpy insertSpy(model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy resetSpy(model, &QAbstractItemModel::modelReset);
+    QVERIFY(model->removeTodo(1));
+    QCOMPARE(model->rowCount(), 2);
+    QVERIFY(model->undo());
+    QCOMPARE(model->rowCount(), 3);
+    QCOMPARE(model->getTodoItem(1).getUuid(), dog);
+    QCOMPARE(model->getTodoItem(1).getPriority(), TodoItem::Priority::High);
+    QCOMPARE(insertSpy.count(), 1);
+    QCOMPARE(resetSpy.count(), 0);
+
+    // A new edit drops what could be redone
+    QVERIFY(model->canRedo());
+    QVERIFY(model->toggleTodo(0));
+    QVERIFY(!model->canRedo());
+
+    // Batches are one step
+    QVERIFY(model->toggleTodo(2));
+    QCOMPARE(model->clearCompleted(), 2);
+    QCOMPARE(model->undoText(), QString("Clear Completed"));
+    QVERIFY(model->undo());
+    QCOMPARE(model->totalCount(), 3);
+    QCOMPARE(model->completedCount(), 2);
+    QVERIFY(model->redo());
+    QCOMPARE(model->totalCount(), 1);
+    QVERIFY(model->undo());
+    QCOMPARE(model->totalCount(), 3);
+
+    model->beginUndoGroup("Import");
+    model->addTodos({TodoItem("A"), TodoItem("B")});
+    model->addTodos({TodoItem("C")});
+    model->endUndoGroup();
+    QCOMPARE(model->totalCount(), 6);
+    QCOMPARE(model->undoText(), QString("Import"));
+    QVERIFY(model->undo());
+    QCOMPARE(model->totalCount(), 3);
+
+    model->clearAll();
+    QCOMPARE(model->totalCount(), 0);
+    QVERIFY(model->undo());
+    QCOMPARE(model->totalCount(), 3);
+    QVERIFY(model->containsTodo(dog));
+
+    // Over the limit only the newest step of each stack is kept
+    QVERIFY(model->undoMemoryUsage() > 0);
+    model->setUndoMemoryLimit(0);
+    QVERIFY(model->canRedo());
+    QVERIFY(model->undo());
+    QCOMPARE(model->completedCount(), 1);
+    QVERIFY(!model->canUndo());
+}
+
+/**
+ * @brief Test that statistics follow edits and are saved with the list
+ */
+void TestTodoModel::testStatistics()
+{
+    const QDate today = QDate::currentDate();
+    const TodoStatistics& statistics = model->statistics();
+    QVERIFY(model->addTodo("Buy milk", TodoItem::Priority::High));
+    QVERIFY(model->addTodo("Walk dog"));
+    QVERIFY(model->addTodo("Read book", TodoItem::Priority::High));
+    QCOMPARE(statistics.window(today, 1).created, 3);
+    QCOMPARE(statistics.priorityCounts(TodoItem::Priority::High).active, 2);
+
+    QVERIFY(model->toggleTodo(0));
+    QCOMPARE(statistics.window(today, 1).completed, 1);
+    QCOMPARE(statistics.priorityCounts(TodoItem::Priority::High).completed, 1);
+    QCOMPARE(statistics.completionRate(today, 7), 1.0 / 7);
+
+    // Reopening takes the completion back
+    QVERIFY(model->toggleTodo(0));
+    QCOMPARE(statistics.window(today, 1).completed, 0);
+    QVERIFY(model->toggleTodo(0));
+
+    // Priority edits and removals move the counts; the history stays
+    QVERIFY(model->setData(model->index(1), int(TodoItem::Priority::Urgent), TodoModel::PriorityRole));
+    QCOMPARE(statistics.priorityCounts(TodoItem::Priority::Urgent).active, 1);
+    QCOMPARE(statistics.priorityCounts(TodoItem::Priority::Normal).total(), 0);
+    QVERIFY(model->removeTodo(2));
+    QCOMPARE(statistics.priorityCounts(TodoItem::Priority::High).total(), 1);
+    QCOMPARE(statistics.window(today, 1).created, 3);
+
+    // Undo brings the item back without counting it as created again
+    QVERIFY(model->undo());
+    QCOMPARE(statistics.priorityCounts(TodoItem::Priority::High).total(), 2);
+    QCOMPARE(statistics.window(today, 1).created, 3);
+
+    QVERIFY(model->saveToStorage());
+    TodoModel reloaded;
+    QVERIFY(reloaded.loadFromStorage());
+    QCOMPARE(reloaded.statistics().window(today, 1).created, 3);
+    QCOMPARE(reloaded.statistics().window(today, 1).completed, 1);
+    QCOMPARE(reloaded.statistics().priorityCounts(TodoItem::Priority::High).completed, 1);
+    QCOMPARE(reloaded.statistics().firstDay(), today);
+
+    // Older events extend the history at the front
+    TodoStatistics history;
+    history.recordCreated(today.startOfDay().toMSecsSinceEpoch());
+    history.recordCreated(today.addDays(-400).startOfDay().toMSecsSinceEpoch());
+    QCOMPARE(history.firstDay(), today.addDays(-400));
+    QCOMPARE(history.window(today, 401).created, 2);
+    QCOMPARE(history.weeks(today, 1).first().created, 1);
+}
+
+/**
+ * @brief Test that journaled changes survive a reload
+ */
+void TestTodoModel::testJournalPersistence()
+{
+    model->addTodo("Todo 1");
+    model->addTodo("Todo 2", TodoItem::Priority::High);
+    model->addTodo("Todo 3");
+    model->toggleTodo(1);
+    model->removeTodo(0);
+    QVERIFY(model->saveToStorage());
+
+    TodoModel reloaded;
+    QVERIFY(reloaded.loadFromStorage());
+    QCOMPARE(reloaded.totalCount(), 2);
+    QCOMPARE(reloaded.getTodoItem(0).getTitle(), QString("Todo 2"));
+    QCOMPARE(reloaded.getTodoItem(0).isCompleted(), true);
+    QCOMPARE(reloaded.getTodoItem(0).getPriority(), TodoItem::Priority::High);
+    QCOMPARE(reloaded.getTodoItem(1).getTitle(), QString("Todo 3"));
+
+    StorageManager storage(StorageManager::StorageBackend::Journal);
+    QCOMPARE(storage.loadTodos().size(), 2);
+}
+
+/**
+ * @brief Test that the SQLite backend applies per-row changes
+ */
+void TestTodoModel::testSQLiteIncrementalSave()
+{
+    StorageManager storage(StorageManager::StorageBackend::SQLite);
+    QVERIFY(storage.clearStorage());
+
+    TodoItem first("First");
+    TodoItem second("Second", false, TodoItem::Priority::Urgent);
+    QVector<TodoItem> todos = {first, second};
+    QVERIFY(storage.saveTodos(todos));
+    QCOMPARE(storage.getStoredCount(), 2);
+
+    TodoItem third("Third");
+    todos[1].setCompleted(true);
+    todos.removeFirst();
+    todos.append(third);
+    QVERIFY(storage.saveChanges({TodoChange::remove(first.getUuid()),
+                                 TodoChange::upsert(todos[0]),
+                                 TodoChange::upsert(third)}, TodoStore(todos)));
+    QCOMPARE(storage.getStoredCount(), 2);
+
+    QVector<TodoItem> loaded = storage.loadTodos();
+    QCOMPARE(loaded.size(), 2);
+    QCOMPARE(loaded[0].getUuid(), second.getUuid());
+    QCOMPARE(loaded[0].isCompleted(), true);
+    QCOMPARE(loaded[0].getPriority(), TodoItem::Priority::Urgent);
+    QCOMPARE(loaded[1].getTitle(), QString("Third"));
+
+    // Each manager removes its connections when it goes away
+    const int connections = QSqlDatabase::connectionNames().size();
+    {
+        StorageManager other(StorageManager::StorageBackend::SQLite);
+        QCOMPARE(other.getStoredCount(), 2);
+        QCOMPARE(QSqlDatabase::connectionNames().size(), connections + 1);
+    }
+    QCOMPARE(QSqlDatabase::connectionNames().size(), connections);
+}
+
+/**
+ * @brief Test that QSettingsJson keeps its items in a separate data file
+ */
+void TestTodoModel::testQSettingsDataFile()
+{
+    const auto backend = StorageManager::StorageBackend::QSettingsJson;
+    StorageManager storage(backend);
+    QVERIFY(storage.clearStorage());
+
+    QVector<TodoItem> todos = {TodoItem("First"), TodoItem("Second", true)};
+    storage.setCompression(StorageManager::Compression::Zlib);
+    QVERIFY(storage.saveTodos(todos));
+    QCOMPARE(storage.getStoredCount(), 2);
+    const QString compressedPath = storage.getStoragePath();
+    QVERIFY(QFile::exists(compressedPath));
+
+    // Loading detects the compression on its own
+    QVector<TodoItem> loaded = StorageManager(backend).loadTodos();
+    QCOMPARE(loaded.size(), 2);
+    QCOMPARE(loaded[1].getUuid(), todos[1].getUuid());
+    QCOMPARE(loaded[1].isCompleted(), true);
+
+    storage.setCompression(StorageManager::Compression::None);
+    todos.append(TodoItem("Third"));
+    QVERIFY(storage.saveTodos(todos));
+    QVERIFY(!QFile::exists(compressedPath));
+    QCOMPARE(StorageManager(backend).loadTodos().last().getTitle(), QString("Third"));
+
+    // Data embedded in the INI file by older versions is still read
+    {
+        QSettings settings(QSettings::IniFormat, QSettings::UserScope, "TodoListDemo", "QtTodoList");
+        settings.remove("todos");
+        settings.setValue("todos/data", "[{\"title\":\"Legacy\"}]");
+    }
+    loaded = StorageManager(backend).loadTodos();
+    QCOMPARE(loaded.size(), 1);
+    QCOMPARE(loaded.first().getTitle(), QString("Legacy"));
+
+    QVERIFY(StorageManager(backend).clearStorage());
+}
+
+/**
+ * @brief Test that a burst of edits is written once, in the background
+ */
+void TestTodoModel::testCoalescedSave()
+{
+    QSignalSpy savedSpy(model, &TodoModel::saveFinished);
+    model->setSaveDelay(50);
+
+    model->addTodo("Todo 1");
+    model->addTodo("Todo 2");
+    model->addTodo("Todo 3");
+    model->toggleTodo(0);
+    model->clearCompleted();
+    QVERIFY(model->hasUnsavedChanges());
+
+    QTRY_COMPARE(savedSpy.count(), 1);
+    QCOMPARE(savedSpy.first().first().toBool(), true);
+    QVERIFY(!model->hasUnsavedChanges());
+
+    QTest::qWait(100);
+    QCOMPARE(savedSpy.count(), 1);
+
+    StorageManager storage(StorageManager::StorageBackend::Journal);
+    QCOMPARE(storage.loadTodos().size(), 2);
+}
+
+/**
+ * @brief Test that an asynchronous load reveals rows in chunks
+ */
+void TestTodoModel::testAsyncLoad()
+{
+    const int count = 2 * TodoModel::kLoadChunkSize + 1;
+    QVector<TodoItem> todos;
+    for (int i = 0; i < count; ++i)
+        todos.append(TodoItem(QString("Todo %1").arg(i), i % 3 == 0));
+    QCOMPARE(model->addTodos(std::move(todos)), count);
+    QVERIFY(model->saveToStorage());
+
+    TodoModel loaded;
+    QSignalSpy insertedSpy(&loaded, &QAbstractItemModel::rowsInserted);
+    QSignalSpy progressSpy(&loaded, &TodoModel::loadProgress);
+    QSignalSpy finishedSpy(&loaded, &TodoModel::loadFinished);
+    QVERIFY(loaded.loadFromStorageAsync());
+    QVERIFY(loaded.isLoading());
+    QVERIFY(!loaded.loadFromStorageAsync());
+
+    // The model is usable before the list arrives; the new item ends up
+    // behind the saved ones
+    QVERIFY(loaded.addTodo("Added while loading"));
+
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QCOMPARE(finishedSpy.first().first().toInt(), count + 1);
+    QVERIFY(!loaded.isLoading());
+    QCOMPARE(progressSpy.count(), 3);
+    QCOMPARE(insertedSpy.count(), 1 + 3);   // the added item, then one range per chunk
+    QCOMPARE(loaded.rowCount(), count + 1);
+    QCOMPARE(loaded.completedCount(), model->completedCount());
+    QCOMPARE(loaded.getTodoItem(0).getTitle(), QString("Todo 0"));
+    QCOMPARE(loaded.getTodoItem(count).getTitle(), QString("Added while loading"));
+    QVERIFY(loaded.saveToStorage());
+
+    // Saving before the list arrives must not drop the saved items
+    TodoModel flushed;
+    QVERIFY(flushed.loadFromStorageAsync());
+    QVERIFY(flushed.addTodo("Added before the list arrived"));
+    QVERIFY(flushed.saveToStorage());
+    QCOMPARE(flushed.totalCount(), count + 2);
+
+    StorageManager storage(StorageManager::StorageBackend::Journal);
+    QCOMPARE(storage.loadTodos().size(), count + 2);
+}
+
+/**
+ * @brief Test that the sharded backend reads and writes single categories
+ */
+void TestTodoModel::testShardedStorage()
+{
+    const auto backend = StorageManager::StorageBackend::Sharded;
+    QVERIFY(StorageManager(backend).clearStorage());
+
+    QVector<TodoItem> todos;
+    for (int i = 0; i < 4; ++i) {
+        TodoItem item(QString("Todo %1").arg(i), i == 0);
+        item.setCategory(i % 2 == 0 ? QString("Work") : QString("Home"));
+        todos.append(item);
+    }
+    QVERIFY(StorageManager(backend).saveTodos(todos));
+
+    StorageManager storage(backend);
+    QCOMPARE(storage.getStoredCount(), 4);
+    const QVector<StorageManager::CategorySummary> summaries = storage.categorySummaries();
+    QCOMPARE(summaries.size(), 2);
+    for (const StorageManager::CategorySummary& summary : summaries) {
+        QCOMPARE(summary.count, 2);
+        QCOMPARE(summary.completed, summary.category == "Work" ? 1 : 0);
+    }
+
+    // A partial load reads one shard; writing through it leaves the
+    // others alone
+    TodoStore work = storage.loadStore({"Work"});
+    QCOMPARE(work.liveCount(), 2);
+    QVector<TodoItem> workItems = work.toItems();
+    TodoItem added("Todo 4");
+    added.setCategory("Work");
+    workItems[1].setCompleted(true);
+    workItems.append(added);
+    QVERIFY(storage.saveChanges({TodoChange::upsert(workItems[1]), TodoChange::upsert(added)}, TodoStore(workItems)));
+    QVERIFY(storage.saveTodos(workItems));
+    QCOMPARE(storage.getStoredCount(), 5);
+
+    // Moving an item to another category moves it between shards
+    workItems[0].setCategory("Home");
+    QVERIFY(storage.saveChanges({TodoChange::upsert(workItems[0])}, TodoStore(workItems)));
+    TodoStore home = StorageManager(backend).loadStore({"Home"});
+    QCOMPARE(home.liveCount(), 3);
+    QCOMPARE(StorageManager(backend).loadStore().liveCount(), 5);
+
+    // The model reads the shown category first and the rest on demand
+    {
+        TodoModel partial(backend);
+        QSignalSpy categorySpy(&partial, &TodoModel::categoryFilterChanged);
+        partial.setCategoryFilter("Work");
+        QVERIFY(partial.loadFromStorage());
+        QCOMPARE(partial.totalCount(), 2);
+        QCOMPARE(partial.rowCount(), 2);
+        QCOMPARE(partial.categorySummaries().size(), 2);
+
+        // Categories not loaded are counted by a copy of the storage
+        // index, which is read again after a save
+        auto homeCount = [&partial]() {
+            for (const StorageManager::CategorySummary& summary : partial.categorySummaries()) {
+                if (summary.category == "Home")
+                    return summary.count;
+            }
+            return -1;
+        };
+        QCOMPARE(homeCount(), 3);
+        TodoItem extra("Todo 5");
+        extra.setCategory("Home");
+        QVERIFY(partial.addTodo(extra));
+        QCOMPARE(homeCount(), 3);
+        QVERIFY(partial.saveToStorage());
+        QTRY_COMPARE(homeCount(), 4);
+
+        partial.setCategoryFilter("Home");
+        QCOMPARE(partial.totalCount(), 6);
+        QCOMPARE(partial.rowCount(), 4);
+
+        partial.setCategoryFilter(QString());
+        QCOMPARE(partial.rowCount(), 6);
+        QCOMPARE(categorySpy.count(), 3);
+        QCOMPARE(partial.completedCount(), 2);
+    }
+
+    QVERIFY(StorageManager(backend).clearStorage());
+}
+
+/**
+ * @brief Test that imports are decoded in batches on a worker thread
+ */
+void TestTodoModel::testStreamingImport()
+{
+    const int count = 2 * TodoImporter::kBatchSize + 1;
+    QVector<TodoItem> todos;
+    for (int i = 0; i < count; ++i)
+        todos.append(TodoItem(QString("Todo \"%1\" {]").arg(i), i % 2 == 0));
+
+    QTemporaryDir dir;
+    const QString path = dir.filePath("export.json");
+    QVERIFY(StorageManager::exportToJson(path, todos));
+
+    const QVector<TodoItem> imported = StorageManager::importFromJson(path);
+    QCOMPARE(imported.size(), count);
+    QCOMPARE(imported.last().getTitle(), todos.last().getTitle());
+    QCOMPARE(imported.first().getUuid(), todos.first().getUuid());
+
+    TodoImporter importer;
+    QSignalSpy batchSpy(&importer, &TodoImporter::batchReady);
+    QSignalSpy finishedSpy(&importer, &TodoImporter::finished);
+    QVERIFY(importer.start(path));
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QCOMPARE(finishedSpy.first().at(0).value<TodoImporter::Status>(), TodoImporter::Status::Finished);
+    QCOMPARE(finishedSpy.first().at(1).toInt(), count);
+    QCOMPARE(batchSpy.count(), 3);
+
+    // A truncated file fails after delivering the complete batches
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() / 2));
+    file.close();
+
+    QVERIFY(StorageManager::importFromJson(path).isEmpty());
+    QVERIFY(importer.start(path));
+    QTRY_COMPARE(finishedSpy.count(), 2);
+    QCOMPARE(finishedSpy.last().at(0).value<TodoImporter::Status>(), TodoImporter::Status::Failed);
+    QVERIFY(!importer.errorString().isEmpty());
+}
+
+/**
+ * @brief Test that chunked exports keep item order in every format
+ */
+void TestTodoModel::testParallelExport()
+{
+    const int count = 3 * TodoExporter::kChunkSize + 7;
+    QVector<TodoItem> todos;
+    for (int i = 0; i < count; ++i)
+        todos.append(TodoItem(QString("Todo %1").arg(i), i % 3 == 0));
+    todos[1].setTitle("Comma, \"quoted\"");
+
+    TodoStore store(todos);
+    store.remove(2);
+
+    QTemporaryDir dir;
+    const QString jsonPath = dir.filePath("export.json");
+    QVERIFY(TodoExporter::exportStore(jsonPath, store, TodoExporter::Format::Json));
+    const QVector<TodoItem> imported = StorageManager::importFromJson(jsonPath);
+    QCOMPARE(imported.size(), count - 1);
+    QCOMPARE(imported[1].getTitle(), todos[1].getTitle());
+    QCOMPARE(imported[2].getUuid(), todos[3].getUuid());
+    QCOMPARE(imported.last().getUuid(), todos.last().getUuid());
+
+    const QString csvPath = dir.filePath("export.csv");
+    QCOMPARE(TodoExporter::formatForPath(csvPath), TodoExporter::Format::Csv);
+    QVERIFY(TodoExporter::exportStore(csvPath, store, TodoExporter::Format::Csv));
+    QFile csv(csvPath);
+    QVERIFY(csv.open(QIODevice::ReadOnly));
+    QVERIFY(csv.readLine().startsWith("id,title,completed"));
+    csv.readLine();
+    QVERIFY(csv.readLine().contains(",\"Comma, \"\"quoted\"\"\","));
+
+    TodoExporter exporter;
+    QSignalSpy finishedSpy(&exporter, &TodoExporter::finished);
+    const QString ndjsonPath = dir.filePath("export.ndjson");
+    QVERIFY(exporter.start(ndjsonPath, store, TodoExporter::formatForPath(ndjsonPath)));
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QCOMPARE(finishedSpy.first().at(0).value<TodoExporter::Status>(), TodoExporter::Status::Finished);
+    QCOMPARE(finishedSpy.first().at(1).toInt(), count - 1);
+
+    QFile ndjson(ndjsonPath);
+    QVERIFY(ndjson.open(QIODevice::ReadOnly));
+    QCOMPARE(ndjson.readAll().count('\n'), count - 1);
+}
+
+/**
+ * @brief Test that two models sharing a journal merge each other's saves
+ */
+void TestTodoModel::testLiveSync()
+{
+    model->addTodo("Shared 1");
+    model->addTodo("Shared 2");
+    QVERIFY(model->saveToStorage());
+
+    TodoModel other;
+    QVERIFY(other.loadFromStorage());
+    QCOMPARE(other.totalCount(), 2);
+
+    // An item added elsewhere arrives as one row insertion
+    QSignalSpy resetSpy(&other, &QAbstractItemModel::modelReset);
+    QSignalSpy insertSpy(&other, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removeSpy(&other, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy mergedSpy(&other, &TodoModel::externalChangesMerged);
+    model->addTodo("Shared 3");
+    QVERIFY(model->saveToStorage());
+    QVERIFY(other.syncWithStorage());
+    QCOMPARE(other.totalCount(), 3);
+    QCOMPARE(insertSpy.count(), 1);
+    QCOMPARE(mergedSpy.count(), 1);
+    QCOMPARE(mergedSpy.first().at(0).toInt(), 1);
+
+    // Nothing new, nothing merged
+    QVERIFY(other.syncWithStorage());
+    QCOMPARE(mergedSpy.count(), 1);
+
+    // Edits of different items on both sides are both kept
+    const QUuid first = model->getTodoItem(0).getUuid();
+    const QUuid second = model->getTodoItem(1).getUuid();
+    QVERIFY(model->toggleTodo(0));
+    QVERIFY(other.updateTodoTitleById(second, "Edited elsewhere"));
+    QVERIFY(model->saveToStorage());
+    QVERIFY(other.syncWithStorage());
+    QVERIFY(model->syncWithStorage());
+    for (const TodoModel *side : {static_cast<const TodoModel *>(model), static_cast<const TodoModel *>(&other)}) {
+        QVERIFY(side->getTodoItemById(first).isCompleted());
+        QCOMPARE(side->getTodoItemById(second).getTitle(), QString("Edited elsewhere"));
+        QCOMPARE(side->completedCount(), 1);
+    }
+
+    // A removal elsewhere removes one row
+    QVERIFY(model->removeTodoById(first));
+    QVERIFY(model->saveToStorage());
+    QVERIFY(other.syncWithStorage());
+    QCOMPARE(other.totalCount(), 2);
+    QCOMPARE(removeSpy.count(), 1);
+    QCOMPARE(other.completedCount(), 0);
+
+    // The later edit wins, whichever process saves last
+    StorageManager late(StorageManager::StorageBackend::Journal);
+    StorageManager early(StorageManager::StorageBackend::Journal);
+    const QVector<TodoItem> stored = late.loadTodos();
+    QVERIFY(!early.loadTodos().isEmpty());
+    const TodoItem base = stored.first();
+    const TodoItem newer(base.getUuid(), "Newer", false, base.getPriority(), base.getCategory(),
+                         base.createdAtMs(), base.modifiedAtMs() + 2000);
+    const TodoItem older(base.getUuid(), "Older", false, base.getPriority(), base.getCategory(),
+                         base.createdAtMs(), base.modifiedAtMs() + 1000);
+    QVERIFY(late.saveChanges({TodoChange::upsert(newer)}, TodoStore()));
+    QVERIFY(early.saveChanges({TodoChange::upsert(older)}, TodoStore()));
+    const TodoChangeList fromLate = early.readExternalChanges();
+    QCOMPARE(fromLate.size(), 1);
+    QCOMPARE(fromLate.first().item.getTitle(), QString("Newer"));
+    QVERIFY(other.syncWithStorage());
+    QCOMPARE(other.getTodoItemById(base.getUuid()).getTitle(), QString("Newer"));
+
+    // A compaction elsewhere still only merges the difference
+    QVector<TodoItem> batch;
+    for (int i = 0; i < 1100; ++i)
+        batch.append(TodoItem(QString("Batch %1").arg(i)));
+    QCOMPARE(model->addTodos(std::move(batch)), 1100);
+    QVERIFY(model->saveToStorage());
+    insertSpy.clear();
+    QVERIFY(other.syncWithStorage());
+    QCOMPARE(other.totalCount(), 1102);
+    QCOMPARE(insertSpy.count(), 1);
+    QCOMPARE(resetSpy.count(), 0);
+
+    QVERIFY(model->syncWithStorage());
+    TodoModel reloaded;
+    QVERIFY(reloaded.loadFromStorage());
+    QCOMPARE(reloaded.totalCount(), other.totalCount());
+    QCOMPARE(model->totalCount(), other.totalCount());
+    QCOMPARE(reloaded.getTodoItemById(base.getUuid()).getTitle(), QString("Newer"));
+}
+
 // Run tests
 QTEST_MAIN(TestTodoModel)
 #include "test_todomodel.moc"
@@ -2,7 +2,7 @@
 # Qt Todo List - qmake Project File
 #-------------------------------------------------
 
-QT       += core gui widgets
+QT       += core gui widgets sql
 
 greaterThan(QT_MAJOR_VERSION, 5): QT += widgets
 
@@ -20,15 +20,50 @@ DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
 SOURCES += \
     main.cpp \
     src/TodoItem.cpp \
+    src/Timestamp.cpp \
+    src/FenwickTree.cpp \
+    src/TrigramIndex.cpp \
+    src/TodoSorter.cpp \
+    src/TodoQuery.cpp \
+    src/CategoryIndex.cpp \
+    src/UndoHistory.cpp \
+    src/TodoStatistics.cpp \
+    src/TodoStore.cpp \
+    src/TodoSnapshot.cpp \
+    src/TodoJsonReader.cpp \
+    src/TodoImporter.cpp \
+    src/TodoExporter.cpp \
     src/TodoModel.cpp \
     src/StorageManager.cpp \
+    src/SaveScheduler.cpp \
+    src/StartupLog.cpp \
+    src/TodoItemDelegate.cpp \
+    src/StatisticsWidget.cpp \
     src/MainWindow.cpp
 
 # Header Files
 HEADERS += \
     src/TodoItem.h \
+    src/Timestamp.h \
+    src/TodoChange.h \
+    src/FenwickTree.h \
+    src/TrigramIndex.h \
+    src/TodoSorter.h \
+    src/TodoQuery.h \
+    src/CategoryIndex.h \
+    src/UndoHistory.h \
+    src/TodoStatistics.h \
+    src/TodoStore.h \
+    src/TodoSnapshot.h \
+    src/TodoJsonReader.h \
+    src/TodoImporter.h \
+    src/TodoExporter.h \
     src/TodoModel.h \
     src/StorageManager.h \
+    src/SaveScheduler.h \
+    src/StartupLog.h \
+    src/TodoItemDelegate.h \
+    src/StatisticsWidget.h \
     src/MainWindow.h
 
 # Resource Files
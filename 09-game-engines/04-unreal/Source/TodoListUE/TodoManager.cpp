@@ -9,6 +9,7 @@ const FString UTodoManager::DefaultSaveSlot = TEXT("TodoSaveSlot");
 UTodoManager::UTodoManager()
 	: CurrentFilter(ETodoFilter::All)
 	, bAutoSaveEnabled(true)
+	, CompletedCount(0)
 {
 }
 
@@ -45,7 +46,12 @@ bool UTodoManager::RemoveTodo(const FGuid& TodoId)
 	int32 Index = FindTodoIndexById(TodoId);
 	if (Index != INDEX_NONE)
 	{
+		if (Todos[Index].bCompleted)
+		{
+			CompletedCount--;
+		}
 		Todos.RemoveAt(Index);
+		VerifyCounts();
 		OnTodoRemoved.Broadcast(TodoId);
 		BroadcastChanges();
 		TriggerAutoSave();
@@ -75,7 +81,9 @@ bool UTodoManager::UpdateTodo(const FGuid& TodoId, const FTodoItem& UpdatedTodo)
 	int32 Index = FindTodoIndexById(TodoId);
 	if (Index != INDEX_NONE)
 	{
+		CompletedCount += static_cast<int32>(UpdatedTodo.bCompleted) - static_cast<int32>(Todos[Index].bCompleted);
 		Todos[Index] = UpdatedTodo;
+		VerifyCounts();
 		OnTodoUpdated.Broadcast(UpdatedTodo);
 		BroadcastChanges();
 		TriggerAutoSave();
@@ -94,6 +102,8 @@ bool UTodoManager::ToggleTodoCompletion(const FGuid& TodoId)
 	if (Index != INDEX_NONE)
 	{
 		Todos[Index].ToggleCompleted();
+		CompletedCount += Todos[Index].bCompleted ? 1 : -1;
+		VerifyCounts();
 		OnTodoUpdated.Broadcast(Todos[Index]);
 		BroadcastChanges();
 		TriggerAutoSave();
@@ -169,6 +179,9 @@ int32 UTodoManager::ClearCompletedTodos()
 
 	if (RemovedCount > 0)
 	{
+		// Every completed todo is gone
+		CompletedCount = 0;
+		VerifyCounts();
 		BroadcastChanges();
 		TriggerAutoSave();
 		UE_LOG(LogTemp, Log, TEXT("Cleared %d completed todos"), RemovedCount);
@@ -181,6 +194,7 @@ void UTodoManager::ClearAllTodos()
 {
 	int32 Count = Todos.Num();
 	Todos.Empty();
+	CompletedCount = 0;
 	BroadcastChanges();
 	TriggerAutoSave();
 
@@ -229,28 +243,12 @@ bool UTodoManager::GetTodoById(const FGuid& TodoId, FTodoItem& OutTodo) const
 
 int32 UTodoManager::GetActiveTodoCount() const
 {
-	int32 Count = 0;
-	for (const FTodoItem& Todo : Todos)
-	{
-		if (!Todo.bCompleted)
-		{
-			Count++;
-		}
-	}
-	return Count;
+	return Todos.Num() - CompletedCount;
 }
 
 int32 UTodoManager::GetCompletedTodoCount() const
 {
-	int32 Count = 0;
-	for (const FTodoItem& Todo : Todos)
-	{
-		if (Todo.bCompleted)
-		{
-			Count++;
-		}
-	}
-	return Count;
+	return CompletedCount;
 }
 
 FTodoStatistics UTodoManager::GetStatistics() const
@@ -353,6 +351,7 @@ bool UTodoManager::LoadTodos(const FString& SlotName)
 	{
 		Todos = LoadedGame->SavedTodos;
 		CurrentFilter = LoadedGame->SavedFilter;
+		RecountCompleted();
 
 		BroadcastChanges();
 
@@ -411,3 +410,30 @@ void UTodoManager::BroadcastChanges()
 {
 	OnTodosChanged.Broadcast();
 }
+
+void UTodoManager::RecountCompleted()
+{
+	CompletedCount = 0;
+	for (const FTodoItem& Todo : Todos)
+	{
+		if (Todo.bCompleted)
+		{
+			CompletedCount++;
+		}
+	}
+}
+
+void UTodoManager::VerifyCounts() const
+{
+#if DO_GUARD_SLOW
+	int32 Count = 0;
+	for (const FTodoItem& Todo : Todos)
+	{
+		if (Todo.bCompleted)
+		{
+			Count++;
+		}
+	}
+	checkfSlow(Count == CompletedCount, TEXT("Cached completed count %d does not match %d"), CompletedCount, Count);
+#endif
+}
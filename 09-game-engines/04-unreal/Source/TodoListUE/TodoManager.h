@@ -201,6 +201,7 @@ public:
 	/**
 	 * Get the count of active (incomplete) todos
 	 * @return Number of active todos
+	 * @note O(1), served from a counter maintained on every modification
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Todo|Query")
 	int32 GetActiveTodoCount() const;
@@ -208,6 +209,7 @@ public:
 	/**
 	 * Get the count of completed todos
 	 * @return Number of completed todos
+	 * @note O(1), served from a counter maintained on every modification
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Todo|Query")
 	int32 GetCompletedTodoCount() const;
@@ -318,6 +320,9 @@ private:
 	UPROPERTY()
 	bool bAutoSaveEnabled;
 
+	/** Number of completed todos, kept in sync with Todos on every modification */
+	int32 CompletedCount;
+
 	/** Default save slot name */
 	static const FString DefaultSaveSlot;
 
@@ -329,4 +334,10 @@ private:
 
 	/** Helper function to broadcast all change events */
 	void BroadcastChanges();
+
+	/** Helper function to recount completed todos after Todos is replaced */
+	void RecountCompleted();
+
+	/** Helper function to check the cached counter against a full scan (debug builds only) */
+	void VerifyCounts() const;
 };
@@ -6,6 +6,7 @@
 TodoManager::TodoManager()
     : m_currentFilter(TodoFilter::ALL)
     , m_nextId(1)
+    , m_completedCount(0)
     , m_onTodosChanged(nullptr)
 {
     loadTodos();
@@ -66,7 +67,12 @@ bool TodoManager::deleteTodo(int id)
 
     if (it != m_todos.end())
     {
+        if (it->completed)
+        {
+            m_completedCount--;
+        }
         m_todos.erase(it);
+        verifyCounts();
         saveTodos();
         notifyChanges();
         return true;
@@ -83,6 +89,8 @@ bool TodoManager::toggleTodo(int id)
     if (it != m_todos.end())
     {
         it->completed = !it->completed;
+        m_completedCount += it->completed ? 1 : -1;
+        verifyCounts();
         saveTodos();
         notifyChanges();
         return true;
@@ -140,14 +148,12 @@ int TodoManager::getTotalCount() const
 
 int TodoManager::getActiveCount() const
 {
-    return static_cast<int>(std::count_if(m_todos.begin(), m_todos.end(),
-        [](const TodoItem& item) { return !item.completed; }));
+    return static_cast<int>(m_todos.size()) - m_completedCount;
 }
 
 int TodoManager::getCompletedCount() const
 {
-    return static_cast<int>(std::count_if(m_todos.begin(), m_todos.end(),
-        [](const TodoItem& item) { return item.completed; }));
+    return m_completedCount;
 }
 
 int TodoManager::clearCompleted()
@@ -170,6 +176,9 @@ int TodoManager::clearCompleted()
 
     if (count > 0)
     {
+        // Every completed todo is gone
+        m_completedCount = 0;
+        verifyCounts();
         saveTodos();
         notifyChanges();
     }
@@ -190,6 +199,8 @@ void TodoManager::loadTodos()
             m_nextId = item.id + 1;
         }
     }
+
+    recountCompleted();
 }
 
 SaveResult TodoManager::saveTodos()
@@ -203,6 +214,21 @@ void TodoManager::setOnTodosChangedCallback(std::function<void()> callback)
     m_onTodosChanged = callback;
 }
 
+void TodoManager::recountCompleted()
+{
+    m_completedCount = static_cast<int>(std::count_if(m_todos.begin(), m_todos.end(),
+        [](const TodoItem& item) { return item.completed; }));
+}
+
+void TodoManager::verifyCounts() const
+{
+#if COCOS2D_DEBUG > 0
+    int completed = static_cast<int>(std::count_if(m_todos.begin(), m_todos.end(),
+        [](const TodoItem& item) { return item.completed; }));
+    CCASSERT(completed == m_completedCount, "Cached completed count is out of sync");
+#endif
+}
+
 void TodoManager::notifyChanges()
 {
     if (m_onTodosChanged)
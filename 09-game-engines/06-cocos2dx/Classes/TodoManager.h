@@ -113,12 +113,12 @@ public:
     int getTotalCount() const;
 
     /**
-     * @brief Get count of active todos
+     * @brief Get count of active todos (cached, O(1))
      */
     int getActiveCount() const;
 
     /**
-     * @brief Get count of completed todos
+     * @brief Get count of completed todos (cached, O(1))
      */
     int getCompletedCount() const;
 
@@ -154,9 +154,20 @@ private:
 
     void notifyChanges();
 
+    /**
+     * @brief Recount completed todos from scratch
+     */
+    void recountCompleted();
+
+    /**
+     * @brief Assert that the cached counter matches a full scan (debug builds only)
+     */
+    void verifyCounts() const;
+
     std::vector<TodoItem> m_todos;
     TodoFilter m_currentFilter;
     int m_nextId;
+    int m_completedCount; // Kept in sync on every mutation
     std::function<void()> m_onTodosChanged;
 };
 